@@ -0,0 +1,53 @@
+
+#include "FFusableSocketTableUserData.h"
+#include "Engine/StaticMesh.h"
+#include "UObject/ObjectSaveContext.h"
+
+void UFFusableSocketTableUserData::Bake()
+{
+	const UStaticMesh* StaticMesh = Cast<UStaticMesh>(GetOuter());
+	if (!StaticMesh) { return; }
+
+	FFuseSocketTable::BuildSockets(StaticMesh, SocketSubName, Sockets);
+	const FSphere SocketBounds = FFuseSocketTable::CalcSocketBounds(Sockets);
+	SocketBoundsCentre = SocketBounds.Center;
+	SocketBoundsRadius = SocketBounds.W;
+
+	// Cached tables may be viewing the old sockets
+	FFuseSocketTable::Invalidate(StaticMesh);
+}
+
+bool UFFusableSocketTableUserData::BakeMesh(UStaticMesh* StaticMesh, const FString& SocketSubName)
+{
+	UFFusableSocketTableUserData* SocketTable = StaticMesh->GetAssetUserData<UFFusableSocketTableUserData>();
+	if (!SocketTable)
+	{
+		SocketTable = NewObject<UFFusableSocketTableUserData>(StaticMesh, NAME_None, RF_Transactional);
+	}
+	SocketTable->SocketSubName = SocketSubName;
+	SocketTable->Bake();
+
+	if (SocketTable->Sockets.Num() == 0)
+	{
+		StaticMesh->RemoveUserDataOfClass(UFFusableSocketTableUserData::StaticClass());
+		return false;
+	}
+	StaticMesh->AddAssetUserData(SocketTable);
+	return true;
+}
+
+#if WITH_EDITOR
+
+void UFFusableSocketTableUserData::PostEditChangeOwner()
+{
+	Super::PostEditChangeOwner();
+	Bake();
+}
+
+void UFFusableSocketTableUserData::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	Super::PreSave(ObjectSaveContext);
+	Bake();
+}
+
+#endif
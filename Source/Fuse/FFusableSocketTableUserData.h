@@ -0,0 +1,48 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "FuseSocketTable.h"
+#include "FFusableSocketTableUserData.generated.h"
+
+/*
+ *
+ * Fusable socket table baked onto a static mesh, read directly by FFuseSocketTable at runtime.
+ * Rebaked whenever the mesh is edited or saved (including when it's cooked), and added to meshes in bulk by the
+ * FFuseBakeSocketTables commandlet.
+ *
+ */
+
+UCLASS()
+class FUSE_API UFFusableSocketTableUserData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	// Subname the table was baked with, the runtime falls back to reading sockets if it doesn't match
+	UPROPERTY(EditAnywhere, Category = "Fuse")
+	FString SocketSubName = "Attach";
+
+	UPROPERTY(VisibleAnywhere, Category = "Fuse")
+	TArray<FFuseSocket> Sockets;
+
+	// Sphere around every socket location, lets the socket search skip whole meshes that are out of range
+	UPROPERTY(VisibleAnywhere, Category = "Fuse")
+	FVector SocketBoundsCentre = FVector::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, Category = "Fuse")
+	float SocketBoundsRadius = 0.0f;
+
+	// Rebuild the table from the sockets of the owning mesh
+	void Bake();
+
+	// Bake a table onto a mesh, adding the user data if it doesn't have it yet
+	// Returns false if the mesh has no fusable sockets, any existing table is removed
+	static bool BakeMesh(UStaticMesh* StaticMesh, const FString& SocketSubName);
+
+#if WITH_EDITOR
+	virtual void PostEditChangeOwner() override;
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+#endif
+};
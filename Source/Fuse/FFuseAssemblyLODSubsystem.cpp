@@ -0,0 +1,321 @@
+
+#include "FFuseAssemblyLODSubsystem.h"
+#include "FFuseComponent.h"
+#include "FuseAssembly.h"
+#include "FuseInstancedFusables.h"
+#include "FuseStats.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "PhysicsEngine/PhysicsConstraintComponent.h"
+
+static TAutoConsoleVariable<bool> CVarFuseAssemblyLOD(
+	TEXT("f.fuseassemblylod"), true, TEXT("Freeze fused assemblies that are at rest or far from every player"));
+
+static TAutoConsoleVariable<float> CVarFuseAssemblyLODDistance(
+	TEXT("f.fuseassemblylod.distance"), 5000.0f, TEXT("Assemblies further than this from every player are frozen"));
+
+static TAutoConsoleVariable<float> CVarFuseAssemblyLODIdleTime(
+	TEXT("f.fuseassemblylod.idletime"), 3.0f, TEXT("Seconds an assembly has to be at rest or out of range before it's frozen"));
+
+static TAutoConsoleVariable<float> CVarFuseAssemblyLODWakeDistance(
+	TEXT("f.fuseassemblylod.wakedistance"), 500.0f, TEXT("Frozen assemblies wake when a player comes this close"));
+
+static FAutoConsoleCommandWithWorld FuseAssemblyLODStatsCommand(
+	TEXT("f.fuseassemblylodstats"),
+	TEXT("Log the assemblies frozen by the assembly LOD, and the bodies and joints they remove from the solver"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UFFuseAssemblyLODSubsystem* Subsystem = World ? World->GetSubsystem<UFFuseAssemblyLODSubsystem>() : nullptr)
+		{
+			Subsystem->DumpStats();
+		}
+	}));
+
+namespace FuseAssemblyLOD
+{
+	// Assemblies are found and checked this often, rather than every frame
+	static constexpr float UpdateInterval = 0.5f;
+	// Parts slower than this are at rest
+	static constexpr float RestLinearSpeed = 5.0f;
+	static constexpr float RestAngularSpeed = 0.05f;
+	// Assemblies only freeze this far past the wake distance, so they don't flip between frozen and awake
+	static constexpr float WakeHysteresis = 1.5f;
+}
+
+void UFFuseAssemblyLODSubsystem::Deinitialize()
+{
+	// The world is going away with the parts, so there's nothing to restore
+	FrozenAssemblies.Reset();
+	FrozenPartIndices.Reset();
+	Super::Deinitialize();
+}
+
+void UFFuseAssemblyLODSubsystem::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TimeSinceUpdate += DeltaTime;
+	if (TimeSinceUpdate >= FuseAssemblyLOD::UpdateInterval)
+	{
+		TimeSinceUpdate = 0.0f;
+		if (CVarFuseAssemblyLOD.GetValueOnGameThread()) { UpdateAssemblies(); }
+		else if (FrozenAssemblies.Num() > 0) { WakeAllAssemblies(); }
+	}
+	FUSE_SET_COUNTER(FrozenBodiesRemoved, BodiesRemoved);
+	FUSE_SET_COUNTER(FrozenJointsRemoved, JointsRemoved);
+}
+
+TStatId UFFuseAssemblyLODSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFFuseAssemblyLODSubsystem, STATGROUP_Tickables);
+}
+
+bool UFFuseAssemblyLODSubsystem::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return !IsTemplate() && World && World->GetNetMode() != NM_Client;
+}
+
+bool UFFuseAssemblyLODSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFFuseAssemblyLODSubsystem::WakeAssembly(const UPrimitiveComponent* Component)
+{
+	if (const int32* FrozenIndex = FrozenPartIndices.Find(Component)) { WakeAssembly(*FrozenIndex); }
+}
+
+void UFFuseAssemblyLODSubsystem::WakeAllAssemblies()
+{
+	while (FrozenAssemblies.Num() > 0) { WakeAssembly(FrozenAssemblies.Num() - 1); }
+}
+
+void UFFuseAssemblyLODSubsystem::DumpStats() const
+{
+	UE_LOG(LogTemp, Display, TEXT("Fuse assembly LOD: %d frozen assemblies, %d bodies and %d joints removed from the solver"),
+	       FrozenAssemblies.Num(), BodiesRemoved, JointsRemoved);
+}
+
+void UFFuseAssemblyLODSubsystem::UpdateAssemblies()
+{
+	UWorld* World = GetWorld();
+	const double Now = World->GetTimeSeconds();
+	const float FreezeDistance = CVarFuseAssemblyLODDistance.GetValueOnGameThread();
+	const float IdleTime = CVarFuseAssemblyLODIdleTime.GetValueOnGameThread();
+	const float WakeDistance = CVarFuseAssemblyLODWakeDistance.GetValueOnGameThread();
+
+	TArray<FVector, TInlineAllocator<16>> PlayerLocations;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APawn* Pawn = It->IsValid() ? (*It)->GetPawn() : nullptr;
+		if (Pawn) { PlayerLocations.Add(Pawn->GetActorLocation()); }
+	}
+	auto DistanceToPlayers = [&PlayerLocations](const FBox& Bounds)
+	{
+		double ClosestDistanceSquared = MAX_dbl;
+		for (const FVector& Location : PlayerLocations)
+		{
+			ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, Bounds.ComputeSquaredDistanceToPoint(Location));
+		}
+		return FMath::Sqrt(ClosestDistanceSquared);
+	};
+
+	TArray<const UFFuseComponent*, TInlineAllocator<16>> Fusers;
+	for (TObjectIterator<UFFuseComponent> It; It; ++It)
+	{
+		if (It->GetWorld() == World) { Fusers.Add(*It); }
+	}
+	auto IsInUse = [&Fusers](const UPrimitiveComponent* Part)
+	{
+		for (const UFFuseComponent* Fuser : Fusers)
+		{
+			if (Fuser->IsComponentInUse(Part)) { return true; }
+		}
+		return false;
+	};
+
+	// Wake frozen assemblies players have come back to, backwards since waking removes them
+	for (int32 FrozenIndex = FrozenAssemblies.Num() - 1; FrozenIndex >= 0; FrozenIndex--)
+	{
+		const FFrozenAssembly& Frozen = FrozenAssemblies[FrozenIndex];
+		const double Distance = DistanceToPlayers(Frozen.Bounds);
+		if (!Frozen.Parts[0].IsValid() || Distance < WakeDistance || (Frozen.bFrozenWhileMoving && Distance < FreezeDistance))
+		{
+			WakeAssembly(FrozenIndex);
+		}
+	}
+
+	// Freeze awake assemblies that have been at rest or out of range for long enough
+	TArray<FFuseAssemblyComponents> Assemblies;
+	const FString& SocketSubName = Fusers.Num() > 0 ? Fusers[0]->FusableSocketSubName : GetDefault<UFFuseComponent>()->FusableSocketSubName;
+	FFuseAssemblySerializer::FindAssemblies(World, SocketSubName, Assemblies);
+
+	TMap<TObjectKey<UPrimitiveComponent>, double> NextRestingSince;
+	TMap<TObjectKey<UPrimitiveComponent>, double> NextFarSince;
+	TSet<const UPrimitiveComponent*> AssemblyParts;
+	for (const FFuseAssemblyComponents& Assembly : Assemblies)
+	{
+		AssemblyParts.Append(Assembly.Parts);
+		UPrimitiveComponent* FirstPart = Assembly.Parts[0];
+		FBox Bounds(ForceInit);
+		bool bResting = true;
+		bool bCanFreeze = true;
+		for (UPrimitiveComponent* Part : Assembly.Parts)
+		{
+			// Only whole simulating actors are welded, anything attached or kinematic is left as it is
+			bCanFreeze &= Part->IsSimulatingPhysics() && !Part->GetAttachParent() && Part == Part->GetOwner()->GetRootComponent()
+			              && !FrozenPartIndices.Contains(Part) && !IsInUse(Part);
+			if (!bCanFreeze) { break; }
+			Bounds += Part->Bounds.GetBox();
+			bResting &= Part->GetPhysicsLinearVelocity().SizeSquared() < FMath::Square(FuseAssemblyLOD::RestLinearSpeed)
+			            && Part->GetPhysicsAngularVelocityInRadians().SizeSquared() < FMath::Square(FuseAssemblyLOD::RestAngularSpeed);
+		}
+		if (!bCanFreeze) { continue; }
+
+		const double Distance = DistanceToPlayers(Bounds);
+		if (Distance < WakeDistance * FuseAssemblyLOD::WakeHysteresis) { continue; }
+
+		const bool bFar = Distance > FreezeDistance;
+		const double* RestingStart = RestingSince.Find(FirstPart);
+		const double* FarStart = FarSince.Find(FirstPart);
+		const double RestingTime = bResting && RestingStart ? Now - *RestingStart : 0.0;
+		const double FarTime = bFar && FarStart ? Now - *FarStart : 0.0;
+		if (RestingTime >= IdleTime || FarTime >= IdleTime)
+		{
+			FreezeAssembly(Assembly.Parts, Assembly.Joints, Bounds, !bResting);
+			continue;
+		}
+		if (bResting) { NextRestingSince.Add(FirstPart, RestingStart ? *RestingStart : Now); }
+		if (bFar) { NextFarSince.Add(FirstPart, FarStart ? *FarStart : Now); }
+	}
+
+	// Demote promoted instances that ended up unfused once they've been at rest for long enough
+	TArray<UPrimitiveComponent*> Promoted;
+	FFuseInstancedFusables::GetPromoted(World, Promoted);
+	for (UPrimitiveComponent* Component : Promoted)
+	{
+		if (AssemblyParts.Contains(Component) || !Component->IsSimulatingPhysics() || IsInUse(Component)) { continue; }
+		const bool bResting = Component->GetPhysicsLinearVelocity().SizeSquared() < FMath::Square(FuseAssemblyLOD::RestLinearSpeed)
+		                      && Component->GetPhysicsAngularVelocityInRadians().SizeSquared() < FMath::Square(FuseAssemblyLOD::RestAngularSpeed);
+		if (!bResting) { continue; }
+
+		const double* RestingStart = RestingSince.Find(Component);
+		if (RestingStart && Now - *RestingStart >= IdleTime) { FFuseInstancedFusables::Demote(Component); }
+		else { NextRestingSince.Add(Component, RestingStart ? *RestingStart : Now); }
+	}
+	RestingSince = MoveTemp(NextRestingSince);
+	FarSince = MoveTemp(NextFarSince);
+}
+
+void UFFuseAssemblyLODSubsystem::FreezeAssembly(const TConstArrayView<UPrimitiveComponent*> Parts, const TConstArrayView<UPhysicsConstraintComponent*> Joints,
+                                                const FBox& Bounds, const bool bMoving)
+{
+	const int32 FrozenIndex = FrozenAssemblies.Num();
+	FFrozenAssembly& Frozen = FrozenAssemblies.AddDefaulted_GetRef();
+	Frozen.Bounds = Bounds;
+	Frozen.bFrozenWhileMoving = bMoving;
+
+	// The joints go first, welded parts can't pull against each other
+	for (UPhysicsConstraintComponent* Joint : Joints)
+	{
+		Joint->ConstraintInstance.TermConstraint();
+		Frozen.Joints.Add(Joint);
+	}
+
+	UPrimitiveComponent* FirstPart = Parts[0];
+	TMap<UStaticMesh*, UInstancedStaticMeshComponent*, TInlineSetAllocator<8>> MeshInstances;
+	for (UPrimitiveComponent* Part : Parts)
+	{
+		Frozen.Parts.Add(Part);
+		FrozenPartIndices.Add(Part, FrozenIndex);
+		if (Part != FirstPart)
+		{
+			// Welding moves the part's shapes into the first part's body, so the whole assembly is one body in the solver
+			Part->AttachToComponent(FirstPart, FAttachmentTransformRules(EAttachmentRule::KeepWorld, true));
+		}
+
+		const UStaticMeshComponent* StaticMeshPart = Cast<UStaticMeshComponent>(Part);
+		UStaticMesh* StaticMesh = StaticMeshPart ? StaticMeshPart->GetStaticMesh() : nullptr;
+		if (!StaticMesh) { continue; }
+
+		// Draw the parts as one instanced component per mesh, their own components are hidden but still collide
+		UInstancedStaticMeshComponent*& Instances = MeshInstances.FindOrAdd(StaticMesh, nullptr);
+		if (!Instances)
+		{
+			Instances = NewObject<UInstancedStaticMeshComponent>(FirstPart->GetOwner());
+			Instances->SetStaticMesh(StaticMesh);
+			for (int32 MaterialIndex = 0; MaterialIndex < StaticMeshPart->GetNumMaterials(); MaterialIndex++)
+			{
+				Instances->SetMaterial(MaterialIndex, StaticMeshPart->GetMaterial(MaterialIndex));
+			}
+			Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			Instances->SetupAttachment(FirstPart);
+			Instances->RegisterComponent();
+			Frozen.Instances.Add(Instances);
+		}
+		Instances->AddInstance(Part->GetComponentTransform(), true);
+		Part->SetVisibility(false);
+	}
+
+	FirstPart->SetSimulatePhysics(false);
+	Frozen.bFirstPartNotifiedHits = FirstPart->BodyInstance.bNotifyRigidBodyCollision;
+	FirstPart->SetNotifyRigidBodyCollision(true);
+	FirstPart->OnComponentHit.AddDynamic(this, &UFFuseAssemblyLODSubsystem::OnFrozenAssemblyHit);
+
+	BodiesRemoved += Parts.Num() - 1;
+	JointsRemoved += Joints.Num();
+}
+
+void UFFuseAssemblyLODSubsystem::WakeAssembly(const int32 FrozenIndex)
+{
+	FFrozenAssembly Frozen = MoveTemp(FrozenAssemblies[FrozenIndex]);
+	FrozenAssemblies.RemoveAtSwap(FrozenIndex);
+	RebuildFrozenPartIndices();
+
+	UPrimitiveComponent* FirstPart = Frozen.Parts[0].Get();
+	if (FirstPart)
+	{
+		FirstPart->OnComponentHit.RemoveDynamic(this, &UFFuseAssemblyLODSubsystem::OnFrozenAssemblyHit);
+		FirstPart->SetNotifyRigidBodyCollision(Frozen.bFirstPartNotifiedHits);
+	}
+	for (const TWeakObjectPtr<UInstancedStaticMeshComponent>& Instances : Frozen.Instances)
+	{
+		if (Instances.IsValid()) { Instances->DestroyComponent(); }
+	}
+	for (const TWeakObjectPtr<UPrimitiveComponent>& Part : Frozen.Parts)
+	{
+		if (!Part.IsValid()) { continue; }
+		// Detaching unwelds the part back into its own body
+		if (Part.Get() != FirstPart) { Part->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform); }
+		Part->SetVisibility(true);
+		Part->SetSimulatePhysics(true);
+	}
+	for (const TWeakObjectPtr<UPhysicsConstraintComponent>& Joint : Frozen.Joints)
+	{
+		if (Joint.IsValid()) { Joint->InitComponentConstraint(); }
+	}
+
+	BodiesRemoved -= Frozen.Parts.Num() - 1;
+	JointsRemoved -= Frozen.Joints.Num();
+}
+
+void UFFuseAssemblyLODSubsystem::RebuildFrozenPartIndices()
+{
+	FrozenPartIndices.Reset();
+	for (int32 FrozenIndex = 0; FrozenIndex < FrozenAssemblies.Num(); FrozenIndex++)
+	{
+		for (const TWeakObjectPtr<UPrimitiveComponent>& Part : FrozenAssemblies[FrozenIndex].Parts)
+		{
+			FrozenPartIndices.Add(Part.Get(), FrozenIndex);
+		}
+	}
+}
+
+void UFFuseAssemblyLODSubsystem::OnFrozenAssemblyHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
+                                                     FVector NormalImpulse, const FHitResult& Hit)
+{
+	// Anything moving into a frozen assembly wakes it, the ground it rests on doesn't
+	if (OtherComp && (OtherComp->IsSimulatingPhysics() || Cast<APawn>(OtherActor))) { WakeAssembly(HitComponent); }
+}
@@ -0,0 +1,80 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FFuseAssemblyLODSubsystem.generated.h"
+
+class UInstancedStaticMeshComponent;
+class UPhysicsConstraintComponent;
+
+/*
+ *
+ * Freezes finished assemblies that are at rest or far from every player, so they stop costing solver and render time.
+ * A frozen assembly's joints are removed from the solver and its parts are welded into one kinematic body on its first
+ * part, with the part meshes drawn as one instanced component per mesh.
+ * Assemblies wake back to full simulation when a player comes near, when they're hit, and when a part is grabbed or
+ * fused to. Only runs on the server, clients follow the replicated movement of the parts.
+ * f.fuseassemblylod 0 to disable, f.fuseassemblylodstats to log what's frozen
+ *
+ */
+
+UCLASS()
+class FUSE_API UFFuseAssemblyLODSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override;
+
+	// Restore the frozen assembly containing a component to full simulation, does nothing if it isn't frozen
+	void WakeAssembly(const UPrimitiveComponent* Component);
+
+	// Wake every frozen assembly
+	void WakeAllAssemblies();
+
+	int32 NumFrozenAssemblies() const { return FrozenAssemblies.Num(); }
+	// Bodies merged away and joints removed from the solver by frozen assemblies
+	int32 NumBodiesRemoved() const { return BodiesRemoved; }
+	int32 NumJointsRemoved() const { return JointsRemoved; }
+
+	void DumpStats() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FFrozenAssembly
+	{
+		// The first part is the kinematic body the others are welded to
+		TArray<TWeakObjectPtr<UPrimitiveComponent>> Parts;
+		TArray<TWeakObjectPtr<UPhysicsConstraintComponent>> Joints;
+		TArray<TWeakObjectPtr<UInstancedStaticMeshComponent>> Instances;
+		FBox Bounds;
+		// Frozen for distance rather than rest, so it wakes as soon as a player is back in range
+		bool bFrozenWhileMoving = false;
+		// Hit events are turned on for the first part while it's frozen, so it can be woken by being hit
+		bool bFirstPartNotifiedHits = false;
+	};
+
+	void UpdateAssemblies();
+	void FreezeAssembly(TConstArrayView<UPrimitiveComponent*> Parts, TConstArrayView<UPhysicsConstraintComponent*> Joints, const FBox& Bounds, bool bMoving);
+	void WakeAssembly(int32 FrozenIndex);
+	void RebuildFrozenPartIndices();
+
+	UFUNCTION()
+	void OnFrozenAssemblyHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
+	TArray<FFrozenAssembly> FrozenAssemblies;
+	TMap<TObjectKey<UPrimitiveComponent>, int32> FrozenPartIndices;
+	// When each awake assembly came to rest, keyed by its first part
+	TMap<TObjectKey<UPrimitiveComponent>, double> RestingSince;
+	// When each awake assembly went out of range of every player, keyed by its first part
+	TMap<TObjectKey<UPrimitiveComponent>, double> FarSince;
+	float TimeSinceUpdate = 0.0f;
+	int32 BodiesRemoved = 0;
+	int32 JointsRemoved = 0;
+};
@@ -0,0 +1,323 @@
+
+#include "FFuseAssemblyStreamingSubsystem.h"
+#include "FFuseAssemblyLODSubsystem.h"
+#include "FFuseComponent.h"
+#include "FuseActorPool.h"
+#include "FuseAssembly.h"
+#include "FuseStats.h"
+#include "Engine/Level.h"
+#include "Engine/LevelBounds.h"
+#include "Misc/ScopeExit.h"
+#include "PhysicsEngine/PhysicsConstraintComponent.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+static TAutoConsoleVariable<bool> CVarFuseAssemblyStreaming(
+	TEXT("f.fuseassemblystreaming"), true, TEXT("Store fused assemblies when the cell they belong to unloads, and build them again when it loads"));
+
+static FAutoConsoleCommandWithWorld FuseAssemblyStreamingStatsCommand(
+	TEXT("f.fuseassemblystreamingstats"),
+	TEXT("Log the assemblies stored for unloaded cells, and the memory they take"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UFFuseAssemblyStreamingSubsystem* Subsystem = World ? World->GetSubsystem<UFFuseAssemblyStreamingSubsystem>() : nullptr)
+		{
+			Subsystem->DumpStats();
+		}
+	}));
+
+namespace FuseAssemblyStreaming
+{
+	// The persistent level never unloads, everything else is a World Partition cell or a streaming level
+	static bool IsStreamedCell(const ULevel* Level)
+	{
+		return Level && !Level->IsPersistentLevel();
+	}
+
+	// Fuse settings of a world, from its first fuse component or the defaults
+	static const UFFuseComponent* FindFuseSettings(const UWorld* World)
+	{
+		for (TObjectIterator<UFFuseComponent> It; It; ++It)
+		{
+			if (It->GetWorld() == World) { return *It; }
+		}
+		return GetDefault<UFFuseComponent>();
+	}
+
+	// Abort the fuses and grabs of fusers using a part in the cell, or a part of an assembly with parts in it, so
+	// nothing a fuser still holds is removed from under it. Returns true if any were aborted
+	static bool AbortFusesInCell(const UWorld* World, const ULevel* Level, TConstArrayView<FFuseAssemblyComponents> Assemblies)
+	{
+		TSet<const UPrimitiveComponent*> Affected;
+		for (const FFuseAssemblyComponents& Assembly : Assemblies)
+		{
+			if (Assembly.Parts.ContainsByPredicate([Level](const UPrimitiveComponent* Part) { return Part->GetComponentLevel() == Level; }))
+			{
+				for (const UPrimitiveComponent* Part : Assembly.Parts) { Affected.Add(Part); }
+			}
+		}
+		bool bAborted = false;
+		TArray<UPrimitiveComponent*> InUse;
+		for (TObjectIterator<UFFuseComponent> It; It; ++It)
+		{
+			if (It->GetWorld() != World) { continue; }
+			It->GetComponentsInUse(InUse);
+			if (InUse.ContainsByPredicate([Level, &Affected](const UPrimitiveComponent* Component)
+			{
+				return Component->GetComponentLevel() == Level || Affected.Contains(Component);
+			}))
+			{
+				It->AbortFuse();
+				bAborted = true;
+			}
+		}
+		return bAborted;
+	}
+
+	static bool IsAssemblyInUse(const UWorld* World, const FFuseAssemblyComponents& Assembly)
+	{
+		for (TObjectIterator<UFFuseComponent> It; It; ++It)
+		{
+			if (It->GetWorld() != World) { continue; }
+			for (const UPrimitiveComponent* Part : Assembly.Parts)
+			{
+				if (It->IsComponentInUse(Part)) { return true; }
+			}
+		}
+		return false;
+	}
+}
+
+void UFFuseAssemblyStreamingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UFFuseAssemblyStreamingSubsystem::OnLevelAdded);
+	PreLevelRemovedHandle = FWorldDelegates::PreLevelRemovedFromWorld.AddUObject(this, &UFFuseAssemblyStreamingSubsystem::OnPreLevelRemoved);
+}
+
+void UFFuseAssemblyStreamingSubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::PreLevelRemovedFromWorld.Remove(PreLevelRemovedHandle);
+	// Stored assemblies go with the world, saving them past it is f.fusesaveassemblies
+	StoredCells.Reset();
+	StoredAssemblies = 0;
+	StoredParts = 0;
+	StoredBytes = 0;
+	UpdateStats();
+	Super::Deinitialize();
+}
+
+bool UFFuseAssemblyStreamingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFFuseAssemblyStreamingSubsystem::DumpStats() const
+{
+	UE_LOG(LogTemp, Display, TEXT("Fuse assembly streaming: %d assemblies (%d parts) stored for %d unloaded cells in %lld bytes, %d placed actors replaced"),
+	       StoredAssemblies, StoredParts, StoredCells.Num(), StoredBytes, ReplacedPlacedActors.Num());
+}
+
+void UFFuseAssemblyStreamingSubsystem::UpdateStats() const
+{
+	FUSE_SET_COUNTER(StreamedOutParts, StoredParts);
+	FUSE_SET_COUNTER(StreamedOutBytes, StoredBytes);
+}
+
+void UFFuseAssemblyStreamingSubsystem::OnPreLevelRemoved(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld() || !FuseAssemblyStreaming::IsStreamedCell(Level)) { return; }
+	ON_SCOPE_EXIT { CellBounds.Remove(Level); };
+	if (World->bIsTearingDown || World->GetNetMode() == NM_Client || !CVarFuseAssemblyStreaming.GetValueOnGameThread()) { return; }
+	FUSE_SCOPE_CYCLE_COUNTER(StreamAssemblies);
+
+	const UFFuseComponent* Settings = FuseAssemblyStreaming::FindFuseSettings(World);
+	TArray<FFuseAssemblyComponents> Assemblies;
+	FFuseAssemblySerializer::FindAssemblies(World, Settings->FusableSocketSubName, Assemblies);
+	// A fuse in progress has a constraint that isn't part of the assembly yet, so the assemblies are found again without it
+	if (FuseAssemblyStreaming::AbortFusesInCell(World, Level, Assemblies))
+	{
+		Assemblies.Reset();
+		FFuseAssemblySerializer::FindAssemblies(World, Settings->FusableSocketSubName, Assemblies);
+	}
+
+	// Assemblies this cell owns are stored with it, assemblies owned elsewhere only need the parts they have in it replaced
+	// Assemblies a fuser is still using have no parts in the cell after the aborts, and are left to be stored next time
+	TArray<FFuseAssemblyComponents> Owned;
+	TArray<FFuseAssemblyComponents> Pinned;
+	for (FFuseAssemblyComponents& Assembly : Assemblies)
+	{
+		if (FuseAssemblyStreaming::IsAssemblyInUse(World, Assembly)) { continue; }
+		if (FindOwningCell(Assembly) == Level)
+		{
+			Owned.Add(MoveTemp(Assembly));
+			continue;
+		}
+		if (Assembly.Parts.ContainsByPredicate([Level](const UPrimitiveComponent* Part) { return Part->GetComponentLevel() == Level; }))
+		{
+			Pinned.Add(MoveTemp(Assembly));
+		}
+	}
+	if (Owned.Num() == 0 && Pinned.Num() == 0) { return; }
+
+	// Frozen assemblies are welded, their parts have to be separate again before they're saved and removed
+	if (UFFuseAssemblyLODSubsystem* AssemblyLOD = World->GetSubsystem<UFFuseAssemblyLODSubsystem>())
+	{
+		for (const FFuseAssemblyComponents& Assembly : Owned) { AssemblyLOD->WakeAssembly(Assembly.Parts[0]); }
+		for (const FFuseAssemblyComponents& Assembly : Pinned) { AssemblyLOD->WakeAssembly(Assembly.Parts[0]); }
+	}
+
+	if (Owned.Num() > 0)
+	{
+		FFuseAssemblyArchive Archive;
+		FFuseAssemblySerializer::Gather(World, Owned, Settings->FusableSocketSubName, Settings->ComponentRotationMultiplier, Archive);
+		ReplacePlacedParts(Archive, Owned, [Level](const UPrimitiveComponent* Part) { return Part->GetComponentLevel() != Level; });
+		RemoveAssemblies(Owned, Level, false);
+
+		FStoredCell& Stored = StoredCells.FindOrAdd(Level->GetPackage()->GetFName());
+		TArray<uint8>& Bytes = Stored.Archives.AddDefaulted_GetRef();
+		FMemoryWriter Writer(Bytes);
+		FFuseAssemblySerializer::Serialize(Writer, Archive);
+		Stored.Assemblies += Archive.Assemblies.Num();
+		Stored.Parts += Archive.NumParts();
+		StoredAssemblies += Archive.Assemblies.Num();
+		StoredParts += Archive.NumParts();
+		StoredBytes += Bytes.Num();
+	}
+
+	if (Pinned.Num() > 0)
+	{
+		// Built again straight away, from copies of the parts in this cell and the same actors for everything else
+		FFuseAssemblyArchive Archive;
+		FFuseAssemblySerializer::Gather(World, Pinned, Settings->FusableSocketSubName, Settings->ComponentRotationMultiplier, Archive);
+		ReplacePlacedParts(Archive, Pinned, [Level](const UPrimitiveComponent* Part) { return Part->GetComponentLevel() == Level; });
+		RemoveAssemblies(Pinned, Level, true);
+
+		TArray<UPrimitiveComponent*> Parts;
+		for (const FFuseAssembly& Assembly : Archive.Assemblies)
+		{
+			FFuseAssemblySerializer::Spawn(World, Archive, Assembly, Assembly.RootTransform, Settings->PhysicsConstraintActor,
+			                               Settings->FusableSocketSubName, true, Parts);
+		}
+	}
+	UpdateStats();
+}
+
+void UFFuseAssemblyStreamingSubsystem::OnLevelAdded(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld() || !FuseAssemblyStreaming::IsStreamedCell(Level) || World->GetNetMode() == NM_Client) { return; }
+
+	// Placed actors that were replaced by copies would be duplicates of parts that are already in an assembly
+	if (ReplacedPlacedActors.Num() > 0)
+	{
+		TArray<AActor*> Replaced;
+		for (AActor* Actor : Level->Actors)
+		{
+			if (Actor && ReplacedPlacedActors.Contains(Actor->GetPathName(World))) { Replaced.Add(Actor); }
+		}
+		for (AActor* Actor : Replaced) { Actor->Destroy(); }
+	}
+
+	// Restored even while storing is off, so turning it off doesn't lose anything
+	FStoredCell Stored;
+	if (!StoredCells.RemoveAndCopyValue(Level->GetPackage()->GetFName(), Stored)) { return; }
+	FUSE_SCOPE_CYCLE_COUNTER(StreamAssemblies);
+
+	const UFFuseComponent* Settings = FuseAssemblyStreaming::FindFuseSettings(World);
+	TArray<UPrimitiveComponent*> Parts;
+	for (const TArray<uint8>& Bytes : Stored.Archives)
+	{
+		FFuseAssemblyArchive Archive;
+		FMemoryReader Reader(Bytes);
+		if (FFuseAssemblySerializer::Serialize(Reader, Archive))
+		{
+			for (const FFuseAssembly& Assembly : Archive.Assemblies)
+			{
+				FFuseAssemblySerializer::Spawn(World, Archive, Assembly, Assembly.RootTransform, Settings->PhysicsConstraintActor,
+				                               Settings->FusableSocketSubName, true, Parts);
+			}
+		}
+		StoredBytes -= Bytes.Num();
+	}
+	StoredAssemblies -= Stored.Assemblies;
+	StoredParts -= Stored.Parts;
+	UpdateStats();
+}
+
+ULevel* UFFuseAssemblyStreamingSubsystem::FindOwningCell(const FFuseAssemblyComponents& Assembly)
+{
+	// The centre of the whole assembly, so it doesn't matter which cell each part is in or which part was found first
+	FBox AssemblyBounds(ForceInit);
+	for (const UPrimitiveComponent* Part : Assembly.Parts) { AssemblyBounds += Part->Bounds.GetBox(); }
+	const FVector Centre = AssemblyBounds.GetCenter();
+
+	// The smallest cell containing it, cells of different World Partition grids overlap
+	ULevel* OwningCell = nullptr;
+	double OwningCellVolume = MAX_dbl;
+	for (ULevel* Level : GetWorld()->GetLevels())
+	{
+		if (!FuseAssemblyStreaming::IsStreamedCell(Level) || !Level->bIsVisible) { continue; }
+		const FBox& Bounds = GetCellBounds(Level);
+		if (Bounds.IsValid && Bounds.IsInsideOrOn(Centre) && Bounds.GetVolume() < OwningCellVolume)
+		{
+			OwningCell = Level;
+			OwningCellVolume = Bounds.GetVolume();
+		}
+	}
+	return OwningCell;
+}
+
+const FBox& UFFuseAssemblyStreamingSubsystem::GetCellBounds(ULevel* Level)
+{
+	// Only worked out once while the cell is loaded, its placed actors don't move
+	if (const FBox* Bounds = CellBounds.Find(Level)) { return *Bounds; }
+	return CellBounds.Add(Level, ALevelBounds::CalculateLevelBounds(Level));
+}
+
+void UFFuseAssemblyStreamingSubsystem::ReplacePlacedParts(FFuseAssemblyArchive& Archive, const TConstArrayView<FFuseAssemblyComponents> Assemblies,
+                                                          const TFunctionRef<bool(const UPrimitiveComponent*)> ShouldReplace)
+{
+	// Gather keeps the assembly and part order, so the archive parts line up with the components
+	for (int32 AssemblyIndex = 0; AssemblyIndex < Assemblies.Num(); AssemblyIndex++)
+	{
+		TArray<FFuseAssemblyPart>& Parts = Archive.Assemblies[AssemblyIndex].Parts;
+		for (int32 PartIndex = 0; PartIndex < Parts.Num(); PartIndex++)
+		{
+			if (Parts[PartIndex].PlacedActor == INDEX_NONE || !ShouldReplace(Assemblies[AssemblyIndex].Parts[PartIndex])) { continue; }
+			ReplacedPlacedActors.Add(Archive.PlacedActors[Parts[PartIndex].PlacedActor]);
+			Parts[PartIndex].PlacedActor = INDEX_NONE;
+		}
+	}
+}
+
+void UFFuseAssemblyStreamingSubsystem::RemoveAssemblies(const TConstArrayView<FFuseAssemblyComponents> Assemblies, const ULevel* UnloadingCell,
+                                                        const bool bRebuilding)
+{
+	for (const FFuseAssemblyComponents& Assembly : Assemblies)
+	{
+		for (const UPhysicsConstraintComponent* Joint : Assembly.Joints)
+		{
+			if (Joint->GetOwner()) { Joint->GetOwner()->Destroy(); }
+		}
+		for (UPrimitiveComponent* Part : Assembly.Parts)
+		{
+			AActor* Owner = Part->GetOwner();
+			if (!Owner) { continue; }
+			if (Part->GetComponentLevel() == UnloadingCell)
+			{
+				// Gone with the cell, it just mustn't push against a copy of itself until then
+				Part->SetSimulatePhysics(false);
+				Part->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+				continue;
+			}
+			if (bRebuilding)
+			{
+				// Placed parts are reused where they are, spawned parts are taken from the pool again
+				if (!Owner->HasAnyFlags(RF_WasLoaded)) { FFuseActorPool::Release(Owner); }
+				continue;
+			}
+			Owner->Destroy();
+		}
+	}
+}
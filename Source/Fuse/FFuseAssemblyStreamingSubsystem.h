@@ -0,0 +1,83 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FFuseAssemblyStreamingSubsystem.generated.h"
+
+struct FFuseAssemblyArchive;
+struct FFuseAssemblyComponents;
+
+/*
+ *
+ * Streams fused assemblies out and back in with the World Partition cells or streaming levels they're in, so memory
+ * and solver time go to the builds near loaded cells rather than every build ever made.
+ * Each assembly belongs to one owning cell, the smallest loaded cell whose bounds contain the assembly's centre, so an
+ * assembly spanning cells is always stored and restored whole. When a cell is about to unload, the assemblies it owns
+ * are saved with FFuseAssemblySerializer into a compact buffer kept for the cell and their parts and joints are
+ * removed. When the cell loads again they're all built in one batch. Placed parts are only reused from the owning cell,
+ * placed parts from other cells are replaced with spawned copies. An assembly owned by a cell that stays loaded keeps
+ * its place, and just has any placed parts in the unloading cell replaced. Fusers holding or fusing parts of an
+ * assembly in the unloading cell let go first, and assemblies still in use are never stored or rebuilt.
+ * Only runs on the server. f.fuseassemblystreaming 0 to stop storing, f.fuseassemblystreamingstats to log what's stored
+ *
+ */
+
+UCLASS()
+class FUSE_API UFFuseAssemblyStreamingSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Cells with stored assemblies, and the assemblies, parts and bytes stored for them
+	int32 NumStoredCells() const { return StoredCells.Num(); }
+	int32 NumStoredAssemblies() const { return StoredAssemblies; }
+	int32 NumStoredParts() const { return StoredParts; }
+	int64 NumStoredBytes() const { return StoredBytes; }
+
+	void DumpStats() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FStoredCell
+	{
+		// Serialized FFuseAssemblyArchives, one for each time the cell unloaded with assemblies in it
+		TArray<TArray<uint8>> Archives;
+		int32 Assemblies = 0;
+		int32 Parts = 0;
+	};
+
+	void OnLevelAdded(ULevel* Level, UWorld* World);
+	void OnPreLevelRemoved(ULevel* Level, UWorld* World);
+
+	// The loaded cell an assembly belongs to, null if it's outside every cell and stays loaded with the persistent level
+	ULevel* FindOwningCell(const FFuseAssemblyComponents& Assembly);
+	const FBox& GetCellBounds(ULevel* Level);
+
+	// Placed parts that ShouldReplace picks are spawned as copies when the archive is built, and the placed actors are
+	// removed whenever their cell loads again
+	void ReplacePlacedParts(FFuseAssemblyArchive& Archive, TConstArrayView<FFuseAssemblyComponents> Assemblies,
+	                        TFunctionRef<bool(const UPrimitiveComponent*)> ShouldReplace);
+
+	// Remove assemblies' joints and parts, parts in the unloading cell are left for it to unload
+	// Spawned parts go back to the actor pool when they're about to be built again, otherwise they're destroyed
+	static void RemoveAssemblies(TConstArrayView<FFuseAssemblyComponents> Assemblies, const ULevel* UnloadingCell, bool bRebuilding);
+
+	void UpdateStats() const;
+
+	// Stored assemblies by the package name of their owning cell, which stays the same when the cell loads again
+	TMap<FName, FStoredCell> StoredCells;
+	// Path names of placed actors that were replaced by spawned copies
+	TSet<FString> ReplacedPlacedActors;
+	TMap<TObjectKey<ULevel>, FBox> CellBounds;
+	int32 StoredAssemblies = 0;
+	int32 StoredParts = 0;
+	int64 StoredBytes = 0;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle PreLevelRemovedHandle;
+};
@@ -0,0 +1,57 @@
+
+#include "FFuseBakeSocketTablesCommandlet.h"
+#include "FFusableSocketTableUserData.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshSocket.h"
+#include "Misc/PackageName.h"
+#include "UObject/SavePackage.h"
+
+int32 UFFuseBakeSocketTablesCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString ContentPath = TEXT("/Game");
+	FString SocketSubName = TEXT("Attach");
+	FParse::Value(*Params, TEXT("Path="), ContentPath);
+	FParse::Value(*Params, TEXT("SubName="), SocketSubName);
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+	TArray<FAssetData> MeshAssets;
+	AssetRegistry.GetAssetsByPath(FName(*ContentPath), MeshAssets, true);
+
+	int32 BakedMeshes = 0;
+	int32 FailedSaves = 0;
+	for (const FAssetData& AssetData : MeshAssets)
+	{
+		if (AssetData.AssetClassPath != UStaticMesh::StaticClass()->GetClassPathName()) { continue; }
+		UStaticMesh* StaticMesh = Cast<UStaticMesh>(AssetData.GetAsset());
+		if (!StaticMesh) { continue; }
+
+		// Only touch meshes that have, or had, fusable sockets
+		const bool bHadTable = StaticMesh->GetAssetUserData<UFFusableSocketTableUserData>() != nullptr;
+		const bool bHasFusableSockets = StaticMesh->Sockets.ContainsByPredicate([&SocketSubName](const UStaticMeshSocket* Socket)
+		{
+			return Socket && Socket->SocketName.ToString().Contains(SocketSubName);
+		});
+		if (!bHadTable && !bHasFusableSockets) { continue; }
+
+		if (UFFusableSocketTableUserData::BakeMesh(StaticMesh, SocketSubName)) { BakedMeshes++; }
+
+		UPackage* Package = StaticMesh->GetPackage();
+		const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		if (!UPackage::SavePackage(Package, StaticMesh, *Filename, SaveArgs))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Failed to save %s"), *Filename);
+			FailedSaves++;
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Baked fusable socket tables onto %d static meshes under %s"), BakedMeshes, *ContentPath);
+	return FailedSaves > 0 ? 1 : 0;
+#else
+	return 1;
+#endif
+}
@@ -0,0 +1,22 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "FFuseBakeSocketTablesCommandlet.generated.h"
+
+/*
+ *
+ * Bakes fusable socket tables onto every static mesh with fusable sockets under a content path, and saves them.
+ * UnrealEditor-Cmd Fuse.uproject -run=FFuseBakeSocketTables [-Path=/Game] [-SubName=Attach]
+ *
+ */
+
+UCLASS()
+class UFFuseBakeSocketTablesCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	virtual int32 Main(const FString& Params) override;
+};
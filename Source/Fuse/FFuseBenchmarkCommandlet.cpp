@@ -0,0 +1,523 @@
+
+#include "FFuseBenchmarkCommandlet.h"
+#include "FFuseComponent.h"
+#include "FFuseStressWorldGenerator.h"
+#include "FuseAllocationCounter.h"
+#include "FuseBenchmark.h"
+#include "FuseStats.h"
+#include "EngineUtils.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "PhysicsEngine/PhysicsConstraintActor.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+#if WITH_EDITOR
+namespace FuseBenchmarkCommandlet
+{
+	// Scenarios run far from anything in the loaded map
+	static const FVector ScenarioOrigin(0.0f, 0.0f, 200000.0f);
+
+	// Only the stable metrics go in a generated baseline, with these tolerances
+	static constexpr double TimeTolerance = 0.25;
+	static constexpr double TimeSlackMs = 0.01;
+
+	// Timings, allocations and work of a step that's measured repeatedly
+	struct FSampler
+	{
+		uint64 TotalCycles = 0;
+		uint64 MaxCycles = 0;
+		uint64 Allocations = 0;
+		uint64 PairsScored = 0;
+		uint64 OverlapQueries = 0;
+		int32 Samples = 0;
+
+		void Measure(TFunctionRef<void()> Function)
+		{
+#if FUSE_ALLOCATION_COUNTER
+			const uint64 StartAllocations = FFuseAllocationCounter::GetAllocationCount();
+			FFuseAllocationCounter::FScope AllocationScope;
+#endif
+#if FUSE_WORK_COUNTER
+			const uint64 StartPairsScored = FFuseWorkCounters::Get(EFuseCounter::SocketPairsScored);
+			const uint64 StartOverlapQueries = FFuseWorkCounters::Get(EFuseCounter::OverlapQueries);
+#endif
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			Function();
+			const uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+			TotalCycles += Cycles;
+			MaxCycles = FMath::Max(MaxCycles, Cycles);
+			Samples++;
+#if FUSE_WORK_COUNTER
+			PairsScored += FFuseWorkCounters::Get(EFuseCounter::SocketPairsScored) - StartPairsScored;
+			OverlapQueries += FFuseWorkCounters::Get(EFuseCounter::OverlapQueries) - StartOverlapQueries;
+#endif
+#if FUSE_ALLOCATION_COUNTER
+			Allocations += FFuseAllocationCounter::GetAllocationCount() - StartAllocations;
+#endif
+		}
+
+		// Adds <Name>AvgMs, <Name>MaxMs, <Name>AllocsPerCall, <Name>PairsScoredPerCall and <Name>OverlapQueriesPerCall
+		void Write(FJsonObject& Scenario, const FString& Name) const
+		{
+			const int32 SafeSamples = FMath::Max(1, Samples);
+			Scenario.SetNumberField(Name + TEXT("AvgMs"), FPlatformTime::ToMilliseconds64(TotalCycles) / SafeSamples);
+			Scenario.SetNumberField(Name + TEXT("MaxMs"), FPlatformTime::ToMilliseconds64(MaxCycles));
+#if FUSE_ALLOCATION_COUNTER
+			Scenario.SetNumberField(Name + TEXT("AllocsPerCall"), static_cast<double>(Allocations) / SafeSamples);
+#endif
+#if FUSE_WORK_COUNTER
+			Scenario.SetNumberField(Name + TEXT("PairsScoredPerCall"), static_cast<double>(PairsScored) / SafeSamples);
+			Scenario.SetNumberField(Name + TEXT("OverlapQueriesPerCall"), static_cast<double>(OverlapQueries) / SafeSamples);
+#endif
+		}
+	};
+
+	static AStaticMeshActor* SpawnProp(UWorld* World, UStaticMesh* Mesh, const FVector& Location, const FRotator& Rotation, const bool bSimulate)
+	{
+		AStaticMeshActor* Prop = World->SpawnActor<AStaticMeshActor>(Location, Rotation);
+		UStaticMeshComponent* Component = Prop->GetStaticMeshComponent();
+		Component->SetMobility(EComponentMobility::Movable);
+		Component->SetStaticMesh(Mesh);
+		Component->SetCollisionProfileName(UCollisionProfile::PhysicsActor_ProfileName);
+		Component->SetEnableGravity(false);
+		Component->SetSimulatePhysics(bSimulate);
+		return Prop;
+	}
+
+	static void DestroyActors(TArray<AActor*>& Actors)
+	{
+		for (AActor* Actor : Actors) { Actor->Destroy(); }
+		Actors.Reset();
+	}
+
+	static void Grab(UFFuseComponent* Fuser, UPrimitiveComponent* Component)
+	{
+		Fuser->GrabComponentAtLocationWithRotation(Component, NAME_None, Component->GetComponentLocation(), Component->GetComponentRotation());
+		Fuser->UpdateFuserState(FSTATE_FUSING);
+	}
+
+	static void Release(UFFuseComponent* Fuser)
+	{
+		if (Fuser->GetGrabbedComponent()) { Fuser->ReleaseComponent(); }
+		Fuser->UpdateFuserState(FSTATE_NONE);
+	}
+}
+#endif
+
+UFFuseBenchmarkCommandlet::UFFuseBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UFFuseBenchmarkCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString MapName = TEXT("/Game/Fuse/L_Fuse_TestMap");
+	FString MeshPath = TEXT("/Game/LevelPrototyping/Meshes/SM_Cube.SM_Cube");
+	FString BaselinePath = FPaths::ProjectConfigDir() / TEXT("FuseBenchmarkBaseline.json");
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Fuse") / FString::Printf(TEXT("BenchmarkGate_%s.json"), *FDateTime::Now().ToString());
+	FScenarioSettings Settings;
+	FParse::Value(*Params, TEXT("Map="), MapName);
+	FParse::Value(*Params, TEXT("Mesh="), MeshPath);
+	FParse::Value(*Params, TEXT("Baseline="), BaselinePath);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	FParse::Value(*Params, TEXT("Iterations="), Settings.Iterations);
+	FParse::Value(*Params, TEXT("Clutter="), Settings.ClutterProps);
+	FParse::Value(*Params, TEXT("Pile="), Settings.PileSize);
+	FParse::Value(*Params, TEXT("Chain="), Settings.ChainLength);
+	FParse::Value(*Params, TEXT("Sockets="), Settings.Sockets);
+	FParse::Value(*Params, TEXT("Seed="), Settings.Seed);
+	const bool bUpdateBaseline = FParse::Param(*Params, TEXT("UpdateBaseline"));
+	const bool bRequireTimings = FParse::Param(*Params, TEXT("RequireTimings"));
+	Settings.Iterations = FMath::Max(1, Settings.Iterations);
+	Settings.ChainLength = FMath::Max(2, Settings.ChainLength);
+
+	// Read the baseline first, there's no point running anything if it can't be compared with
+	TSharedPtr<FJsonObject> Baseline;
+	if (!bUpdateBaseline)
+	{
+		FString BaselineString;
+		if (!FFileHelper::LoadFileToString(BaselineString, *BaselinePath) ||
+			!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineString), Baseline) || !Baseline.IsValid())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Failed to read fuse benchmark baseline %s, run with -UpdateBaseline to record one"), *BaselinePath);
+			return 1;
+		}
+	}
+
+	UWorld* World = LoadBenchmarkWorld(MapName);
+	if (!World) { return 1; }
+	UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, *MeshPath);
+	if (!Mesh)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Fuse benchmark failed to load mesh %s"), *MeshPath);
+		DestroyBenchmarkWorld(World);
+		return 1;
+	}
+
+	UFFuseComponent* Fuser = FFuseBenchmark::SpawnBenchmarkFuser(World, FuseBenchmarkCommandlet::ScenarioOrigin);
+	AFFuseStressWorldGenerator::AddGeneratedAttachSockets(Mesh, Fuser->FusableSocketSubName, Settings.Sockets);
+#if FUSE_ALLOCATION_COUNTER
+	FFuseAllocationCounter::Start();
+#endif
+
+	TSharedRef<FJsonObject> Scenarios = MakeShared<FJsonObject>();
+	Scenarios->SetObjectField(TEXT("SearchInClutter"), RunSearchInClutter(World, Fuser, Mesh, Settings));
+	Scenarios->SetObjectField(TEXT("HoldNearPile"), RunHoldNearPile(World, Fuser, Mesh, Settings));
+	TArray<UPrimitiveComponent*> ChainParts;
+	Scenarios->SetObjectField(TEXT("ChainedFusing"), RunChainedFusing(World, Fuser, Mesh, Settings, ChainParts));
+	Scenarios->SetObjectField(TEXT("DetachInAssembly"), RunDetachInAssembly(World, Fuser, ChainParts));
+
+#if FUSE_ALLOCATION_COUNTER
+	FFuseAllocationCounter::Stop();
+#endif
+	AFFuseStressWorldGenerator::RemoveGeneratedAttachSockets(Mesh, Fuser->FusableSocketSubName);
+	DestroyBenchmarkWorld(World);
+
+	TSharedRef<FJsonObject> Results = MakeShared<FJsonObject>();
+	Results->SetStringField(TEXT("Map"), MapName);
+	Results->SetStringField(TEXT("Mesh"), MeshPath);
+	Results->SetStringField(TEXT("Timestamp"), FDateTime::UtcNow().ToIso8601());
+	Results->SetObjectField(TEXT("Scenarios"), Scenarios);
+	FFuseBenchmark::WriteResults(Results, OutputPath);
+
+	if (bUpdateBaseline)
+	{
+		FFuseBenchmark::WriteResults(MakeBaseline(Results), BaselinePath);
+		return 0;
+	}
+
+	const int32 Regressions = CompareWithBaseline(Results, Baseline.ToSharedRef(), bRequireTimings);
+	if (Regressions > 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Fuse benchmark found %d regressions against %s"), Regressions, *BaselinePath);
+		return 1;
+	}
+	UE_LOG(LogTemp, Display, TEXT("Fuse benchmark is within the tolerances of %s"), *BaselinePath);
+	return 0;
+#else
+	return 1;
+#endif
+}
+
+#if WITH_EDITOR
+
+UWorld* UFFuseBenchmarkCommandlet::LoadBenchmarkWorld(const FString& MapName)
+{
+	UPackage* MapPackage = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+	if (!World)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Fuse benchmark failed to load map %s"), *MapName);
+		return nullptr;
+	}
+
+	// Set the map up as a game world the same way loading it to play would, without a viewport
+	World->AddToRoot();
+	World->WorldType = EWorldType::Game;
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues().AllowAudioPlayback(false).CreatePhysicsScene(true).ShouldSimulatePhysics(true));
+	}
+	World->UpdateWorldComponents(true, false);
+
+	const FURL URL;
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+	return World;
+}
+
+void UFFuseBenchmarkCommandlet::DestroyBenchmarkWorld(UWorld* World)
+{
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+TSharedRef<FJsonObject> UFFuseBenchmarkCommandlet::RunSearchInClutter(UWorld* World, UFFuseComponent* Fuser, UStaticMesh* Mesh, const FScenarioSettings& Settings)
+{
+	using namespace FuseBenchmarkCommandlet;
+
+	// Props scattered at random around the held one, close enough that most of them are in fuse range
+	const FVector PropSize = Mesh->GetBoundingBox().GetSize();
+	const float ClutterExtent = PropSize.GetMax() * FMath::Max(1.0f, FMath::Pow(static_cast<float>(Settings.ClutterProps), 1.0f / 3.0f));
+	FRandomStream Random(Settings.Seed);
+	TArray<AActor*> Props;
+	while (Props.Num() < Settings.ClutterProps)
+	{
+		const FVector Offset = Random.GetUnitVector() * Random.FRandRange(PropSize.GetMax() * 1.5f, ClutterExtent);
+		Props.Add(SpawnProp(World, Mesh, ScenarioOrigin + Offset, Random.GetUnitVector().Rotation(), false));
+	}
+	AStaticMeshActor* SourceProp = SpawnProp(World, Mesh, ScenarioOrigin, FRotator::ZeroRotator, false);
+	Props.Add(SourceProp);
+	Grab(Fuser, SourceProp->GetStaticMeshComponent());
+
+	// A full search each time, the first isn't measured so scratch arrays have grown
+	Fuser->TryFindIdealFuseSockets(Fuser->LastFuseOperation, true);
+	FSampler Search;
+	bool bFoundFuse = false;
+	for (int32 Iteration = 0; Iteration < Settings.Iterations; Iteration++)
+	{
+		Fuser->ClearFuseOperationData();
+		Search.Measure([&]() { bFoundFuse = Fuser->TryFindIdealFuseSockets(Fuser->LastFuseOperation, true); });
+	}
+
+	TSharedRef<FJsonObject> Scenario = MakeShared<FJsonObject>();
+	Scenario->SetNumberField(TEXT("Props"), Settings.ClutterProps);
+	Scenario->SetBoolField(TEXT("FoundFuse"), bFoundFuse);
+	Search.Write(*Scenario, TEXT("Search"));
+
+	Release(Fuser);
+	DestroyActors(Props);
+	return Scenario;
+}
+
+TSharedRef<FJsonObject> UFFuseBenchmarkCommandlet::RunHoldNearPile(UWorld* World, UFFuseComponent* Fuser, UStaticMesh* Mesh, const FScenarioSettings& Settings)
+{
+	using namespace FuseBenchmarkCommandlet;
+
+	// A cube of props, with the held one just off the middle of one side
+	const FVector PropSize = Mesh->GetBoundingBox().GetSize();
+	const FVector Spacing = PropSize * 1.05f;
+	TArray<AActor*> Props;
+	for (int32 X = 0; X < Settings.PileSize; X++)
+	{
+		for (int32 Y = 0; Y < Settings.PileSize; Y++)
+		{
+			for (int32 Z = 0; Z < Settings.PileSize; Z++)
+			{
+				Props.Add(SpawnProp(World, Mesh, ScenarioOrigin + FVector(X, Y, Z) * Spacing, FRotator::ZeroRotator, false));
+			}
+		}
+	}
+	const FVector PileCentre = ScenarioOrigin + Spacing * (Settings.PileSize - 1) * 0.5f;
+	const FVector HoldLocation = FVector(ScenarioOrigin.X + Spacing.X * Settings.PileSize + Fuser->MaxFuseDistance * 0.25f, PileCentre.Y, PileCentre.Z);
+	AStaticMeshActor* SourceProp = SpawnProp(World, Mesh, HoldLocation, FRotator::ZeroRotator, false);
+	Props.Add(SourceProp);
+	UPrimitiveComponent* SourceComponent = SourceProp->GetStaticMeshComponent();
+	Grab(Fuser, SourceComponent);
+	Fuser->TryFindIdealFuseSockets(Fuser->LastFuseOperation, true);
+
+	// The held update, the prop sways a little each tick so the candidates are re-scored rather than searched for again
+	FSampler Hold;
+	for (int32 Iteration = 0; Iteration < Settings.Iterations; Iteration++)
+	{
+		float Sin, Cos;
+		FMath::SinCos(&Sin, &Cos, Iteration * 0.5f);
+		SourceComponent->SetWorldLocation(HoldLocation + FVector(0.0f, Sin, Cos) * 2.0f, false, nullptr, ETeleportType::TeleportPhysics);
+		Hold.Measure([&]() { Fuser->TryFindIdealFuseSockets(Fuser->LastFuseOperation); });
+	}
+
+	TSharedRef<FJsonObject> Scenario = MakeShared<FJsonObject>();
+	Scenario->SetNumberField(TEXT("Props"), Props.Num() - 1);
+	Scenario->SetBoolField(TEXT("FoundFuse"), Fuser->LastFuseOperation.IsValid());
+	Hold.Write(*Scenario, TEXT("Hold"));
+
+	Release(Fuser);
+	DestroyActors(Props);
+	return Scenario;
+}
+
+TSharedRef<FJsonObject> UFFuseBenchmarkCommandlet::RunChainedFusing(UWorld* World, UFFuseComponent* Fuser, UStaticMesh* Mesh,
+	const FScenarioSettings& Settings, TArray<UPrimitiveComponent*>& OutParts)
+{
+	using namespace FuseBenchmarkCommandlet;
+
+	// Each link is held just past the end of the chain, then searched for and fused on, stepping the interp at a fixed rate
+	const FVector PropSize = Mesh->GetBoundingBox().GetSize();
+	const float FuseDeltaTime = 1.0f / 60.0f;
+	const int32 MaxFuseSteps = FMath::CeilToInt((Fuser->FuseMaxTimeBeforeSnap + 1.0f) / FuseDeltaTime);
+	OutParts.Reset();
+	OutParts.Add(SpawnProp(World, Mesh, ScenarioOrigin, FRotator::ZeroRotator, true)->GetStaticMeshComponent());
+	FSampler Fuse;
+	int32 Completed = 0;
+	int32 TotalSteps = 0;
+	for (int32 Link = 1; Link < Settings.ChainLength; Link++)
+	{
+		const FVector ChainEnd = OutParts.Last()->GetComponentLocation();
+		UPrimitiveComponent* LinkComponent = SpawnProp(World, Mesh, ChainEnd + FVector(PropSize.X + Fuser->MaxFuseDistance * 0.25f, 0.0f, 0.0f),
+		                                               FRotator(0.0f, 10.0f, 0.0f), true)->GetStaticMeshComponent();
+		OutParts.Add(LinkComponent);
+		Grab(Fuser, LinkComponent);
+		Fuser->ClearFuseOperationData();
+
+		int32 Steps = 0;
+		Fuse.Measure([&]()
+		{
+			if (!Fuser->TryFindIdealFuseSockets(Fuser->LastFuseOperation, true) || !Fuser->TryFuseObjects()) { return; }
+			while (Fuser->GetCurrentFuseState() == FSTATE_ACTIVEFUSING && Steps < MaxFuseSteps)
+			{
+				Fuser->FuseObjects(FuseDeltaTime);
+				Steps++;
+			}
+		});
+		TotalSteps += Steps;
+		if (Steps > 0 && Fuser->GetCurrentFuseState() == FSTATE_NONE) { Completed++; }
+		Release(Fuser);
+	}
+
+	TSharedRef<FJsonObject> Scenario = MakeShared<FJsonObject>();
+	Scenario->SetNumberField(TEXT("Links"), Settings.ChainLength - 1);
+	Scenario->SetNumberField(TEXT("Completed"), Completed);
+	Scenario->SetNumberField(TEXT("Failed"), Settings.ChainLength - 1 - Completed);
+	Scenario->SetNumberField(TEXT("FuseAvgSteps"), static_cast<double>(TotalSteps) / FMath::Max(1, Settings.ChainLength - 1));
+	Fuse.Write(*Scenario, TEXT("Fuse"));
+	return Scenario;
+}
+
+TSharedRef<FJsonObject> UFFuseBenchmarkCommandlet::RunDetachInAssembly(UWorld* World, UFFuseComponent* Fuser, TConstArrayView<UPrimitiveComponent*> Parts)
+{
+	using namespace FuseBenchmarkCommandlet;
+
+	// Detach from the far end of the chain back, so every detach is from the rest of a large assembly
+	FSampler Detach;
+	int32 Failed = 0;
+	for (int32 PartIndex = Parts.Num() - 1; PartIndex > 0; PartIndex--)
+	{
+		Grab(Fuser, Parts[PartIndex]);
+		bool bDetached = false;
+		Detach.Measure([&]() { bDetached = Fuser->TryDetachGrabbedComponent(); });
+		if (!bDetached) { Failed++; }
+		Release(Fuser);
+	}
+
+	TSharedRef<FJsonObject> Scenario = MakeShared<FJsonObject>();
+	Scenario->SetNumberField(TEXT("Parts"), Parts.Num());
+	Scenario->SetNumberField(TEXT("Failed"), Failed);
+	Detach.Write(*Scenario, TEXT("Detach"));
+
+	// The constraints were all broken by the detaches, only the parts and the constraint actors are left
+	for (TActorIterator<APhysicsConstraintActor> It(World); It; ++It)
+	{
+		const UPrimitiveComponent* AttachParent = Cast<UPrimitiveComponent>(It->GetConstraintComp()->GetAttachParent());
+		if (AttachParent && Parts.Contains(AttachParent)) { It->Destroy(); }
+	}
+	for (UPrimitiveComponent* Part : Parts) { Part->GetOwner()->Destroy(); }
+	return Scenario;
+}
+
+int32 UFFuseBenchmarkCommandlet::CompareWithBaseline(const TSharedRef<FJsonObject>& Results, const TSharedRef<FJsonObject>& Baseline, const bool bRequireTimings)
+{
+	const TSharedPtr<FJsonObject>* ResultScenarios = nullptr;
+	const TSharedPtr<FJsonObject>* BaselineScenarios = nullptr;
+	if (!Results->TryGetObjectField(TEXT("Scenarios"), ResultScenarios) || !Baseline->TryGetObjectField(TEXT("Scenarios"), BaselineScenarios))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Fuse benchmark baseline has no scenarios"));
+		return 1;
+	}
+
+	int32 Regressions = 0;
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& ResultScenario : (*ResultScenarios)->Values)
+	{
+		if (!(*BaselineScenarios)->HasField(ResultScenario.Key))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Fuse benchmark scenario %s isn't in the baseline, run with -UpdateBaseline to record it"), *ResultScenario.Key);
+			Regressions++;
+		}
+	}
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& BaselineScenario : (*BaselineScenarios)->Values)
+	{
+		const TSharedPtr<FJsonObject>* ResultScenario = nullptr;
+		if (!(*ResultScenarios)->TryGetObjectField(BaselineScenario.Key, ResultScenario))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Fuse benchmark scenario %s is in the baseline but wasn't run"), *BaselineScenario.Key);
+			Regressions++;
+			continue;
+		}
+
+		// A scenario that gates nothing would pass whatever it measured
+		const TMap<FString, TSharedPtr<FJsonValue>>& Metrics = BaselineScenario.Value->AsObject()->Values;
+		if (Metrics.Num() == 0)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Fuse benchmark scenario %s has no metrics in the baseline"), *BaselineScenario.Key);
+			Regressions++;
+			continue;
+		}
+		bool bGatesTime = false;
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& Metric : Metrics) { bGatesTime |= Metric.Key.EndsWith(TEXT("AvgMs")); }
+		if (!bGatesTime)
+		{
+			// Timings depend on the machine, so they're only in baselines recorded on the build machine
+			UE_LOG(LogTemp, Display, TEXT("Fuse benchmark scenario %s gates no timings"), *BaselineScenario.Key);
+			if (bRequireTimings)
+			{
+				UE_LOG(LogTemp, Error, TEXT("Fuse benchmark scenario %s has no timings in the baseline, -RequireTimings needs them"), *BaselineScenario.Key);
+				Regressions++;
+			}
+		}
+
+		// Each metric is { "Value", "Tolerance" relative to the value, "Slack" absolute }
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& Metric : Metrics)
+		{
+			const TSharedPtr<FJsonObject> Limits = Metric.Value->AsObject();
+			double Current = 0.0;
+			if (!Limits.IsValid() || !(*ResultScenario)->TryGetNumberField(Metric.Key, Current))
+			{
+				// A metric that's stopped being measured can't show a regression, so it counts as one
+				UE_LOG(LogTemp, Error, TEXT("Fuse benchmark metric %s.%s has no result to compare"), *BaselineScenario.Key, *Metric.Key);
+				Regressions++;
+				continue;
+			}
+			const double Value = Limits->GetNumberField(TEXT("Value"));
+			double Tolerance = 0.0;
+			double Slack = 0.0;
+			Limits->TryGetNumberField(TEXT("Tolerance"), Tolerance);
+			Limits->TryGetNumberField(TEXT("Slack"), Slack);
+
+			const double Limit = Value * (1.0 + Tolerance) + Slack;
+			if (Current > Limit)
+			{
+				UE_LOG(LogTemp, Error, TEXT("Fuse benchmark regression: %s.%s is %.4f, baseline %.4f (limit %.4f)"),
+				       *BaselineScenario.Key, *Metric.Key, Current, Value, Limit);
+				Regressions++;
+			}
+			else
+			{
+				UE_LOG(LogTemp, Display, TEXT("Fuse benchmark: %s.%s is %.4f, baseline %.4f"), *BaselineScenario.Key, *Metric.Key, Current, Value);
+			}
+		}
+	}
+	return Regressions;
+}
+
+TSharedRef<FJsonObject> UFFuseBenchmarkCommandlet::MakeBaseline(const TSharedRef<FJsonObject>& Results)
+{
+	TSharedRef<FJsonObject> BaselineScenarios = MakeShared<FJsonObject>();
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Scenario : Results->GetObjectField(TEXT("Scenarios"))->Values)
+	{
+		TSharedRef<FJsonObject> Metrics = MakeShared<FJsonObject>();
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& Metric : Scenario.Value->AsObject()->Values)
+		{
+			// Maximums are too noisy to gate on, and allocations, work and failures are the same on every run so should never go up
+			const bool bTime = Metric.Key.EndsWith(TEXT("AvgMs"));
+			if (!bTime && !Metric.Key.EndsWith(TEXT("PerCall")) && Metric.Key != TEXT("Failed")) { continue; }
+
+			TSharedRef<FJsonObject> Limits = MakeShared<FJsonObject>();
+			Limits->SetNumberField(TEXT("Value"), Metric.Value->AsNumber());
+			Limits->SetNumberField(TEXT("Tolerance"), bTime ? FuseBenchmarkCommandlet::TimeTolerance : 0.0);
+			Limits->SetNumberField(TEXT("Slack"), bTime ? FuseBenchmarkCommandlet::TimeSlackMs : 0.0);
+			Metrics->SetObjectField(Metric.Key, Limits);
+		}
+		BaselineScenarios->SetObjectField(Scenario.Key, Metrics);
+	}
+
+	TSharedRef<FJsonObject> Baseline = MakeShared<FJsonObject>();
+	Baseline->SetStringField(TEXT("Map"), Results->GetStringField(TEXT("Map")));
+	Baseline->SetStringField(TEXT("Recorded"), Results->GetStringField(TEXT("Timestamp")));
+	Baseline->SetObjectField(TEXT("Scenarios"), BaselineScenarios);
+	return Baseline;
+}
+#endif
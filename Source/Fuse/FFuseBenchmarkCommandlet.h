@@ -0,0 +1,61 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Dom/JsonObject.h"
+#include "FFuseBenchmarkCommandlet.generated.h"
+
+class UFFuseComponent;
+class UStaticMesh;
+
+/*
+ *
+ * Performance regression gate for the fuse code. Loads a map headlessly and runs a fixed set of fuse scenarios:
+ * searching in clutter, holding next to a large pile, fusing a long chain and detaching parts of the chained assembly.
+ * The timings, allocation, work and failure counts of each scenario are compared against a baseline with tolerances, and the
+ * commandlet returns 1 if anything regressed, a baselined metric is missing or a scenario has nothing to gate it.
+ * -UpdateBaseline writes the results as the new baseline instead, -RequireTimings also fails scenarios with no timings.
+ * UnrealEditor-Cmd Fuse.uproject -run=FFuseBenchmark [-Map=/Game/Fuse/L_Fuse_TestMap] [-Baseline=Config/FuseBenchmarkBaseline.json]
+ * [-Output=<file>] [-Iterations=50] [-Clutter=200] [-Pile=10] [-Chain=48] [-UpdateBaseline] [-RequireTimings]
+ *
+ */
+
+UCLASS()
+class UFFuseBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UFFuseBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	struct FScenarioSettings
+	{
+		int32 Iterations = 50;
+		int32 ClutterProps = 200;
+		// Side length of the cubic pile
+		int32 PileSize = 10;
+		int32 ChainLength = 48;
+		int32 Sockets = 8;
+		int32 Seed = 1;
+	};
+
+	static UWorld* LoadBenchmarkWorld(const FString& MapName);
+	static void DestroyBenchmarkWorld(UWorld* World);
+
+	static TSharedRef<FJsonObject> RunSearchInClutter(UWorld* World, UFFuseComponent* Fuser, UStaticMesh* Mesh, const FScenarioSettings& Settings);
+	static TSharedRef<FJsonObject> RunHoldNearPile(UWorld* World, UFFuseComponent* Fuser, UStaticMesh* Mesh, const FScenarioSettings& Settings);
+	// Leaves the chain's parts in OutParts for the detach scenario
+	static TSharedRef<FJsonObject> RunChainedFusing(UWorld* World, UFFuseComponent* Fuser, UStaticMesh* Mesh, const FScenarioSettings& Settings,
+	                                                TArray<UPrimitiveComponent*>& OutParts);
+	static TSharedRef<FJsonObject> RunDetachInAssembly(UWorld* World, UFFuseComponent* Fuser, TConstArrayView<UPrimitiveComponent*> Parts);
+
+	// Compare every metric in the baseline with the results, returns the number of regressions
+	static int32 CompareWithBaseline(const TSharedRef<FJsonObject>& Results, const TSharedRef<FJsonObject>& Baseline, bool bRequireTimings);
+
+	// Baseline of the stable metrics in the results, averages, allocation and work counts and failures
+	static TSharedRef<FJsonObject> MakeBaseline(const TSharedRef<FJsonObject>& Results);
+};
@@ -0,0 +1,256 @@
+
+#include "FFuseBotComponent.h"
+#include "FFuseComponent.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerStart.h"
+#include "Kismet/GameplayStatics.h"
+
+static FAutoConsoleCommandWithWorldAndArgs FuseBotsCommand(
+	TEXT("f.fusebots"),
+	TEXT("Spawn scripted fuse bots using the game mode default pawn. Args: <Count>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UFFuseBotComponent::SpawnBots(World, Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1);
+	}),
+	ECVF_Cheat);
+
+static FAutoConsoleCommand FuseBotStatsCommand(
+	TEXT("f.fusebotstats"),
+	TEXT("Log the combined grab and fuse throughput of every fuse bot"),
+	FConsoleCommandDelegate::CreateStatic(&UFFuseBotComponent::LogBotStats));
+
+namespace FuseBot
+{
+	// Totals across all bots, only touched on the game thread
+	static int32 ActiveBots = 0;
+	static int32 Grabs = 0;
+	static int32 FailedGrabs = 0;
+	static int32 Fuses = 0;
+	static int32 FailedFuses = 0;
+	static double FirstBotStartTime = 0.0;
+}
+
+UFFuseBotComponent::UFFuseBotComponent()
+{
+	// The bot only needs to make decisions a few times a second
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickInterval = 0.1f;
+}
+
+void UFFuseBotComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	FuseComponent = GetOwner()->FindComponentByClass<UFFuseComponent>();
+	if (!FuseComponent)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Fuse bot %s on %s has no fuse component to drive"), *GetName(), *GetOwner()->GetName());
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	if (!bDriveControlRotation) { FuseComponent->SetViewPointProvider(TScriptInterface<IFFuseViewPointProvider>(this)); }
+	if (bSuppressOrthographicProjection) { FuseComponent->OrthographicProjectionActor = nullptr; }
+	Stream.GenerateNewSeed();
+
+	if (FuseBot::ActiveBots++ == 0 && FuseBot::FirstBotStartTime == 0.0)
+	{
+		FuseBot::FirstBotStartTime = FPlatformTime::Seconds();
+	}
+}
+
+void UFFuseBotComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (FuseComponent) { FuseBot::ActiveBots--; }
+	Super::EndPlay(EndPlayReason);
+}
+
+void UFFuseBotComponent::GetFuseViewPoint(FVector& OutLocation, FRotator& OutRotation) const
+{
+	if (const APawn* OwningPawn = Cast<APawn>(GetOwner()))
+	{
+		OutLocation = OwningPawn->GetPawnViewLocation();
+	}
+	else
+	{
+		OutLocation = GetOwner()->GetActorLocation() + FVector(0.0f, 0.0f, ViewHeight);
+	}
+
+	OutRotation = AimTarget.IsValid()
+		? (AimTarget->GetComponentLocation() - OutLocation).Rotation()
+		: GetOwner()->GetActorRotation();
+}
+
+void UFFuseBotComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	PhaseTime += DeltaTime;
+	
+	if (bDriveControlRotation)
+	{
+		const APawn* OwningPawn = Cast<APawn>(GetOwner());
+		if (AController* Controller = OwningPawn ? OwningPawn->GetController() : nullptr)
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			GetFuseViewPoint(ViewLocation, ViewRotation);
+			Controller->SetControlRotation(ViewRotation);
+		}
+	}
+
+	switch (Phase)
+	{
+	case EFuseBotPhase::Idle:
+		// Wait for any fuse interp to finish before starting again
+		if (FuseComponent->GetCurrentFuseState() != FSTATE_NONE) { break; }
+		AimTarget = FindRandomFusable(nullptr);
+		if (AimTarget.IsValid() && FuseComponent->TryStartSearching()) { SetPhase(EFuseBotPhase::Seeking); }
+		break;
+
+	case EFuseBotPhase::Seeking:
+		// The fuse tick sweeps along the view each update, so keep trying to grab whatever it last found
+		if (FuseComponent->TryGrabTargetedFusable())
+		{
+			FuseBot::Grabs++;
+			AimTarget = FindRandomFusable(AimTarget.Get());
+			HoldTime = Stream.FRandRange(HoldTimeRange.X, HoldTimeRange.Y);
+			RotationsRemaining = RotationsPerHold;
+			SetPhase(EFuseBotPhase::Holding);
+		}
+		else if (PhaseTime > GrabTimeout || !AimTarget.IsValid())
+		{
+			FuseBot::FailedGrabs++;
+			FuseComponent->TryStopSearching();
+			SetPhase(EFuseBotPhase::Cooldown);
+		}
+		break;
+
+	case EFuseBotPhase::Holding:
+		// On clients the grab arrives from the server a round trip later
+		if (!FuseComponent->GetGrabbedComponent())
+		{
+			if (PhaseTime > GrabTimeout || FuseComponent->GetCurrentFuseState() == FSTATE_NONE)
+			{
+				FuseComponent->TryStopSearching();
+				SetPhase(EFuseBotPhase::Cooldown);
+			}
+			break;
+		}
+		SteerHeldFusable();
+
+		// Spread the rotation inputs over the hold time
+		if (RotationsRemaining > 0 && PhaseTime > HoldTime * (RotationsPerHold - RotationsRemaining + 1) / (RotationsPerHold + 1))
+		{
+			FuseComponent->AdjustGrabbedComponentTargetRotation(Stream.RandRange(-1, 1), Stream.RandRange(-1, 1));
+			RotationsRemaining--;
+		}
+		if (PhaseTime > HoldTime)
+		{
+			if (FuseComponent->TryFuseObjects()) { FuseBot::Fuses++; }
+			else { FuseBot::FailedFuses++; }
+			SetPhase(EFuseBotPhase::Cooldown);
+		}
+		break;
+
+	case EFuseBotPhase::Cooldown:
+		if (PhaseTime > CooldownTime && FuseComponent->GetCurrentFuseState() == FSTATE_NONE)
+		{
+			AimTarget.Reset();
+			SetPhase(EFuseBotPhase::Idle);
+		}
+		break;
+	}
+}
+
+void UFFuseBotComponent::SetPhase(const EFuseBotPhase NewPhase)
+{
+	Phase = NewPhase;
+	PhaseTime = 0.0f;
+}
+
+UPrimitiveComponent* UFFuseBotComponent::FindRandomFusable(const UPrimitiveComponent* IgnoredComponent) const
+{
+	TArray<FOverlapResult> OverlapResults;
+	FCollisionObjectQueryParams ObjectQueryParams;
+	ObjectQueryParams.AddObjectTypesToQuery(ECC_PhysicsBody);
+	FCollisionQueryParams CollisionParams;
+	CollisionParams.AddIgnoredActor(GetOwner());
+
+	GetWorld()->OverlapMultiByObjectType(OverlapResults, GetOwner()->GetActorLocation(), FQuat::Identity,
+	                                     ObjectQueryParams, FCollisionShape::MakeSphere(TargetSearchRadius), CollisionParams);
+
+	TArray<UPrimitiveComponent*, TInlineAllocator<32>> Candidates;
+	for (const FOverlapResult& OverlapResult : OverlapResults)
+	{
+		UPrimitiveComponent* Component = OverlapResult.GetComponent();
+		if (Component && Component != IgnoredComponent && FuseComponent->IsComponentFusable(Component))
+		{
+			Candidates.AddUnique(Component);
+		}
+	}
+	return Candidates.Num() > 0 ? Candidates[Stream.RandRange(0, Candidates.Num() - 1)] : nullptr;
+}
+
+void UFFuseBotComponent::SteerHeldFusable()
+{
+	const UPrimitiveComponent* HeldComponent = FuseComponent->GetGrabbedComponent();
+	if (!AimTarget.IsValid() || !HeldComponent) { return; }
+
+	// The held object follows the view yaw, so aiming at the partner lines it up, then ease the distance and
+	// height towards the side of the partner so the socket search can find a pair
+	const FVector OwnerLocation = GetOwner()->GetActorLocation();
+	const FVector PartnerLocation = AimTarget->GetComponentLocation();
+	const float SeparationRadius = (AimTarget->Bounds.SphereRadius + HeldComponent->Bounds.SphereRadius) * 0.75f;
+	const float DesiredDistance = FVector::Dist2D(OwnerLocation, PartnerLocation) - SeparationRadius;
+	FuseComponent->AdjustGrabbedComponentTargetDistance((DesiredDistance - FuseComponent->GetGrabbedComponentTargetDistance()) * 0.5f);
+	FuseComponent->AdjustGrabbedComponentTargetHeight((PartnerLocation.Z - HeldComponent->GetComponentLocation().Z) * 0.5f);
+}
+
+void UFFuseBotComponent::SpawnBots(UWorld* World, const int32 Count)
+{
+	const AGameModeBase* GameMode = World ? World->GetAuthGameMode() : nullptr;
+	if (!GameMode || !GameMode->DefaultPawnClass)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Fuse bots can only be spawned on the server, with a game mode that has a default pawn"));
+		return;
+	}
+
+	FVector Origin = FVector::ZeroVector;
+	if (const AActor* PlayerStart = UGameplayStatics::GetActorOfClass(World, APlayerStart::StaticClass()))
+	{
+		Origin = PlayerStart->GetActorLocation();
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	const float SpawnRadius = 200.0f * FMath::Sqrt(static_cast<float>(Count));
+	for (int32 BotIndex = 0; BotIndex < Count; BotIndex++)
+	{
+		const FVector Location = Origin + FVector(FMath::FRandRange(-SpawnRadius, SpawnRadius), FMath::FRandRange(-SpawnRadius, SpawnRadius), 0.0f);
+		APawn* Bot = World->SpawnActor<APawn>(GameMode->DefaultPawnClass, Location, FRotator(0.0f, FMath::FRandRange(0.0f, 360.0f), 0.0f), SpawnParams);
+		if (!Bot) { continue; }
+		Bot->SpawnDefaultController();
+
+		// Use the pawn's own fuse component if it has one, so bots match players
+		if (!Bot->FindComponentByClass<UFFuseComponent>())
+		{
+			UFFuseComponent* FuseComponent = NewObject<UFFuseComponent>(Bot);
+			Bot->AddInstanceComponent(FuseComponent);
+			FuseComponent->RegisterComponent();
+		}
+		UFFuseBotComponent* BotComponent = NewObject<UFFuseBotComponent>(Bot);
+		Bot->AddInstanceComponent(BotComponent);
+		BotComponent->RegisterComponent();
+	}
+	UE_LOG(LogTemp, Display, TEXT("Spawned %d fuse bots, %d active"), Count, FuseBot::ActiveBots);
+}
+
+void UFFuseBotComponent::LogBotStats()
+{
+	const double Minutes = FuseBot::FirstBotStartTime > 0.0 ? (FPlatformTime::Seconds() - FuseBot::FirstBotStartTime) / 60.0 : 0.0;
+	const double PerMinute = Minutes > 0.0 ? 1.0 / Minutes : 0.0;
+	UE_LOG(LogTemp, Display, TEXT("Fuse bots: %d active over %.1f minutes. Grabs %d (%.1f/min), failed grabs %d, fuses %d (%.1f/min), failed fuses %d"),
+	       FuseBot::ActiveBots, Minutes, FuseBot::Grabs, FuseBot::Grabs * PerMinute, FuseBot::FailedGrabs,
+	       FuseBot::Fuses, FuseBot::Fuses * PerMinute, FuseBot::FailedFuses);
+}
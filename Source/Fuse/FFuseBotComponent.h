@@ -0,0 +1,104 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "FFuseViewPointProvider.h"
+#include "FFuseBotComponent.generated.h"
+
+class UFFuseComponent;
+
+// Phases of the scripted bot loop
+UENUM()
+enum class EFuseBotPhase : uint8
+{
+	Idle,
+	Seeking,
+	Holding,
+	Cooldown
+};
+
+/*
+ *
+ * Scripted bot that drives a fuse component on the same actor, for headless load generation.
+ * Repeatedly picks a nearby fusable, aims at it until it can be grabbed, turns towards another fusable while rotating
+ * the held object, and then tries to fuse them. Provides the fuse component's view point, so it doesn't need a player.
+ * f.fusebots <Count> spawns bots, f.fusebotstats logs their combined throughput.
+ *
+ */
+
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class FUSE_API UFFuseBotComponent : public UActorComponent, public IFFuseViewPointProvider
+{
+	GENERATED_BODY()
+
+public:
+	UFFuseBotComponent();
+
+	virtual void GetFuseViewPoint(FVector& OutLocation, FRotator& OutRotation) const override;
+
+	// Radius around the owner to look for fusables in
+	UPROPERTY(EditAnywhere, Category = "Fuse Bot")
+	float TargetSearchRadius = 1500.0f;
+
+	// Time to try and grab a target before giving up on it
+	UPROPERTY(EditAnywhere, Category = "Fuse Bot")
+	float GrabTimeout = 3.0f;
+
+	// Min and max time to hold an object before fusing it
+	UPROPERTY(EditAnywhere, Category = "Fuse Bot")
+	FVector2D HoldTimeRange = FVector2D(1.5f, 4.0f);
+
+	// Number of rotation inputs while holding
+	UPROPERTY(EditAnywhere, Category = "Fuse Bot")
+	int32 RotationsPerHold = 3;
+
+	// Time to wait between fuse attempts
+	UPROPERTY(EditAnywhere, Category = "Fuse Bot")
+	float CooldownTime = 1.0f;
+
+	// Height of the view point above the owner, when the owner isn't a pawn
+	UPROPERTY(EditAnywhere, Category = "Fuse Bot")
+	float ViewHeight = 60.0f;
+
+	// Don't spawn orthographic projection actors for bots, as they aren't seen by anyone
+	UPROPERTY(EditAnywhere, Category = "Fuse Bot")
+	bool bSuppressOrthographicProjection = true;
+
+	// Aim by turning the owner's controller instead of providing the view point
+	// For bots driving a client's player, so the server sees the same aim through the replicated control rotation
+	UPROPERTY(EditAnywhere, Category = "Fuse Bot")
+	bool bDriveControlRotation = false;
+
+	// Spawn bots using the game mode default pawn, around the first player start
+	static void SpawnBots(UWorld* World, int32 Count);
+
+	// Combined throughput of every bot since the first one started
+	static void LogBotStats();
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	UPROPERTY()
+	UFFuseComponent* FuseComponent;
+
+	// The component currently being aimed at
+	TWeakObjectPtr<UPrimitiveComponent> AimTarget;
+
+	EFuseBotPhase Phase = EFuseBotPhase::Idle;
+	float PhaseTime = 0.0f;
+	float HoldTime = 0.0f;
+	int32 RotationsRemaining = 0;
+	FRandomStream Stream;
+
+	void SetPhase(EFuseBotPhase NewPhase);
+
+	// Pick a random fusable near the owner, that isn't the ignored component
+	UPrimitiveComponent* FindRandomFusable(const UPrimitiveComponent* IgnoredComponent) const;
+
+	// Steer the held object towards the fuse partner, through the fuse component's target adjustments
+	void SteerHeldFusable();
+};
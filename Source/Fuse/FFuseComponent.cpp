@@ -1,38 +1,100 @@
 
 #include "FFuseComponent.h"
+#include "FFuseAssemblyLODSubsystem.h"
+#include "FuseAssembly.h"
+#include "FuseStats.h"
+#include "FuseLatencyTracker.h"
+#include "FuseSocketTable.h"
+#include "FuseTargetTransforms.h"
+#include "FuseAllocationCounter.h"
+#include "FuseInstancedFusables.h"
+#include "FuseActorPool.h"
+#include "FuseDebugDraw.h"
+#include "Algo/Compare.h"
+#include "Algo/MaxElement.h"
 #include "PhysicsEngine/PhysicsConstraintComponent.h"
+#include "Net/UnrealNetwork.h"
+#include "Engine/NetConnection.h"
 
 
-static TAutoConsoleVariable<bool> CVarDrawDebugFuser(
-	TEXT("f.drawdebugfuser"), true, TEXT("Display debug information from a fuse component"), ECVF_Cheat);
+static TAutoConsoleVariable<bool> CVarFusePrefetch(
+	TEXT("f.fuseprefetch"), true, TEXT("Prepare the fuse data of the targeted fusable while searching, so grabbing it doesn't hitch"));
+
+static TAutoConsoleVariable<float> CVarFuseCandidateHysteresis(
+	TEXT("f.fusecandidates.hysteresis"), 5.0f, TEXT("Distance another fuse candidate has to be nearer by before it replaces the active one"));
+
+static TAutoConsoleVariable<float> CVarFuseCandidateRescoreDistance(
+	TEXT("f.fusecandidates.rescoredistance"), 10.0f, TEXT("Distance the held component can move before fuse candidates are searched for again rather than re-scored"));
+
+static TAutoConsoleVariable<bool> CVarFuseSocketPruning(
+	TEXT("f.fusesocketpruning"), true, TEXT("Skip socket pairs with incompatible types or polarity, or with normals facing the same way, before solving them"));
+
+// Normals are compared before the orientation snap turns the held component, so pairs are only pruned for facing
+// well within 45 degrees of the same way, not just in the same half
+static constexpr float FuseSocketPruningNormalDot = 0.7f;
+
+// Prefetched neighbours older than this are found again, other fusables may have moved into or out of range
+static constexpr double FusePrefetchMaxAge = 0.25;
+
+UFFuseComponent::UFFuseComponent()
+{
+	// Fusing is server authoritative, clients send intents and get the state, held component and fuses back
+	SetIsReplicatedByDefault(true);
+}
+
+void UFFuseComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(UFFuseComponent, CurrentFuserState);
+	DOREPLIFETIME_CONDITION(UFFuseComponent, HeldComponent, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(UFFuseComponent, HeldState, COND_OwnerOnly);
+	DOREPLIFETIME(UFFuseComponent, LastNetFuse);
+}
 
 void UFFuseComponent::BeginPlay()
 {
 	Super::BeginPlay();
+	
+	OrientationTable = &FFuseOrientationTable::Get(ComponentRotationMultiplier);
+	PendingHeldInputs.Reserve(MaxPendingHeldInputs);
 
-	// Set owning character controller reference, for getting the camera in SearchForFusable()
-	// If the owning character is not of type actor, do not start fuse tick
-	if (const APawn* OwningPawn = Cast<APawn>(GetOwner()))
+	// Use a view point provider on the owner if there is one, otherwise the view point of the owning pawn's controller
+	// Any controller will do, so AI controlled pawns can fuse too
+	if (!ViewPointProvider)
 	{
-		OwningCharacterController = Cast<APlayerController>(OwningPawn->GetController());
+		if (GetOwner()->Implements<UFFuseViewPointProvider>())
+		{
+			ViewPointProvider = TScriptInterface<IFFuseViewPointProvider>(GetOwner());
+		}
+		else
+		{
+			for (UActorComponent* Component : GetOwner()->GetComponents())
+			{
+				if (Component && Component->Implements<UFFuseViewPointProvider>())
+				{
+					ViewPointProvider = TScriptInterface<IFFuseViewPointProvider>(Component);
+					break;
+				}
+			}
+		}
 	}
+	ResolveOwningController();
 	
-	if (OwningCharacterController == nullptr)
+	// Pawns may be possessed after begin play, so only give up if the owner can never have a controller
+	if (!ViewPointProvider && !Cast<APawn>(GetOwner()))
 	{
-		UE_LOG(LogTemp, Error, TEXT("Owner %s of fuse component %s does not have a valid character controller"),
+		UE_LOG(LogTemp, Error, TEXT("Owner %s of fuse component %s is not a pawn and has no fuse view point provider"),
 		       *GetOwner()->GetName(), *this->GetName());
 		return;
 	}
 	
-	// Start looping timer for updating fuse functions
-	GetWorld()->GetTimerManager().SetTimer(FuseTickTimerHandle, this, &UFFuseComponent::FuseTick,
-	                                       1.0f / ComponentUpdateRate, true);
+	StartFuseTick();
 }
 
 void UFFuseComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-	if (CurrentFuserState == FSTATE_ACTIVEFUSING)
+	if (CurrentFuserState == FSTATE_ACTIVEFUSING && GetOwnerRole() == ROLE_Authority)
 	{
 		FuseObjects(DeltaTime);
 	}
@@ -40,11 +102,27 @@ void UFFuseComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActor
 
 void UFFuseComponent::ReleaseComponent()
 {
-	GetGrabbedComponent()->SetRenderCustomDepth(false);
-	GetGrabbedComponent()->SetReceivesDecals(true);
-	GetGrabbedComponent()->SetCustomPrimitiveDataFloat(0, 0.0f);
+	if (IsLocalFuser()) { UpdateHeldVisuals(GetGrabbedComponent(), false); }
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		if (HeldComponent && !IsLocalFuser()) { SetClientPredictsHeldComponent(HeldComponent, false); }
+		HeldComponent = nullptr;
+	}
+	
+	if (GetGrabbedComponent() && FFuseEventJournal::IsEnabled())
+	{
+		FFuseJournalEntry Entry = MakeJournalEntry(EFuseJournalEvent::Release);
+		Entry.Duration = static_cast<float>(GetWorld()->GetTimeSeconds() - GrabTime);
+		FFuseEventJournal::Record(this, Entry);
+	}
 	
-	if (LastSpawnedOrthoProjectionActor) { LastSpawnedOrthoProjectionActor->Destroy(); }
+	// Inputs that never reached the physics handle target aren't a latency sample
+	LatencyMarks.Clear(EFuseLatencyEvent::Rotate);
+	LatencyMarks.Clear(EFuseLatencyEvent::Distance);
+	LatencyMarks.Clear(EFuseLatencyEvent::Height);
+	FuseCandidates.Reset();
+	if (HeldAssembly.bWelded) { UnweldAssembly(HeldAssembly); }
+	HeldAssembly = FWeldedAssembly();
 	
 	Super::ReleaseComponent();
 }
@@ -55,21 +133,67 @@ bool UFFuseComponent::UpdateFuserState(EFuserState NewState)
 	{
 		const EFuserState PreviousState = GetCurrentFuseState();
 		CurrentFuserState = NewState;
+		if (FFuseEventJournal::IsEnabled())
+		{
+			FFuseJournalEntry Entry = MakeJournalEntry(EFuseJournalEvent::StateChanged);
+			Entry.PreviousState = static_cast<uint8>(PreviousState);
+			FFuseEventJournal::Record(this, Entry);
+		}
 		OnFuserStateChanged.Broadcast(GetCurrentFuseState(), PreviousState);
 		return true;
 	}
 	return false;
 }
 
+void UFFuseComponent::StartFuseTick()
+{
+	// Start looping timer for updating fuse functions
+	if (!FuseTickTimerHandle.IsValid())
+	{
+		GetWorld()->GetTimerManager().SetTimer(FuseTickTimerHandle, this, &UFFuseComponent::FuseTick,
+		                                       1.0f / ComponentUpdateRate, true);
+	}
+}
+
+void UFFuseComponent::SetViewPointProvider(TScriptInterface<IFFuseViewPointProvider> NewViewPointProvider)
+{
+	ViewPointProvider = NewViewPointProvider;
+	if (HasBegunPlay() && ViewPointProvider) { StartFuseTick(); }
+}
+
 void UFFuseComponent::FuseTick()
 {
+	FUSE_SCOPE_CYCLE_COUNTER(FuseTick);
+	FUSE_SCOPE_ALLOCATION_COUNTER();
+	// Scope per fuser so Insights can split the tick cost between owners
+	SCOPE_CYCLE_UOBJECT(FuseComponent, this);
+	
+	// Other players' fusers are driven by their own client and the server
+	if (!IsLocalFuser() && GetOwnerRole() != ROLE_Authority) { return; }
+	
+	// Nothing to search or hold from until the owner has a view point
+	if (!ViewPointProvider && !OwningController && !ResolveOwningController()) { return; }
+	
 	switch (GetCurrentFuseState())
 	{
 	case FSTATE_SEARCHING:
-		SearchForFusable();
+		// The server only searches for a remote client when it asks to grab something
+		if (IsLocalFuser())
+		{
+			SearchForFusable();
+			PrefetchTargetedFusable();
+		}
 		break;
 	case FSTATE_FUSING:
-		UpdateHeldFusable();
+		// The server moves held components, and the client holding one predicts it locally once the grab arrives
+		if (GetOwnerRole() == ROLE_Authority || GetGrabbedComponent())
+		{
+			UpdateHeldFusable();
+		}
+		else
+		{
+			UpdateOrthoProjectionActor();
+		}
 		break;
 	default:
 		break;
@@ -80,6 +204,8 @@ bool UFFuseComponent::TryStartSearching()
 {
 	if (CurrentFuserState == FSTATE_NONE)
 	{
+		// Clients search locally to find something to ask the server to grab
+		if (GetOwnerRole() != ROLE_Authority) { ServerTryStartSearching(); }
 		UpdateFuserState(FSTATE_SEARCHING);
 		return true;
 	}
@@ -89,6 +215,7 @@ bool UFFuseComponent::TryStartSearching()
 bool UFFuseComponent::TryStopSearching()
 {
 	if (CurrentFuserState == FSTATE_NONE) { return false; }
+	if (GetOwnerRole() != ROLE_Authority) { ServerTryStopSearching(); }
 	if (GetGrabbedComponent()) { ReleaseComponent(); }
 	UpdateFuserState(FSTATE_NONE);
 	return true;
@@ -96,9 +223,11 @@ bool UFFuseComponent::TryStopSearching()
 
 void UFFuseComponent::SearchForFusable()
 {
+	FUSE_SCOPE_CYCLE_COUNTER(SearchForFusable);
+	
 	FVector CameraLoc;
 	FRotator CameraRot;
-	OwningCharacterController->GetPlayerViewPoint(CameraLoc, CameraRot);
+	GetFuseViewPoint(CameraLoc, CameraRot);
 	
     FCollisionObjectQueryParams ObjectQueryParams;
     FCollisionQueryParams CollisionParams;
@@ -117,93 +246,403 @@ void UFFuseComponent::SearchForFusable()
 			CollisionShape,
 			CollisionParams);
 	
+	// The instance index is only good until another instance is promoted, the transform finds it again
+	if (!bTraceResult || !FFuseInstancedFusables::GetFusableTransform(LastSearchHitResult.GetComponent(), LastSearchHitResult.Item, LastSearchInstanceTransform))
+	{
+		LastSearchInstanceTransform = FTransform::Identity;
+	}
+	
 	// Draw debug info if debug is enabled
-	if (CVarDrawDebugFuser.GetValueOnGameThread())
+	if (FFuseDebugDraw::IsEnabled())
 	{
-		DrawDebugLine(GetWorld(), CameraLoc, LastSearchHitResult.TraceEnd, FColor::Silver, false, GetDeltaFuseTickTime());
-		if (bTraceResult && IsComponentFusable(LastSearchHitResult))
+		FFuseDebugDraw::Line(this, CameraLoc, LastSearchHitResult.TraceEnd, FColor::Silver, GetDeltaFuseTickTime());
+		if (bTraceResult && IsComponentFusable(LastSearchHitResult.GetComponent()))
 		{
-			DrawDebugSphere(GetWorld(), LastSearchHitResult.Location, 10.0f, 8, FColor::Green, false, GetDeltaFuseTickTime());
+			FFuseDebugDraw::Sphere(this, LastSearchHitResult.Location, 10.0f, 8, FColor::Green, GetDeltaFuseTickTime());
 		}
 	}
 }
 
-bool UFFuseComponent::IsComponentFusable(FHitResult InHitResult)
+void UFFuseComponent::PrefetchTargetedFusable()
 {
-	if (InHitResult.Component.IsValid())
+	FUSE_SCOPE_CYCLE_COUNTER(PrefetchTargetedFusable);
+	
+	// Checking it's fusable builds its socket table if this mesh hasn't been seen yet
+	UPrimitiveComponent* Component = LastSearchHitResult.GetComponent();
+	if (!CVarFusePrefetch.GetValueOnGameThread() || !IsComponentFusable(Component))
 	{
-		for (FName SocketName : InHitResult.Component->GetAllSocketNames())
-        {
-        	if (SocketName.ToString().Contains("Attach")) { return true; }
-        }
+		TargetPrefetch.Component.Reset();
+		return;
 	}
-	return false;
+	
+	SnapLocalOrientation(Component);
+	
+	// Reserve a projection actor, so the grab doesn't construct one and its captures and decals
+	if (OrthographicProjectionActor && !LastSpawnedOrthoProjectionActor && FFuseActorPool::NumPooled(GetWorld(), OrthographicProjectionActor) == 0)
+	{
+		FFuseActorPool::Prewarm(GetWorld(), OrthographicProjectionActor, 1);
+	}
+	
+	// Find the neighbours for the first fuse preview, instances are skipped since grabbing them promotes a new component
+	if (FFuseInstancedFusables::IsInstanced(Component)) { return; }
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (TargetPrefetch.Component == Component && Now - TargetPrefetch.Time < FusePrefetchMaxAge
+	    && TargetPrefetch.Transform.Equals(Component->GetComponentTransform(), 1.0f))
+	{
+		return;
+	}
+	TargetPrefetch.Component = Component;
+	TargetPrefetch.Transform = Component->GetComponentTransform();
+	TargetPrefetch.Time = Now;
+	TargetPrefetch.NeighbourRadius = Component->GetLocalBounds().SphereRadius + MaxFuseDistance;
+	FindNeighbourHits(Component->GetComponentLocation(), TargetPrefetch.NeighbourRadius, Component, TargetPrefetch.NeighbourHits);
+}
+
+bool UFFuseComponent::TryUsePrefetchedNeighbours(const UPrimitiveComponent* Component, const float Radius)
+{
+	if (!Component || TargetPrefetch.Component != Component || TargetPrefetch.NeighbourRadius < Radius
+	    || GetWorld()->GetTimeSeconds() - TargetPrefetch.Time >= FusePrefetchMaxAge
+	    || !TargetPrefetch.Transform.Equals(Component->GetComponentTransform(), 1.0f))
+	{
+		return false;
+	}
+	
+	// Only used once, the component is held from here on and moves away from where they were found
+	ScratchHitResults = TargetPrefetch.NeighbourHits;
+	TargetPrefetch.Component.Reset();
+	FUSE_INC_COUNTER(PrefetchHits, 1);
+	return true;
+}
+
+uint16 UFFuseComponent::SnapLocalOrientation(const UPrimitiveComponent* Component)
+{
+	const FQuat LocalRotation = FQuat(GetOwnerControlRotationYaw()).Inverse() * Component->GetComponentQuat();
+	if (!TargetPrefetch.bHasLocalOrientation || !TargetPrefetch.LocalRotation.Equals(LocalRotation, KINDA_SMALL_NUMBER))
+	{
+		TargetPrefetch.LocalRotation = LocalRotation;
+		TargetPrefetch.LocalOrientation = GetOrientationTable().Snap(LocalRotation);
+		TargetPrefetch.bHasLocalOrientation = true;
+	}
+	return TargetPrefetch.LocalOrientation;
+}
+
+bool UFFuseComponent::IsComponentFusable(const UPrimitiveComponent* Component) const
+{
+	return Component && !FFuseSocketTable::Get(Component, FusableSocketSubName).IsEmpty();
+}
+
+bool UFFuseComponent::IsComponentInUse(const UPrimitiveComponent* Component) const
+{
+	if (!Component) { return false; }
+	if (Component == GetGrabbedComponent() || Component == HeldComponent || HeldAssembly.Find(Component) != INDEX_NONE) { return true; }
+	return CurrentFuserState == FSTATE_ACTIVEFUSING &&
+	       (Component == LastFuseOperation.SourceComponent.Get() || Component == LastFuseOperation.TargetComponent.Get()
+	        || FusingAssembly.Find(Component) != INDEX_NONE);
+}
+
+void UFFuseComponent::GetComponentsInUse(TArray<UPrimitiveComponent*>& OutComponents) const
+{
+	OutComponents.Reset();
+	if (GetGrabbedComponent()) { OutComponents.Add(GetGrabbedComponent()); }
+	if (HeldComponent) { OutComponents.AddUnique(HeldComponent); }
+	for (const TWeakObjectPtr<UPrimitiveComponent>& Part : HeldAssembly.Parts)
+	{
+		if (Part.IsValid()) { OutComponents.AddUnique(Part.Get()); }
+	}
+	if (CurrentFuserState != FSTATE_ACTIVEFUSING) { return; }
+	if (LastFuseOperation.SourceComponent.IsValid()) { OutComponents.AddUnique(LastFuseOperation.SourceComponent.Get()); }
+	if (LastFuseOperation.TargetComponent.IsValid()) { OutComponents.AddUnique(LastFuseOperation.TargetComponent.Get()); }
+	for (const TWeakObjectPtr<UPrimitiveComponent>& Part : FusingAssembly.Parts)
+	{
+		if (Part.IsValid()) { OutComponents.AddUnique(Part.Get()); }
+	}
+}
+
+void UFFuseComponent::AbortFuse()
+{
+	if (GetOwnerRole() != ROLE_Authority) { return; }
+	if (CurrentFuserState == FSTATE_ACTIVEFUSING)
+	{
+		// The fuse constraint only holds the parts together once the fuse ends, so they're left to fall where they are
+		if (LastSpawnedConstraintActor) { LastSpawnedConstraintActor->Destroy(); }
+		LastSpawnedConstraintActor = nullptr;
+		UPrimitiveComponent* SourceComponent = LastFuseOperation.SourceComponent.Get();
+		UPrimitiveComponent* MovedComponent = FusingAssembly.Find(SourceComponent) > 0 ? FusingAssembly.Parts[0].Get() : SourceComponent;
+		if (FusingAssembly.IsValid()) { UnweldAssembly(FusingAssembly); }
+		if (MovedComponent) { MovedComponent->SetSimulatePhysics(true); }
+		// FuseObjects only turns the target's physics off once the interp has run too long
+		UPrimitiveComponent* TargetComponent = LastFuseOperation.TargetComponent.Get();
+		if (TargetComponent && FuseOperationTime > FuseInterpOperationMaxTime) { TargetComponent->SetSimulatePhysics(true); }
+		FuseOperationTime = 0.0f;
+		ClearFuseOperationData();
+		LatencyMarks.Clear(EFuseLatencyEvent::Fuse);
+	}
+	else if (GetGrabbedComponent())
+	{
+		ReleaseComponent();
+	}
+	UpdateFuserState(FSTATE_NONE);
 }
 
 bool UFFuseComponent::TryGrabTargetedFusable()
 {
 	// Early return if there is no hit component, or we already have a component grabbed
-	if (GetGrabbedComponent() || !IsComponentFusable(LastSearchHitResult)) { return false; }
+	if (GetGrabbedComponent() || !IsComponentFusable(LastSearchHitResult.GetComponent())) { return false; }
+	
+	// Clients only ask, the grab happens when the server's held component and state replicate back
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		if (CurrentFuserState != FSTATE_SEARCHING || HeldComponent) { return false; }
+		ServerTryGrabTargetedFusable(LastSearchHitResult.GetComponent());
+		return true;
+	}
+
+	// Instanced fusables become real components when they're grabbed
+	if (FFuseInstancedFusables::IsInstanced(LastSearchHitResult.GetComponent()))
+	{
+		UPrimitiveComponent* PromotedComponent = FFuseInstancedFusables::Promote(
+			Cast<UInstancedStaticMeshComponent>(LastSearchHitResult.GetComponent()), LastSearchHitResult.Item, LastSearchInstanceTransform);
+		if (!PromotedComponent) { return false; }
+		LastSearchHitResult.Component = PromotedComponent;
+		LastSearchHitResult.Item = INDEX_NONE;
+	}
+
+	// A part of a frozen assembly has to be simulating again before it can be held
+	if (UFFuseAssemblyLODSubsystem* AssemblyLOD = GetWorld()->GetSubsystem<UFFuseAssemblyLODSubsystem>())
+	{
+		AssemblyLOD->WakeAssembly(LastSearchHitResult.GetComponent());
+	}
+	// The rest of its assembly is welded on before the grab, so the handle holds the whole assembly's body
+	if (bGrabWholeAssemblies) { TryWeldHeldAssembly(LastSearchHitResult.GetComponent()); }
+	InitHeldTargets(LastSearchHitResult.GetComponent());
+	GrabComponentAtLocationWithRotation(LastSearchHitResult.GetComponent(), "None",
+	                                    LastSearchHitResult.GetComponent()->GetComponentLocation(),
+	                                    LastSearchHitResult.GetComponent()->GetComponentRotation());
+	UpdateFuserState(FSTATE_FUSING);
+	HeldComponent = GetGrabbedComponent();
+	GrabTime = GetWorld()->GetTimeSeconds();
+	if (FFuseEventJournal::IsEnabled()) { FFuseEventJournal::Record(this, MakeJournalEntry(EFuseJournalEvent::Grab)); }
+	if (IsLocalFuser())
+	{
+		UpdateHeldVisuals(HeldComponent, true);
+		// Show the first fuse preview on the grab frame, from the neighbours found while it was targeted
+		ClearFuseOperationData();
+		TryFindIdealFuseSockets(LastFuseOperation);
+		OwnerCameraRotCached = GetOwnerControlRotation();
+	}
+	else
+	{
+		// Input sequences count from the grab on both sides, see OnRep_HeldComponent
+		HeldState.GrabId++;
+		HeldState.InputSequence = 0;
+		HeldState.AssemblyParts.Reset();
+		for (const TWeakObjectPtr<UPrimitiveComponent>& Part : HeldAssembly.Parts) { HeldState.AssemblyParts.Add(Part.Get()); }
+		SetClientPredictsHeldComponent(HeldComponent, true);
+		UpdateHeldState();
+	}
+	
+	return true;
+}
+
+bool UFFuseComponent::TryWeldHeldAssembly(UPrimitiveComponent* Component)
+{
+	FFuseAssemblyComponents Assembly;
+	if (!FFuseAssemblySerializer::FindAssembly(GetWorld(), FusableSocketSubName, Component, Assembly)) { return false; }
+	
+	// Only whole simulating actors are welded, as the assembly LOD does, and none another fuser is using
+	TArray<const UFFuseComponent*, TInlineAllocator<16>> OtherFusers;
+	for (TObjectIterator<UFFuseComponent> It; It; ++It)
+	{
+		if (*It != this && It->GetWorld() == GetWorld()) { OtherFusers.Add(*It); }
+	}
+	for (const UPrimitiveComponent* Part : Assembly.Parts)
+	{
+		if (!Part->IsSimulatingPhysics() || Part->GetAttachParent() || Part != Part->GetOwner()->GetRootComponent()) { return false; }
+		for (const UFFuseComponent* Fuser : OtherFusers)
+		{
+			if (Fuser->IsComponentInUse(Part)) { return false; }
+		}
+	}
+	
+	HeldAssembly.Parts.Add(Component);
+	for (UPrimitiveComponent* Part : Assembly.Parts)
+	{
+		if (Part != Component) { HeldAssembly.Parts.Add(Part); }
+	}
+	
+	// The joints go first, welded parts can't pull against each other
+	for (UPhysicsConstraintComponent* Joint : Assembly.Joints)
+	{
+		Joint->ConstraintInstance.TermConstraint();
+		HeldAssembly.Joints.Add(Joint);
+	}
+	
+	// Found once on the grab, the parts don't move relative to each other while they're welded
+	FindFreeSockets(HeldAssembly);
+	HeldAssembly.bWelded = true;
+	
+	for (int32 PartIndex = 1; PartIndex < HeldAssembly.Parts.Num(); PartIndex++)
+	{
+		// Welding moves the part's shapes into the grabbed part's body, so the whole assembly is one body in the solver
+		HeldAssembly.Parts[PartIndex]->AttachToComponent(Component, FAttachmentTransformRules(EAttachmentRule::KeepWorld, true));
+	}
+	return true;
+}
+
+void UFFuseComponent::FindFreeSockets(FWeldedAssembly& Assembly) const
+{
+	// Sockets that meet a socket of another part are already joined, the rest are the assembly's source sockets
+	Assembly.FreeSockets.SetNum(Assembly.Parts.Num());
+	for (int32 PartIndex = 0; PartIndex < Assembly.Parts.Num(); PartIndex++)
+	{
+		const UPrimitiveComponent* Part = Assembly.Parts[PartIndex].Get();
+		const FFuseSocketTable& Sockets = FFuseSocketTable::Get(Part, FusableSocketSubName);
+		TBitArray<>& FreeSockets = Assembly.FreeSockets[PartIndex];
+		FreeSockets.Init(true, Sockets.Num());
+		if (!Part) { continue; }
+		const FBox PartBounds = Part->Bounds.GetBox().ExpandBy(5.0f);
+		for (int32 OtherIndex = 0; OtherIndex < Assembly.Parts.Num(); OtherIndex++)
+		{
+			const UPrimitiveComponent* OtherPart = Assembly.Parts[OtherIndex].Get();
+			if (OtherIndex == PartIndex || !OtherPart || !PartBounds.Intersect(OtherPart->Bounds.GetBox())) { continue; }
+			const FFuseSocketTable& OtherSockets = FFuseSocketTable::Get(OtherPart, FusableSocketSubName);
+			for (int32 SocketIndex = 0; SocketIndex < Sockets.Num(); SocketIndex++)
+			{
+				const FVector SocketLocation = Sockets.GetSocketLocation(SocketIndex, Part->GetComponentTransform());
+				for (int32 OtherSocketIndex = 0; OtherSocketIndex < OtherSockets.Num(); OtherSocketIndex++)
+				{
+					// As close as supplemental pairs are
+					if (OtherSockets.GetSocketLocation(OtherSocketIndex, OtherPart->GetComponentTransform()).Equals(SocketLocation, 5.0f))
+					{
+						FreeSockets[SocketIndex] = false;
+						break;
+					}
+				}
+			}
+		}
+	}
+}
+
+void UFFuseComponent::SyncHeldAssembly()
+{
+	if (GetOwnerRole() == ROLE_Authority) { return; }
+	const TArray<UPrimitiveComponent*>& Parts = HeldState.AssemblyParts;
+	const bool bSame = Algo::Compare(Parts, HeldAssembly.Parts,
+		[](const UPrimitiveComponent* Part, const TWeakObjectPtr<UPrimitiveComponent>& HeldPart) { return HeldPart == Part; });
+	if (bSame) { return; }
+	
+	// The server welded the parts onto the grabbed part, and their attachment replicates, so they move with the prediction
+	HeldAssembly = FWeldedAssembly();
+	if (Parts.Num() < 2 || Parts[0] != GetGrabbedComponent()) { return; }
+	for (UPrimitiveComponent* Part : Parts) { HeldAssembly.Parts.Add(Part); }
+	FindFreeSockets(HeldAssembly);
+	FuseCandidates.Reset();
+}
 
+void UFFuseComponent::UnweldAssembly(FWeldedAssembly& Assembly)
+{
+	UPrimitiveComponent* WeldedInto = Assembly.Parts[0].Get();
+	for (int32 PartIndex = 0; PartIndex < Assembly.Parts.Num(); PartIndex++)
+	{
+		UPrimitiveComponent* Part = Assembly.Parts[PartIndex].Get();
+		if (!Part) { continue; }
+		// Detaching unwelds the part back into its own body, which carries on moving as the assembly was
+		if (PartIndex > 0) { Part->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform); }
+		Part->SetSimulatePhysics(true);
+		if (PartIndex > 0 && WeldedInto)
+		{
+			Part->SetPhysicsLinearVelocity(WeldedInto->GetPhysicsLinearVelocityAtPoint(Part->GetComponentLocation()));
+			Part->SetPhysicsAngularVelocityInRadians(WeldedInto->GetPhysicsAngularVelocityInRadians());
+		}
+	}
+	for (const TWeakObjectPtr<UPhysicsConstraintComponent>& Joint : Assembly.Joints)
+	{
+		if (Joint.IsValid()) { Joint->InitComponentConstraint(); }
+	}
+	Assembly = FWeldedAssembly();
+}
+
+void UFFuseComponent::IgnoreHeldAssembly(FComponentQueryParams& QueryParams) const
+{
+	for (const TWeakObjectPtr<UPrimitiveComponent>& Part : HeldAssembly.Parts)
+	{
+		if (Part.IsValid()) { QueryParams.AddIgnoredComponent(Part.Get()); }
+	}
+}
+
+void UFFuseComponent::InitHeldTargets(const UPrimitiveComponent* Component)
+{
 	// Find the target location distance (modified by the inverse of the params that drive the target distance in UpdateHeldFusable())
 	FVector CameraLocation;
 	FRotator CameraRotation;
-	OwningCharacterController->GetPlayerViewPoint(CameraLocation, CameraRotation);
+	GetFuseViewPoint(CameraLocation, CameraRotation);
 	FVector OwnerXYLocation = GetOwner()->GetActorLocation();
 	const float OwnerZHeight = OwnerXYLocation.Z;
 	OwnerXYLocation.Z = 0.0f;
 	FVector CameraXYLocation = CameraLocation;
 	CameraXYLocation.Z = 0.0f;
-	FVector ComponentXYLocation = LastSearchHitResult.Component->GetComponentLocation();
+	FVector ComponentXYLocation = Component->GetComponentLocation();
 	const float ComponentZHeight = ComponentXYLocation.Z;
 	ComponentXYLocation.Z = 0.0f;
 	GrabbedComponentTargetDistance = FVector::Distance(CameraXYLocation, ComponentXYLocation) - FVector::Distance(OwnerXYLocation, CameraXYLocation);
 	GrabbedComponentTargetHeight = ComponentZHeight - OwnerZHeight;
 	
-	// Derive target local quaternion from world rotation, rounded to nearest ComponentRotationMultiplier
-	GrabbedComponentLocalTargetRotator = RoundRotatorToNearestMultiple(InverseRotateRotator(GetOwnerControlRotationYaw(), LastSearchHitResult.Component->GetComponentRotation()), ComponentRotationMultiplier);
-	
-	GrabComponentAtLocationWithRotation(LastSearchHitResult.GetComponent(), "None",
-	                                    LastSearchHitResult.GetComponent()->GetComponentLocation(),
-	                                    LastSearchHitResult.GetComponent()->GetComponentRotation());
-	UpdateFuserState(FSTATE_FUSING);
-
-	GetGrabbedComponent()->SetRenderCustomDepth(true);
-	GetGrabbedComponent()->SetCustomDepthStencilValue(1);
-	GetGrabbedComponent()->SetCustomPrimitiveDataFloat(0, 1.0f);
-	if (OrthographicProjectionActor)
-	{
-		LastSpawnedOrthoProjectionActor = GetWorld()->SpawnActor<AActor>(OrthographicProjectionActor, GetGrabbedComponent()->GetComponentLocation(), GetOwnerControlRotationYaw());
-		GetGrabbedComponent()->SetReceivesDecals(false);
-	}
-	
-	return true;
+	// Derive target local orientation from world rotation, snapped to the nearest orientation reachable with ComponentRotationMultiplier
+	// Usually already snapped while the component was targeted
+	GrabbedComponentLocalOrientation = SnapLocalOrientation(Component);
+	GrabbedComponentLocalRotation = GetOrientationTable().GetQuat(GrabbedComponentLocalOrientation);
 }
 
 void UFFuseComponent::AdjustGrabbedComponentTargetDistance(float Delta)
 {
-	const float NewTargetDistance = GrabbedComponentTargetDistance + Delta;
-	GrabbedComponentTargetDistance = FMath::Clamp(NewTargetDistance, MinGrabbedComponentTargetDistance, MaxGrabbedComponentTargetDistance);
+	if (GetGrabbedComponent()) { LatencyMarks.Mark(EFuseLatencyEvent::Distance); }
+	const FFuseHeldInput Input(EFuseHeldInputType::Distance, Delta);
+	ApplyHeldInput(Input);
+	if (GetOwnerRole() != ROLE_Authority) { SendHeldInput(Input); }
 }
 
 void UFFuseComponent::AdjustGrabbedComponentTargetRotation(float YawInput, float PitchInput)
 {
-	YawInput *= ComponentRotationMultiplier;
-	PitchInput *= ComponentRotationMultiplier;
-	
-	FQuat NewRelativeQuat = FQuat(FRotator(PitchInput, YawInput, 0.0f));
+	if (GetGrabbedComponent()) { LatencyMarks.Mark(EFuseLatencyEvent::Rotate); }
 	
-	GrabbedComponentLocalTargetRotator = FRotator(NewRelativeQuat * FQuat(GrabbedComponentLocalTargetRotator));
+	const FFuseHeldInput Input(EFuseHeldInputType::Rotation, YawInput, PitchInput);
+	ApplyHeldInput(Input);
+	if (GetOwnerRole() != ROLE_Authority) { SendHeldInput(Input); }
 }
 
 void UFFuseComponent::AdjustGrabbedComponentTargetHeight(float Delta)
 {
-	// This doesn't need to be clamped as it's being naturally clamped in UpdateHeldFusable()
-	GrabbedComponentTargetHeight += Delta;
+	if (GetGrabbedComponent()) { LatencyMarks.Mark(EFuseLatencyEvent::Height); }
+	const FFuseHeldInput Input(EFuseHeldInputType::Height, Delta);
+	ApplyHeldInput(Input);
+	if (GetOwnerRole() != ROLE_Authority) { SendHeldInput(Input); }
+}
+
+void UFFuseComponent::ApplyHeldInput(const FFuseHeldInput& Input)
+{
+	switch (Input.Type)
+	{
+	case EFuseHeldInputType::Distance:
+		GrabbedComponentTargetDistance = FMath::Clamp(GrabbedComponentTargetDistance + Input.X, MinGrabbedComponentTargetDistance, MaxGrabbedComponentTargetDistance);
+		break;
+	case EFuseHeldInputType::Rotation:
+		{
+			const FQuat InputRotation(FRotator(Input.Y * ComponentRotationMultiplier, Input.X * ComponentRotationMultiplier, 0.0f));
+			GrabbedComponentLocalRotation = InputRotation * GrabbedComponentLocalRotation;
+			GrabbedComponentLocalOrientation = GetOrientationTable().Snap(GrabbedComponentLocalRotation);
+		}
+		break;
+	case EFuseHeldInputType::Height:
+		// This doesn't need to be clamped as it's being naturally clamped in UpdateHeldFusable()
+		GrabbedComponentTargetHeight += Input.X;
+		break;
+	}
 }
 
 void UFFuseComponent::UpdateHeldFusable()
 {
+	FUSE_SCOPE_CYCLE_COUNTER(UpdateHeldFusable);
+	
 	if (!GetGrabbedComponent()) { return; }
 
 	/* Target location */
@@ -217,7 +656,7 @@ void UFFuseComponent::UpdateHeldFusable()
 	
 	FVector CameraLoc;
 	FRotator CameraRot;
-	OwningCharacterController->GetPlayerViewPoint(CameraLoc, CameraRot);
+	GetFuseViewPoint(CameraLoc, CameraRot);
 	FVector TraceXYStartLocation = CameraLoc;
 	FVector OwnerXYLocation = GetOwner()->GetActorLocation();
 	const float OwnerLocationZ = OwnerXYLocation.Z;
@@ -280,272 +719,530 @@ void UFFuseComponent::UpdateHeldFusable()
 	}
 
 	// Draw debug for up and down traces
-	if (CVarDrawDebugFuser.GetValueOnGameThread())
+	if (FFuseDebugDraw::IsEnabled())
 	{
 		// Up trace
-		DrawDebugLine(GetWorld(), TraceZStartLocation, TargetUpLocationHit.TraceEnd, FColor::Black, false, GetDeltaFuseTickTime());
-		DrawDebugSphere(GetWorld(), TargetUpLocationHit.Location, 10.0f, 16, FColor::Black, false, GetDeltaFuseTickTime());
+		FFuseDebugDraw::Line(this, TraceZStartLocation, TargetUpLocationHit.TraceEnd, FColor::Black, GetDeltaFuseTickTime());
+		FFuseDebugDraw::Sphere(this, TargetUpLocationHit.Location, 10.0f, 16, FColor::Black, GetDeltaFuseTickTime());
 		// Down trace
-		DrawDebugLine(GetWorld(), TraceZStartLocation, TargetDownLocationHit.TraceEnd, FColor::Black, false, GetDeltaFuseTickTime());
-		DrawDebugSphere(GetWorld(), TargetDownLocationHit.Location, 10.0f, 16, FColor::Black, false, GetDeltaFuseTickTime());
+		FFuseDebugDraw::Line(this, TraceZStartLocation, TargetDownLocationHit.TraceEnd, FColor::Black, GetDeltaFuseTickTime());
+		FFuseDebugDraw::Sphere(this, TargetDownLocationHit.Location, 10.0f, 16, FColor::Black, GetDeltaFuseTickTime());
 	}
 	
 	// Set Z target location
 	GrabbedComponentTargetHeight = FMath::Clamp(GrabbedComponentTargetHeight, MinGrabbedComponentHeight - OwnerLocationZ,  MaxGrabbedComponentHeight - OwnerLocationZ);
 	TargetLocation.Z = OwnerLocationZ + GrabbedComponentTargetHeight;
 	
+	// Ease a predicted held component towards the server's after a correction, see ReconcileHeldState()
+	if (!PredictionCorrectionOffset.IsNearlyZero())
+	{
+		TargetLocation += PredictionCorrectionOffset;
+		PredictionCorrectionOffset *= FMath::Exp(-GetDeltaFuseTickTime() / FMath::Max(PredictionCorrectionSmoothingTime, KINDA_SMALL_NUMBER));
+	}
+	
 	
 	// Draw debug info if debug is enabled
-	if (CVarDrawDebugFuser.GetValueOnGameThread())
+	if (FFuseDebugDraw::IsEnabled())
 	{
-		DrawDebugLine(GetWorld(), CameraLoc, TargetLocationHit.TraceEnd, FColor::Cyan, false, GetDeltaFuseTickTime());
+		FFuseDebugDraw::Line(this, CameraLoc, TargetLocationHit.TraceEnd, FColor::Cyan, GetDeltaFuseTickTime());
 		if (bTraceResult)
 		{
-			DrawDebugSphere(GetWorld(), TargetLocationHit.Location, 10.0f, 16, FColor::Green, false, GetDeltaFuseTickTime());
+			FFuseDebugDraw::Sphere(this, TargetLocationHit.Location, 10.0f, 16, FColor::Green, GetDeltaFuseTickTime());
 		}
 	}
 	
 	/* Target rotation */
 	
-	// Transform local target quaternion to global rotator, rounded to nearest ComponentRotationMultiplier
-	FRotator TargetRotation = FRotator(RotateRotator(GetOwnerControlRotationYaw(), FRotator(RoundRotatorToNearestMultiple(GrabbedComponentLocalTargetRotator, ComponentRotationMultiplier))));
+	// Transform local target orientation to global rotator
+	FRotator TargetRotation = FRotator(FQuat(GetOwnerControlRotationYaw()) * GetOrientationTable().GetQuat(GrabbedComponentLocalOrientation));
 
 	// Apply location and rotation to held fusable target
 	SetTargetLocationAndRotation(TargetLocation, TargetRotation);
+	LatencyMarks.Resolve(EFuseLatencyEvent::Rotate);
+	LatencyMarks.Resolve(EFuseLatencyEvent::Distance);
+	LatencyMarks.Resolve(EFuseLatencyEvent::Height);
 	
-	// Update location and rotation of orthographic projection actor
-	if (LastSpawnedOrthoProjectionActor)
-	{
-		LastSpawnedOrthoProjectionActor->SetActorLocationAndRotation(GetGrabbedComponent()->GetComponentLocation(), GetOwnerControlRotationYaw());
-	}
+	UpdateOrthoProjectionActor();
 
 	// Try and find a pair of fuse sockets for the current held fusable
 	// Only run this if the control rotation is significantly different to the last tick rotation
 	if (!CameraRot.Equals(OwnerCameraRotCached, 2.0f))
     {
 		ClearFuseOperationData();
-		TryFindIdealFuseSockets(LastFuseOperationData);
+		TryFindIdealFuseSockets(LastFuseOperation);
     }
     OwnerCameraRotCached = GetOwnerControlRotation();
+	
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		SendPendingHeldInputs();
+		if (PredictedLocations.Num() == MaxPredictedLocations) { PredictedLocations.RemoveAt(0, 1, false); }
+		PredictedLocations.Add({GetWorld()->GetRealTimeSeconds(), GetGrabbedComponent()->GetComponentLocation()});
+	}
+	else if (!IsLocalFuser())
+	{
+		UpdateHeldState();
+	}
 }
 
-bool UFFuseComponent::TryFindIdealFuseSockets(FFuseOperationData& FuseOperationData)
+void UFFuseComponent::FindNeighbourHits(const FVector& Location, const float Radius, const UPrimitiveComponent* IgnoredComponent, TArray<FHitResult>& OutHits) const
 {
-	/*
-	 * Finds nearby fusable actors, and loops through all the sockets to find the nearest pair of sockets on the held
-	 * fusable and nearby fusables
-	 */
-	
-	if (GetGrabbedComponent() == nullptr) { return false; }
-
-	// Init the socket distance to MaxFuseDistance before starting distance checks
-	FuseOperationData.DistanceBetweenSockets = MaxFuseDistance;
-	
-	// Trace for potential fusables within held fusable bounds + Max fusable distance radius
-	TArray<FHitResult> HitResults;
-	const FVector TraceLocation =  GetGrabbedComponent()->GetComponentLocation();
 	FCollisionObjectQueryParams ObjectQueryParams;
 	ObjectQueryParams.AddObjectTypesToQuery(ECC_PhysicsBody);
 	FCollisionQueryParams CollisionParams;
-	CollisionParams.AddIgnoredComponent(GetGrabbedComponent());
+	CollisionParams.AddIgnoredComponent(IgnoredComponent);
 	FCollisionShape CollisionShape;
-	const float TraceRadius = GetGrabbedComponent()->GetLocalBounds().SphereRadius + MaxFuseDistance;
-	CollisionShape.SetSphere(TraceRadius);
-
-	bool bTraceHit = GetWorld()->SweepMultiByObjectType(
-                        HitResults,
-                        TraceLocation,
-                        TraceLocation,
-                        FQuat::Identity,
-                        ObjectQueryParams,
-                        CollisionShape,
-                        CollisionParams);
-
-	if (CVarDrawDebugFuser.GetValueOnGameThread())
-    {
-    	DrawDebugSphere(GetWorld(), TraceLocation, TraceRadius, 16, FColor::Green, false, GetDeltaFuseTickTime());
-    }
+	CollisionShape.SetSphere(Radius);
+	
+	OutHits.Reset();
+	GetWorld()->SweepMultiByObjectType(OutHits, Location, Location, FQuat::Identity, ObjectQueryParams, CollisionShape, CollisionParams);
+}
+
+bool UFFuseComponent::TryFindIdealFuseSockets(FFuseOperation& FuseOperation, const bool bRediscover)
+{
+	/*
+	 * Keeps the nearest pairs of sockets on the held fusable and nearby fusables as ranked candidates, and makes the
+	 * active candidate the fuse operation
+	 * This runs every update while holding, so it only uses the cached socket tables, the reused query arrays and
+	 * the mem stack for its working memory
+	 */
+	FUSE_SCOPE_CYCLE_COUNTER(TryFindIdealFuseSockets);
 	
-	if (bTraceHit)
+	UPrimitiveComponent* SourceComponent = GetGrabbedComponent();
+	if (SourceComponent == nullptr) { return false; }
+	const FFuseSocketTable& SourceSockets = FFuseSocketTable::Get(SourceComponent, FusableSocketSubName);
+	const bool bHoldingAssembly = HeldAssembly.IsValid() && HeldAssembly.Parts[0] == SourceComponent;
+	if (SourceSockets.IsEmpty() && !bHoldingAssembly) { return false; }
+	
+	// Init the socket distance to MaxFuseDistance before starting distance checks
+	FuseOperation.DistanceBetweenSockets = MaxFuseDistance;
+	
+	if (FuseCandidates.SourceComponent != SourceComponent)
 	{
-		for (FHitResult HitResult : HitResults)
-		{
-			// Check that the active hit result hit a fusable component
-			if (!IsComponentFusable(HitResult)) { continue; }
-			
-            // Find the nearest two sockets of the two fusables within a max distance
-            // Might be a better way to do this than a nested for each loop
-            for (FName SourceSocketName : GetGrabbedComponent()->GetAllSocketNames())
-            {
-                if (SourceSocketName.ToString().Contains(FusableSocketSubName))
-                {
-                    for (FName TargetSocketName : HitResult.GetComponent()->GetAllSocketNames())
-                    {
-                        if (TargetSocketName.ToString().Contains(FusableSocketSubName))
-                        {
-                        	// Check that the latest socket distance is shorter than any previous checks this tick
-                        	if (const float SocketDistance = FVector::Distance(
-		                            GetGrabbedComponent()->GetSocketLocation(SourceSocketName),
-		                            HitResult.GetComponent()->GetSocketLocation(TargetSocketName)) < FuseOperationData.
-	                            DistanceBetweenSockets)
-                        	{
-                        		// Check if the source would collide with the target if transformed to the relevant socket
-                        		TArray<FOverlapResult> ComponentOverlapResults;
-                        		
-                        		FTransform SourceTargetTransform = FindSourceFusableTargetTransform(GetGrabbedComponent(), SourceSocketName, HitResult.GetComponent(), TargetSocketName);
-                        		FVector SourceTargetLocation = SourceTargetTransform.GetLocation();
-                        		FRotator SourceTargetRotation = FRotator(SourceTargetTransform.GetRotation());
-                        		
-                        		FComponentQueryParams ComponentQueryParams;
-                        		ComponentQueryParams.AddIgnoredComponent(GetGrabbedComponent());
-                        		FCollisionObjectQueryParams ComponentObjectQueryParams;
-                        		ComponentObjectQueryParams.AddObjectTypesToQuery(ECC_PhysicsBody);
-                        		
-                        		bool bCollidesOtherFusable = GetWorld()->ComponentOverlapMulti(ComponentOverlapResults, GetGrabbedComponent(),
-                                                                  SourceTargetLocation, SourceTargetRotation,
-                                                                  ComponentQueryParams, ComponentObjectQueryParams);
-								
-                        		/*// Loop through source hits to check if any are fusable objects
-                        		// If any are, then this will be considered an invalid operation due to a likely collision
-                        		bool bCollidesOtherFusable;
-                        		for (FOverlapResult OverlapResult : ComponentOverlapResults)
-                        		{
-                        			TArray<FName> OverlappedCompSocketNames = OverlapResult.Component->GetAllSocketNames();
-                        			for (FName SocketName : OverlappedCompSocketNames)
-                        			{
-	                                    if (SocketName.ToString().Contains("Attach"))
-	                                    {
-		                                    bCollidesOtherFusable = true;
-	                                    	break;
-	                                    }
-                        			}
-                                    if (bCollidesOtherFusable) { break; }
-                        		}*/
-
-                        		// Draw coloured debug capsules to represent possible locations and their collision validity
-                        		if (CVarDrawDebugFuser.GetValueOnGameThread())
-                        		{
-                        			DrawDebugCapsule(GetWorld(), SourceTargetLocation, 30.0f, 10.0f,
-	                                                 FQuat(SourceTargetRotation),
-	                                                 bCollidesOtherFusable ? FColor::Red : FColor::Blue, false, GetDeltaFuseTickTime(), 1, 5);
-                        		}
-                        		
-                        		// If all checks have passed, promote this loop's sockets as the best operation data
-                                if (!bCollidesOtherFusable)
-                                {
-                                	FuseOperationData.bHasValidFuse = true;
-                                	FuseOperationData.DistanceBetweenSockets = SocketDistance;
-                                	FuseOperationData.IdealSoureObjectSocket = SourceSocketName;
-                                	FuseOperationData.IdealTargetComponent = HitResult.GetComponent();
-                                	FuseOperationData.IdealTargetObjectSocket = TargetSocketName;
-                                }
-                        	}
-                        }
-                    }
-                }
-            }
-		}
+		FuseCandidates.Reset();
+		FuseCandidates.SourceComponent = SourceComponent;
 	}
+	const FFuseCandidate* PreviousActive = FuseCandidates.GetActive();
+	const FFuseCandidate PreviousActiveCandidate = PreviousActive ? *PreviousActive : FFuseCandidate();
 	
-	// Get all the socket pairs that are very close together where the fused objects would be, to spawn constraints at those too
-	if (FuseOperationData.bHasValidFuse)
+	// Re-score the candidates while the held component is near where they were found, otherwise others may be nearer
+	const FTransform& SourceTransform = SourceComponent->GetComponentTransform();
+	const bool bNearDiscovery = FVector::Distance(SourceTransform.GetLocation(), FuseCandidates.DiscoveredSourceTransform.GetLocation()) <= CVarFuseCandidateRescoreDistance.GetValueOnGameThread()
+	                            && SourceTransform.GetRotation().AngularDistance(FuseCandidates.DiscoveredSourceTransform.GetRotation()) <= FMath::DegreesToRadians(ComponentRotationMultiplier * 0.5f);
+	const bool bDiscover = bRediscover || !bNearDiscovery || !RescoreFuseCandidates();
+	if (bDiscover)
 	{
-		FTransform SourceTargetTransform = FindSourceFusableTargetTransform(GetGrabbedComponent(), FuseOperationData.IdealSoureObjectSocket, FuseOperationData.IdealTargetComponent, FuseOperationData.IdealTargetObjectSocket);
-		for (FName SourceSocket : GetGrabbedComponent()->GetAllSocketNames())
+		FuseCandidates.Candidates.Reset();
+		FuseCandidates.DiscoveredSourceTransform = SourceTransform;
+		if (bHoldingAssembly)
 		{
-			if (SourceSocket != FuseOperationData.IdealSoureObjectSocket)
+			// Every free socket of a held assembly is a source socket, searched against one sweep over the whole assembly
+			FBoxSphereBounds AssemblyBounds = SourceComponent->Bounds;
+			for (const TWeakObjectPtr<UPrimitiveComponent>& Part : HeldAssembly.Parts)
 			{
-				for (FName TargetSocket : FuseOperationData.IdealTargetComponent->GetAllSocketNames())
-				{
-					if (TargetSocket != FuseOperationData.IdealTargetObjectSocket)
-					{
-						// Get the location of the socket at the target location of the source component
-						const FVector SourceSocketLocation = GetGrabbedComponent()->GetSocketLocation(SourceSocket);
-						const FVector SourceSocketRelativeLocation = GetGrabbedComponent()->GetComponentTransform().InverseTransformPosition(SourceSocketLocation);
-						const FVector SourceSocketTargetLocation = SourceTargetTransform.TransformPosition(SourceSocketRelativeLocation);
-
-						// Check if the distance between the sockets is within a threshold
-                        // if the sockets are in that threshold, add them as supplimentary sockets
-						if (FuseOperationData.IdealTargetComponent->GetSocketLocation(TargetSocket).Equals(SourceSocketTargetLocation, 5.0f))
-						{
-							FSupplementalFuseSocketPairs SocketPair;
-							SocketPair.SourceSocket = SourceSocket;
-							SocketPair.TargetSocket = TargetSocket;
-							FuseOperationData.SupplementalSocketPairs.Add(SocketPair);
-						}
-					}
-				}
+				if (Part.IsValid()) { AssemblyBounds = AssemblyBounds + Part->Bounds; }
 			}
-		}
-		
-		// draw debug line if debug is enabled
-		if (CVarDrawDebugFuser.GetValueOnGameThread())
-		{
-			const FVector DebugLineStartLoc = GetGrabbedComponent()->GetSocketLocation(FuseOperationData.IdealSoureObjectSocket);
-            const FVector DebugLineEndLoc = FuseOperationData.IdealTargetComponent->GetSocketLocation(FuseOperationData.IdealTargetObjectSocket);
-            DrawDebugDirectionalArrow(GetWorld(), DebugLineStartLoc, DebugLineEndLoc, 10.0f, FColor::Orange, false, 0.05f, 1, 5.0f);
-			for (FSupplementalFuseSocketPairs SocketPair : FuseOperationData.SupplementalSocketPairs)
+			FindNeighbourHits(AssemblyBounds.Origin, AssemblyBounds.SphereRadius + MaxFuseDistance, SourceComponent, ScratchHitResults);
+			if (FFuseDebugDraw::IsEnabled())
 			{
-				const FVector SuppLineStart = GetGrabbedComponent()->GetSocketLocation(SocketPair.SourceSocket);
-				const FVector SuppLineEnd = FuseOperationData.IdealTargetComponent->GetSocketLocation(SocketPair.TargetSocket);
-				DrawDebugLine(GetWorld(), SuppLineStart, SuppLineEnd, FColor::Emerald, false, 0.05f, 1, 4.0f);
+				FFuseDebugDraw::Sphere(this, AssemblyBounds.Origin, AssemblyBounds.SphereRadius + MaxFuseDistance, 16, FColor::Green, GetDeltaFuseTickTime());
+			}
+			for (int32 PartIndex = 0; PartIndex < HeldAssembly.Parts.Num(); PartIndex++)
+			{
+				UPrimitiveComponent* Part = HeldAssembly.Parts[PartIndex].Get();
+				if (!Part) { continue; }
+				DiscoverFuseCandidates(Part, FFuseSocketTable::Get(Part, FusableSocketSubName), &HeldAssembly.FreeSockets[PartIndex], true);
 			}
 		}
-		return true;
+		else
+		{
+			DiscoverFuseCandidates(SourceComponent, SourceSockets);
+		}
 	}
-	return false;
-}
-
-FTransform UFFuseComponent::FindSourceFusableTargetTransform(UPrimitiveComponent* SourceComponent,
-	FName SourceSocketName, UPrimitiveComponent* TargetComponent, FName TargetSocketName)
-{
-	const FRotator SourceSocketRotation = SourceComponent->GetSocketRotation(SourceSocketName);
-                        		
-	const FRotator TargetComponentRotation = TargetComponent->GetComponentRotation();
-	const FRotator SourceTargetRotation = RotateRotator(
-		TargetComponentRotation,
-		RoundRotatorToNearestMultiple(
-			InverseRotateRotator(TargetComponentRotation, SourceSocketRotation),
-			ComponentRotationMultiplier));
-                        		
-	// Get current location of socket
-	const FVector TargetSocketLocation = TargetComponent->GetSocketLocation(TargetSocketName);
-	const FVector SourceCurrentSocketLocation = SourceComponent->GetSocketLocation(SourceSocketName);
-                        		
-	// Convert current location to relative location
-	const FVector SourceCurrentRelativeSocketLocation = SourceComponent->GetComponentLocation() - SourceCurrentSocketLocation;
-	const FVector SourceTargetZeroedSocketLocation = SourceComponent->GetComponentRotation().UnrotateVector(SourceCurrentRelativeSocketLocation);
-                        		
-	// Rotate socket by current component rotation
-	const FVector SourceTargetRelativeSocketLocation = SourceTargetRotation.RotateVector(SourceTargetZeroedSocketLocation);
-                        		
-	// Rotate by target component rotation
-	const FVector SourceTargetLocation = SourceTargetRelativeSocketLocation + TargetSocketLocation;
-
-	FTransform SourceTargetTransform;
-	SourceTargetTransform.SetLocation(SourceTargetLocation);
-	SourceTargetTransform.SetRotation(FQuat(SourceTargetRotation));
-	return SourceTargetTransform;
+	
+	FuseCandidates.UpdateActive(PreviousActiveCandidate, CVarFuseCandidateHysteresis.GetValueOnGameThread(), bDiscover);
+	const FFuseCandidate* Active = FuseCandidates.GetActive();
+	if (Active && PreviousActiveCandidate.IsValid() && !Active->IsSameAs(PreviousActiveCandidate))
+	{
+		FUSE_INC_COUNTER(CandidateSwitches, 1);
+	}
+	return ApplyActiveFuseCandidate(FuseOperation);
 }
 
-bool UFFuseComponent::TryFuseObjects()
+bool UFFuseComponent::RescoreFuseCandidates()
 {
-	if (LastFuseOperationData.bHasValidFuse && LastFuseOperationData.IdealTargetComponent)
+	FComponentQueryParams ComponentQueryParams;
+	ComponentQueryParams.AddIgnoredComponent(GetGrabbedComponent());
+	IgnoreHeldAssembly(ComponentQueryParams);
+	FCollisionObjectQueryParams ComponentObjectQueryParams;
+	ComponentObjectQueryParams.AddObjectTypesToQuery(ECC_PhysicsBody);
+	
+	for (int32 CandidateIndex = FuseCandidates.Num() - 1; CandidateIndex >= 0; CandidateIndex--)
 	{
-		// Spawn constraint actor
-		LastSpawnedConstraintActor = GetWorld()->SpawnActor<APhysicsConstraintActor>(PhysicsConstraintActor, LastFuseOperationData.IdealTargetComponent->GetComponentLocation(), LastFuseOperationData.IdealTargetComponent->GetComponentRotation());
-		
+		FFuseCandidate& Candidate = FuseCandidates.Candidates[CandidateIndex];
+		UPrimitiveComponent* SourceComponent = Candidate.SourceComponent.Get();
+		UPrimitiveComponent* TargetComponent = Candidate.TargetComponent.Get();
+		if (!SourceComponent)
+		{
+			FuseCandidates.Candidates.RemoveAt(CandidateIndex, 1, false);
+			continue;
+		}
+		const FFuseSocketTable& SourceSockets = FFuseSocketTable::Get(SourceComponent, FusableSocketSubName);
+		const FFuseSocketTable& TargetSockets = FFuseSocketTable::Get(TargetComponent, FusableSocketSubName);
+		const FTransform& SourceTransform = SourceComponent->GetComponentTransform();
+		FTransform TargetTransform;
+		bool bKeep = TargetComponent && SourceSockets.GetSockets().IsValidIndex(Candidate.Sockets.SourceSocket)
+		             && TargetSockets.GetSockets().IsValidIndex(Candidate.Sockets.TargetSocket);
+		if (bKeep && Candidate.TargetInstance != INDEX_NONE)
+		{
+			// Other promotions renumber instances, so find the candidate's instance again from where it was found
+			const int32 TargetInstance = FFuseInstancedFusables::ResolveInstance(Cast<UInstancedStaticMeshComponent>(TargetComponent),
+			                                                                     Candidate.TargetInstance, Candidate.TargetInstanceTransform);
+			if (TargetInstance != Candidate.TargetInstance && FuseCandidates.PinnedCandidate.IsSameAs(Candidate))
+			{
+				FuseCandidates.PinnedCandidate.TargetInstance = TargetInstance;
+			}
+			Candidate.TargetInstance = TargetInstance;
+			TargetTransform = Candidate.TargetInstanceTransform;
+			bKeep = TargetInstance != INDEX_NONE;
+		}
+		else if (bKeep)
+		{
+			TargetTransform = TargetComponent->GetComponentTransform();
+		}
+		if (bKeep)
+		{
+			Candidate.Distance = FVector::Distance(SourceSockets.GetSocketLocation(Candidate.Sockets.SourceSocket, SourceTransform),
+			                                       TargetSockets.GetSocketLocation(Candidate.Sockets.TargetSocket, TargetTransform));
+			bKeep = Candidate.Distance < MaxFuseDistance;
+		}
+		if (bKeep)
+		{
+			// Where the source would go only changes with the snapped orientation, so only check the overlap again then
+			uint16 Orientation = MAX_uint16;
+			const FTransform SourceTargetTransform = FFuseTargetTransforms::Compute(
+				SourceTransform, SourceSockets[Candidate.Sockets.SourceSocket], TargetTransform, TargetSockets[Candidate.Sockets.TargetSocket],
+				GetOrientationTable(), &Orientation);
+			if (Orientation != Candidate.Orientation)
+			{
+				ScratchOverlapResults.Reset();
+				bKeep = !GetWorld()->ComponentOverlapMulti(ScratchOverlapResults, SourceComponent, SourceTargetTransform.GetLocation(), SourceTargetTransform.GetRotation(),
+				                                           ComponentQueryParams, ComponentObjectQueryParams);
+				FUSE_INC_COUNTER(OverlapQueries, 1);
+				Candidate.Orientation = Orientation;
+			}
+		}
+		if (!bKeep) { FuseCandidates.Candidates.RemoveAt(CandidateIndex, 1, false); }
+	}
+	FuseCandidates.Sort();
+	return FuseCandidates.Num() > 0;
+}
+
+void UFFuseComponent::DiscoverFuseCandidates(UPrimitiveComponent* SourceComponent, const FFuseSocketTable& SourceSockets, const TBitArray<>* FreeSockets,
+                                             const bool bNeighboursFound)
+{
+	// Working arrays for this search, released when the mark goes out of scope
+	FMemMark MemMark(FMemStack::Get());
+	
+	const FTransform& SourceTransform = SourceComponent->GetComponentTransform();
+	
+	// World locations and normals of the source sockets, found once rather than for every target socket
+	TArray<FVector, TMemStackAllocator<>> SourceSocketLocations;
+	TArray<FVector, TMemStackAllocator<>> SourceSocketNormals;
+	SourceSocketLocations.SetNumUninitialized(SourceSockets.Num());
+	SourceSocketNormals.SetNumUninitialized(SourceSockets.Num());
+	for (int32 SourceIndex = 0; SourceIndex < SourceSockets.Num(); SourceIndex++)
+	{
+		SourceSocketLocations[SourceIndex] = SourceSockets.GetSocketLocation(SourceIndex, SourceTransform);
+		SourceSocketNormals[SourceIndex] = SourceTransform.TransformVectorNoScale(SourceSockets[SourceIndex].Normal);
+	}
+	const bool bPruneSocketPairs = CVarFuseSocketPruning.GetValueOnGameThread();
+	const FVector SourceSocketsCentre = SourceTransform.TransformPosition(SourceSockets.GetSocketBounds().Center);
+	const float SourceSocketsRadius = SourceSockets.GetSocketBounds().W * SourceTransform.GetMaximumAxisScale();
+	
+	// Trace for potential fusables within held fusable bounds + Max fusable distance radius
+	// The first search after a grab reuses the neighbours found while the component was targeted
+	const FVector TraceLocation = SourceComponent->GetComponentLocation();
+	const float TraceRadius = SourceComponent->GetLocalBounds().SphereRadius + MaxFuseDistance;
+	if (!bNeighboursFound && !TryUsePrefetchedNeighbours(SourceComponent, TraceRadius))
+	{
+		FindNeighbourHits(TraceLocation, TraceRadius, SourceComponent, ScratchHitResults);
+	}
+
+	if (!bNeighboursFound && FFuseDebugDraw::IsEnabled())
+    {
+    	FFuseDebugDraw::Sphere(this, TraceLocation, TraceRadius, 16, FColor::Green, GetDeltaFuseTickTime());
+    }
+	if (ScratchHitResults.Num() == 0) { return; }
+	
+	// Only the part being fused is checked where it would go, the rest of a held assembly moves with it but isn't checked
+	FComponentQueryParams ComponentQueryParams;
+	ComponentQueryParams.AddIgnoredComponent(SourceComponent);
+	IgnoreHeldAssembly(ComponentQueryParams);
+	FCollisionObjectQueryParams ComponentObjectQueryParams;
+	ComponentObjectQueryParams.AddObjectTypesToQuery(ECC_PhysicsBody);
+	
+	TArray<FVector, TMemStackAllocator<>> TargetSocketLocations;
+	TArray<FVector, TMemStackAllocator<>> TargetSocketNormals;
+	TArray<FFuseSocketPair, TMemStackAllocator<>> CandidatePairs;
+	TArray<float, TMemStackAllocator<>> CandidateDistances;
+	TArray<int32, TMemStackAllocator<>> CandidateOrder;
+	TArray<FTransform, TMemStackAllocator<>> CandidateTransforms;
+	TArray<uint16, TMemStackAllocator<>> CandidateOrientations;
+	int32 SocketPairsScored = 0;
+	int32 SocketPairsPruned = 0;
+	for (const FHitResult& HitResult : ScratchHitResults)
+	{
+		// Check that the active hit result hit a fusable component, or an instance of one
+		UPrimitiveComponent* TargetComponent = HitResult.GetComponent();
+		if (!TargetComponent || HeldAssembly.Find(TargetComponent) != INDEX_NONE) { continue; }
+		const FFuseSocketTable& TargetSockets = FFuseSocketTable::Get(TargetComponent, FusableSocketSubName);
+		FTransform TargetTransform;
+		if (TargetSockets.IsEmpty() || !FFuseInstancedFusables::GetFusableTransform(TargetComponent, HitResult.Item, TargetTransform)) { continue; }
+		FUSE_INC_COUNTER(NeighboursFound, 1);
+		
+		// Skip neighbours whose sockets are all further away than the furthest candidate that can still be ranked
+		const float SocketsCentreDistance = FVector::Distance(SourceSocketsCentre, TargetTransform.TransformPosition(TargetSockets.GetSocketBounds().Center));
+		if (SocketsCentreDistance - SourceSocketsRadius - TargetSockets.GetSocketBounds().W * TargetTransform.GetMaximumAxisScale() >= FuseCandidates.GetThreshold(MaxFuseDistance)) { continue; }
+		
+		TargetSocketLocations.SetNumUninitialized(TargetSockets.Num(), false);
+		TargetSocketNormals.SetNumUninitialized(TargetSockets.Num(), false);
+		for (int32 TargetIndex = 0; TargetIndex < TargetSockets.Num(); TargetIndex++)
+		{
+			TargetSocketLocations[TargetIndex] = TargetSockets.GetSocketLocation(TargetIndex, TargetTransform);
+			TargetSocketNormals[TargetIndex] = TargetTransform.TransformVectorNoScale(TargetSockets[TargetIndex].Normal);
+		}
+		
+        // Find the pairs of sockets on the two fusables that are near enough to be ranked
+        // Might be a better way to do this than a nested for each loop
+        const float Threshold = FuseCandidates.GetThreshold(MaxFuseDistance);
+        CandidatePairs.Reset();
+        CandidateDistances.Reset();
+        for (int32 SourceIndex = 0; SourceIndex < SourceSockets.Num(); SourceIndex++)
+        {
+        	if (FreeSockets && !(*FreeSockets)[SourceIndex]) { continue; }
+            for (int32 TargetIndex = 0; TargetIndex < TargetSockets.Num(); TargetIndex++)
+            {
+            	const float SocketDistance = FVector::Distance(SourceSocketLocations[SourceIndex], TargetSocketLocations[TargetIndex]);
+            	if (SocketDistance >= Threshold) { continue; }
+            	
+            	// Sockets only fuse face to face, a held component can't be turned far enough to fuse sockets facing the same way
+            	if (bPruneSocketPairs && (!SourceSockets[SourceIndex].IsCompatibleWith(TargetSockets[TargetIndex])
+            	                          || FVector::DotProduct(SourceSocketNormals[SourceIndex], TargetSocketNormals[TargetIndex]) > FuseSocketPruningNormalDot))
+            	{
+            		SocketPairsPruned++;
+            		continue;
+            	}
+            	CandidatePairs.Add({static_cast<uint16>(SourceIndex), static_cast<uint16>(TargetIndex)});
+            	CandidateDistances.Add(SocketDistance);
+            }
+        }
+        SocketPairsScored += SourceSockets.Num() * TargetSockets.Num();
+        if (CandidatePairs.Num() == 0) { continue; }
+        
+        // Solve where the source would be for every candidate at once
+        CandidateTransforms.SetNumUninitialized(CandidatePairs.Num(), false);
+        CandidateOrientations.SetNumUninitialized(CandidatePairs.Num(), false);
+        FFuseTargetTransforms::Compute(SourceTransform, SourceSockets.GetSockets(), TargetTransform, TargetSockets.GetSockets(),
+                                       CandidatePairs, GetOrientationTable(), CandidateTransforms, CandidateOrientations);
+        
+        // Check the nearest first, so the overlap checks stop once the set is full of nearer candidates
+        CandidateOrder.SetNumUninitialized(CandidatePairs.Num(), false);
+        for (int32 CandidateIndex = 0; CandidateIndex < CandidatePairs.Num(); CandidateIndex++) { CandidateOrder[CandidateIndex] = CandidateIndex; }
+        CandidateOrder.Sort([&CandidateDistances](const int32 A, const int32 B) { return CandidateDistances[A] < CandidateDistances[B]; });
+        
+        for (const int32 CandidateIndex : CandidateOrder)
+        {
+        	const float SocketDistance = CandidateDistances[CandidateIndex];
+        	if (SocketDistance >= FuseCandidates.GetThreshold(MaxFuseDistance)) { break; }
+        	
+        	// Check if the source would collide with the target if transformed to the relevant socket
+        	const FVector SourceTargetLocation = CandidateTransforms[CandidateIndex].GetLocation();
+        	const FQuat SourceTargetRotation = CandidateTransforms[CandidateIndex].GetRotation();
+        	
+        	ScratchOverlapResults.Reset();
+        	bool bCollidesOtherFusable = GetWorld()->ComponentOverlapMulti(ScratchOverlapResults, SourceComponent,
+                                                  SourceTargetLocation, SourceTargetRotation,
+                                                  ComponentQueryParams, ComponentObjectQueryParams);
+        	FUSE_INC_COUNTER(OverlapQueries, 1);
+
+        	// Draw coloured debug capsules to represent possible locations and their collision validity
+        	if (FFuseDebugDraw::IsEnabled())
+        	{
+        		FFuseDebugDraw::Capsule(this, SourceTargetLocation, 30.0f, 10.0f,
+                                        SourceTargetRotation,
+                                        bCollidesOtherFusable ? FColor::Red : FColor::Blue, GetDeltaFuseTickTime(), 5.0f);
+        	}
+        	
+        	// If all checks have passed, rank this loop's sockets as a candidate
+            if (!bCollidesOtherFusable)
+            {
+            	FFuseCandidate Candidate;
+            	Candidate.SourceComponent = SourceComponent;
+            	Candidate.TargetComponent = TargetComponent;
+            	Candidate.TargetInstance = FFuseInstancedFusables::IsInstanced(TargetComponent) ? HitResult.Item : INDEX_NONE;
+            	Candidate.TargetInstanceTransform = TargetTransform;
+            	Candidate.Sockets = CandidatePairs[CandidateIndex];
+            	Candidate.Orientation = CandidateOrientations[CandidateIndex];
+            	Candidate.Distance = SocketDistance;
+            	FuseCandidates.Insert(Candidate);
+            }
+        }
+	}
+	FUSE_INC_COUNTER(SocketPairsScored, SocketPairsScored);
+	FUSE_INC_COUNTER(SocketPairsPruned, SocketPairsPruned);
+}
+
+bool UFFuseComponent::ApplyActiveFuseCandidate(FFuseOperation& FuseOperation)
+{
+	const FFuseCandidate* Active = FuseCandidates.GetActive();
+	UPrimitiveComponent* SourceComponent = Active ? Active->SourceComponent.Get() : nullptr;
+	UPrimitiveComponent* TargetComponent = Active ? Active->TargetComponent.Get() : nullptr;
+	if (!SourceComponent || !TargetComponent) { return false; }
+	
+	FuseOperation.SourceComponent = SourceComponent;
+	FuseOperation.DistanceBetweenSockets = Active->Distance;
+	FuseOperation.IdealSockets = Active->Sockets;
+	FuseOperation.Orientation = Active->Orientation;
+	FuseOperation.TargetComponent = TargetComponent;
+	FuseOperation.TargetInstance = Active->TargetInstance;
+	FuseOperation.TargetInstanceTransform = Active->TargetInstanceTransform;
+	FuseOperation.SupplementalPairs.Reset();
+	
+	const FFuseSocketTable& SourceSockets = FFuseSocketTable::Get(SourceComponent, FusableSocketSubName);
+	const FFuseSocketTable& TargetSockets = FFuseSocketTable::Get(TargetComponent, FusableSocketSubName);
+	const FTransform& SourceTransform = SourceComponent->GetComponentTransform();
+	const FTransform TargetTransform = FuseOperation.TargetInstance != INDEX_NONE ? FuseOperation.TargetInstanceTransform : TargetComponent->GetComponentTransform();
+	
+	// Get all the socket pairs that are very close together where the fused objects would be, to spawn constraints at those too
+	// They only depend on the active candidate and its target, so they're kept until either changes
+	if (!Active->IsSameAs(FuseCandidates.SupplementalCandidate) || Active->Orientation != FuseCandidates.SupplementalCandidate.Orientation
+	    || !TargetTransform.Equals(FuseCandidates.SupplementalTargetTransform, KINDA_SMALL_NUMBER))
+	{
+		FUSE_SCOPE_CYCLE_COUNTER(FindSupplementalSockets);
+		
+		FuseCandidates.SupplementalCandidate = *Active;
+		FuseCandidates.SupplementalTargetTransform = TargetTransform;
+		FuseCandidates.SupplementalPairs.Reset();
+		// Past MaxSupplementalPairs the nearest pairs are kept, they're the ones that will actually be touching
+		TArray<float, TFixedAllocator<FFuseOperation::MaxSupplementalPairs>> PairDistances;
+		int32 DroppedPairs = 0;
+		const FTransform SourceTargetTransform = FFuseTargetTransforms::Compute(
+			SourceTransform, SourceSockets[FuseOperation.IdealSockets.SourceSocket],
+			TargetTransform, TargetSockets[FuseOperation.IdealSockets.TargetSocket], GetOrientationTable());
+		for (int32 SourceIndex = 0; SourceIndex < SourceSockets.Num(); SourceIndex++)
+		{
+			if (SourceIndex == FuseOperation.IdealSockets.SourceSocket) { continue; }
+			
+			// Get the location of the socket at the target location of the source component
+			const FVector SourceSocketTargetLocation = SourceTargetTransform.TransformPosition(SourceSockets[SourceIndex].LocalTransform.GetLocation());
+			for (int32 TargetIndex = 0; TargetIndex < TargetSockets.Num(); TargetIndex++)
+			{
+				if (TargetIndex == FuseOperation.IdealSockets.TargetSocket) { continue; }
+
+				// Check if the distance between the sockets is within a threshold
+				// if the sockets are in that threshold, add them as supplimentary sockets
+				const FVector TargetSocketLocation = TargetSockets.GetSocketLocation(TargetIndex, TargetTransform);
+				if (!TargetSocketLocation.Equals(SourceSocketTargetLocation, 5.0f) || !SourceSockets[SourceIndex].IsCompatibleWith(TargetSockets[TargetIndex])) { continue; }
+				const FFuseSocketPair Pair{static_cast<uint16>(SourceIndex), static_cast<uint16>(TargetIndex)};
+				const float PairDistance = FVector::DistSquared(TargetSocketLocation, SourceSocketTargetLocation);
+				if (FuseCandidates.SupplementalPairs.Num() < FFuseOperation::MaxSupplementalPairs)
+				{
+					FuseCandidates.SupplementalPairs.Add(Pair);
+					PairDistances.Add(PairDistance);
+					continue;
+				}
+				DroppedPairs++;
+				const int32 FurthestIndex = static_cast<int32>(Algo::MaxElement(PairDistances) - PairDistances.GetData());
+				if (PairDistance < PairDistances[FurthestIndex])
+				{
+					FuseCandidates.SupplementalPairs[FurthestIndex] = Pair;
+					PairDistances[FurthestIndex] = PairDistance;
+				}
+			}
+		}
+		if (DroppedPairs > 0)
+		{
+			FUSE_INC_COUNTER(SupplementalPairsDropped, DroppedPairs);
+			UE_LOG(LogTemp, Verbose, TEXT("Fuse kept the nearest %d supplemental socket pairs, %d more were dropped"),
+			       FFuseOperation::MaxSupplementalPairs, DroppedPairs);
+		}
+	}
+	for (const FFuseSocketPair& SocketPair : FuseCandidates.SupplementalPairs) { FuseOperation.AddSupplementalPair(SocketPair); }
+	
+	// draw debug line if debug is enabled
+	if (FFuseDebugDraw::IsEnabled())
+	{
+		const FVector DebugLineStartLoc = SourceSockets.GetSocketLocation(FuseOperation.IdealSockets.SourceSocket, SourceTransform);
+        const FVector DebugLineEndLoc = TargetSockets.GetSocketLocation(FuseOperation.IdealSockets.TargetSocket, TargetTransform);
+        FFuseDebugDraw::Arrow(this, DebugLineStartLoc, DebugLineEndLoc, 10.0f, FColor::Orange, 0.05f, 5.0f);
+		for (const FFuseSocketPair& SocketPair : FuseOperation.SupplementalPairs)
+		{
+			const FVector SuppLineStart = SourceSockets.GetSocketLocation(SocketPair.SourceSocket, SourceTransform);
+			const FVector SuppLineEnd = TargetSockets.GetSocketLocation(SocketPair.TargetSocket, TargetTransform);
+			FFuseDebugDraw::Line(this, SuppLineStart, SuppLineEnd, FColor::Emerald, 0.05f, 4.0f);
+		}
+	}
+	return true;
+}
+
+FTransform UFFuseComponent::FindSourceFusableTargetTransform(UPrimitiveComponent* SourceComponent,
+	const uint16 SourceSocket, UPrimitiveComponent* TargetComponent, const uint16 TargetSocket,
+	uint16* OutOrientation) const
+{
+	// Where the source component needs to be for the sockets to meet, with the source socket rotation snapped to
+	// the nearest reachable orientation relative to the target
+	return FFuseTargetTransforms::Compute(
+		SourceComponent->GetComponentTransform(), FFuseSocketTable::Get(SourceComponent, FusableSocketSubName)[SourceSocket],
+		TargetComponent->GetComponentTransform(), FFuseSocketTable::Get(TargetComponent, FusableSocketSubName)[TargetSocket],
+		GetOrientationTable(), OutOrientation);
+}
+
+bool UFFuseComponent::TryFuseObjects()
+{
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		if (!HeldComponent) { return false; }
+		ServerTryFuseObjects();
+		return true;
+	}
+	
+	UPrimitiveComponent* TargetComponent = LastFuseOperation.TargetComponent.Get();
+	if (LastFuseOperation.IsValid() && LastFuseOperation.TargetInstance != INDEX_NONE)
+	{
+		// Instanced targets become real components once they're fused to
+		TargetComponent = FFuseInstancedFusables::Promote(Cast<UInstancedStaticMeshComponent>(TargetComponent), LastFuseOperation.TargetInstance,
+		                                                  LastFuseOperation.TargetInstanceTransform);
+		LastFuseOperation.TargetComponent = TargetComponent;
+		LastFuseOperation.TargetInstance = INDEX_NONE;
+	}
+	if (LastFuseOperation.IsValid() && TargetComponent)
+	{
+		if (UFFuseAssemblyLODSubsystem* AssemblyLOD = GetWorld()->GetSubsystem<UFFuseAssemblyLODSubsystem>())
+		{
+			AssemblyLOD->WakeAssembly(TargetComponent);
+		}
+
+		// Spawn constraint actor
+		LastSpawnedConstraintActor = GetWorld()->SpawnActor<APhysicsConstraintActor>(PhysicsConstraintActor, TargetComponent->GetComponentLocation(), TargetComponent->GetComponentRotation());
+		
 		if (LastSpawnedConstraintActor)
 		{
-			LastFuseOperationData.IdealSourceComponent = GetGrabbedComponent();
+			FUSE_INC_COUNTER(ConstraintsSpawned, 1);
+			if (!LastFuseOperation.SourceComponent.IsValid()) { LastFuseOperation.SourceComponent = GetGrabbedComponent(); }
 			
-			LastSpawnedConstraintActor->GetConstraintComp()->AttachToComponent(LastFuseOperationData.IdealTargetComponent, FAttachmentTransformRules::SnapToTargetNotIncludingScale, LastFuseOperationData.IdealTargetObjectSocket);
+			LastSpawnedConstraintActor->GetConstraintComp()->AttachToComponent(TargetComponent, FAttachmentTransformRules::SnapToTargetNotIncludingScale, GetFuseSocketName(TargetComponent, LastFuseOperation.IdealSockets.TargetSocket));
 			LastSpawnedConstraintActor->GetConstraintComp()->SetAngularTwistLimit(ACM_Locked, 1.0f);
 			LastSpawnedConstraintActor->GetConstraintComp()->SetAngularSwing1Limit(ACM_Locked, 1.0f);
 			LastSpawnedConstraintActor->GetConstraintComp()->SetAngularSwing2Limit(ACM_Locked, 1.0f);
 			
+			// A held assembly stays welded while it's fused, so it's moved into place as one body
+			FusingAssembly = MoveTemp(HeldAssembly);
+			HeldAssembly = FWeldedAssembly();
         	ReleaseComponent();
         	
+        	LatencyMarks.Mark(EFuseLatencyEvent::Fuse);
+        	if (FFuseEventJournal::IsEnabled()) { FFuseEventJournal::Record(this, MakeJournalEntry(EFuseJournalEvent::FuseStart)); }
         	UpdateFuserState(FSTATE_ACTIVEFUSING);
             return true;	
 		}
@@ -563,32 +1260,49 @@ void UFFuseComponent::FuseObjects(const float DeltaTime)
 	 *
 	 * This could be replaced with cleaner logic in a custom UPhysicsConstraintComponent extension, eventually
 	 */
-	if (LastSpawnedConstraintActor && LastFuseOperationData.IdealSourceComponent && LastFuseOperationData.IdealTargetComponent && LastFuseOperationData.DistanceBetweenSockets < MaxFuseDistance)
+	FUSE_SCOPE_CYCLE_COUNTER(FuseObjects);
+	
+	UPrimitiveComponent* SourceComponent = LastFuseOperation.SourceComponent.Get();
+	UPrimitiveComponent* TargetComponent = LastFuseOperation.TargetComponent.Get();
+	// A part of a welded assembly is moved by moving the body it's welded into
+	UPrimitiveComponent* MovedComponent = FusingAssembly.Find(SourceComponent) > 0 ? FusingAssembly.Parts[0].Get() : SourceComponent;
+	if (LastSpawnedConstraintActor && SourceComponent && MovedComponent && TargetComponent && LastFuseOperation.DistanceBetweenSockets < MaxFuseDistance)
 	{
+		// Keep the orientation that's actually being fused to, it's what gets replicated when the fuse ends
 		const FTransform SourceTargetTransform = FindSourceFusableTargetTransform(
-			LastFuseOperationData.IdealSourceComponent, LastFuseOperationData.IdealSoureObjectSocket,
-			LastFuseOperationData.IdealTargetComponent, LastFuseOperationData.IdealTargetObjectSocket);
+			SourceComponent, LastFuseOperation.IdealSockets.SourceSocket,
+			TargetComponent, LastFuseOperation.IdealSockets.TargetSocket, &LastFuseOperation.Orientation);
+		const FTransform MovedTargetTransform = MovedComponent == SourceComponent ? SourceTargetTransform
+			: SourceComponent->GetComponentTransform().GetRelativeTransform(MovedComponent->GetComponentTransform()).Inverse() * SourceTargetTransform;
 
 		// If the total fuse time has exceeded the max before snap, set the location directly
 		if (FuseOperationTime > FuseMaxTimeBeforeSnap)
 		{
-			LastFuseOperationData.IdealSourceComponent->SetWorldLocationAndRotation(SourceTargetTransform.GetLocation(), SourceTargetTransform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
+			MovedComponent->SetWorldLocationAndRotation(MovedTargetTransform.GetLocation(), MovedTargetTransform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
 		}
 		
 		// Check if the interp is done
-        if (SourceTargetTransform.GetLocation().Equals(LastFuseOperationData.IdealSourceComponent->GetComponentLocation(),0.5f) &&
-	        SourceTargetTransform.GetRotation().Equals(FQuat(LastFuseOperationData.IdealSourceComponent->GetComponentRotation()), 0.2f))
+        if (SourceTargetTransform.GetLocation().Equals(SourceComponent->GetComponentLocation(),0.5f) &&
+	        SourceTargetTransform.GetRotation().Equals(FQuat(SourceComponent->GetComponentRotation()), 0.2f))
         {
         	// Ensure that the constraint and physics are set up if we had to interp it without physics
             if (FuseOperationTime > FuseInterpOperationMaxTime)
             {
-	            LastSpawnedConstraintActor->GetConstraintComp()->SetConstrainedComponents(LastFuseOperationData.IdealTargetComponent, "None", LastFuseOperationData.IdealSourceComponent, "None");
-                LastFuseOperationData.IdealSourceComponent->SetSimulatePhysics(true);
-            	LastFuseOperationData.IdealTargetComponent->SetSimulatePhysics(true);
+	            LastSpawnedConstraintActor->GetConstraintComp()->SetConstrainedComponents(TargetComponent, "None", SourceComponent, "None");
+                MovedComponent->SetSimulatePhysics(true);
+            	TargetComponent->SetSimulatePhysics(true);
             }
         	LastSpawnedConstraintActor->GetConstraintComp()->SetAngularTwistLimit(ACM_Limited, 1.0f);
         	LastSpawnedConstraintActor->GetConstraintComp()->SetAngularSwing1Limit(ACM_Limited, 1.0f);
         	LastSpawnedConstraintActor->GetConstraintComp()->SetAngularSwing2Limit(ACM_Limited, 1.0f);
+        	if (FFuseEventJournal::IsEnabled())
+        	{
+        		FFuseJournalEntry Entry = MakeJournalEntry(EFuseJournalEvent::FuseEnd);
+        		Entry.Duration = FuseOperationTime;
+        		Entry.Flags = static_cast<uint8>((FuseOperationTime > FuseInterpOperationMaxTime ? FJF_InterpFallback : FJF_None) |
+        		                                 (FuseOperationTime > FuseMaxTimeBeforeSnap ? FJF_Snapped : FJF_None));
+        		FFuseEventJournal::Record(this, Entry);
+        	}
 			FuseOperationTime = 0.0f;
         	EndFuseObjects();
         	return;
@@ -598,61 +1312,113 @@ void UFFuseComponent::FuseObjects(const float DeltaTime)
 		FuseOperationTime += DeltaTime;
 		// Break constraint
 		LastSpawnedConstraintActor->GetConstraintComp()->BreakConstraint();
-		LastFuseOperationData.IdealSourceComponent->SetSimulatePhysics(false);
+		MovedComponent->SetSimulatePhysics(false);
 		// Lerp the target transform
-        const FVector InterpSourceTargetLocation = FMath::VInterpTo(LastFuseOperationData.IdealSourceComponent->GetComponentLocation(), SourceTargetTransform.GetLocation(), DeltaTime, FuseInterpSpeed);
-        const FRotator InterpSourceTargetRotation = FMath::RInterpTo(LastFuseOperationData.IdealSourceComponent->GetComponentRotation(), SourceTargetTransform.Rotator(), DeltaTime, FuseInterpSpeed);
+        const FVector InterpSourceTargetLocation = FMath::VInterpTo(MovedComponent->GetComponentLocation(), MovedTargetTransform.GetLocation(), DeltaTime, FuseInterpSpeed);
+        const FRotator InterpSourceTargetRotation = FMath::RInterpTo(MovedComponent->GetComponentRotation(), MovedTargetTransform.Rotator(), DeltaTime, FuseInterpSpeed);
         // Set the new transform
-        LastFuseOperationData.IdealSourceComponent->SetWorldLocationAndRotation(InterpSourceTargetLocation, InterpSourceTargetRotation, false, nullptr, ETeleportType::ResetPhysics);
+        MovedComponent->SetWorldLocationAndRotation(InterpSourceTargetLocation, InterpSourceTargetRotation, false, nullptr, ETeleportType::ResetPhysics);
 		
 		// If the total time exceeds the max time, don't reenable the constraint or physics until the interp is done
 		if (FuseOperationTime <= FuseInterpOperationMaxTime)
 		{
 			// Re-constrain the objects
-        	LastSpawnedConstraintActor->GetConstraintComp()->SetConstrainedComponents(LastFuseOperationData.IdealTargetComponent, "None", LastFuseOperationData.IdealSourceComponent, "None");
-        	LastFuseOperationData.IdealSourceComponent->SetSimulatePhysics(true);
+        	LastSpawnedConstraintActor->GetConstraintComp()->SetConstrainedComponents(TargetComponent, "None", SourceComponent, "None");
+        	MovedComponent->SetSimulatePhysics(true);
 			return;
 		}
 		// If the constraint exceeds the max time, disable physics on the target object too to avoid particularly bad physics clipping issues
-		LastFuseOperationData.IdealTargetComponent->SetSimulatePhysics(false); 
+		TargetComponent->SetSimulatePhysics(false); 
+	}
+}
+
+APhysicsConstraintActor* UFFuseComponent::SpawnFuseConstraint(UPrimitiveComponent* SourceComponent,
+	UPrimitiveComponent* TargetComponent, const uint16 TargetSocket) const
+{
+	APhysicsConstraintActor* SpawnedConstraintActor = GetWorld()->SpawnActor<APhysicsConstraintActor>(PhysicsConstraintActor, TargetComponent->GetComponentLocation(), TargetComponent->GetComponentRotation());
+	if (SpawnedConstraintActor)
+	{
+		FUSE_INC_COUNTER(ConstraintsSpawned, 1);
+		SpawnedConstraintActor->GetConstraintComp()->AttachToComponent(TargetComponent, FAttachmentTransformRules::SnapToTargetNotIncludingScale, GetFuseSocketName(TargetComponent, TargetSocket));
+		SpawnedConstraintActor->GetConstraintComp()->SetConstrainedComponents(TargetComponent, "None", SourceComponent, "None");
 	}
+	return SpawnedConstraintActor;
 }
 
 void UFFuseComponent::EndFuseObjects()
 {
 	// Spawn additional physics constraints on supplementary sockets
 	// This only applies to the target component, but could be applied to other objects in the same construction
-	for (const FSupplementalFuseSocketPairs SocketPair : LastFuseOperationData.SupplementalSocketPairs)
+	UPrimitiveComponent* SourceComponent = LastFuseOperation.SourceComponent.Get();
+	UPrimitiveComponent* TargetComponent = LastFuseOperation.TargetComponent.Get();
+	if (FusingAssembly.IsValid())
 	{
-		if (const APhysicsConstraintActor* SpawnedConstraintActor = GetWorld()->SpawnActor<APhysicsConstraintActor>(PhysicsConstraintActor, LastFuseOperationData.IdealTargetComponent->GetComponentLocation(), LastFuseOperationData.IdealTargetComponent->GetComponentRotation()))
+		// The fused part has its own body again, so the fuse constraint is made again on it
+		UnweldAssembly(FusingAssembly);
+		if (LastSpawnedConstraintActor && SourceComponent && TargetComponent)
 		{
-			SpawnedConstraintActor->GetConstraintComp()->AttachToComponent(LastFuseOperationData.IdealTargetComponent, FAttachmentTransformRules::SnapToTargetNotIncludingScale, SocketPair.TargetSocket);
-			SpawnedConstraintActor->GetConstraintComp()->SetConstrainedComponents(LastFuseOperationData.IdealTargetComponent, "None", LastFuseOperationData.IdealSourceComponent, "None");
+			LastSpawnedConstraintActor->GetConstraintComp()->SetConstrainedComponents(TargetComponent, "None", SourceComponent, "None");
 		}
 	}
+	for (const FFuseSocketPair& SocketPair : LastFuseOperation.SupplementalPairs)
+	{
+		SpawnFuseConstraint(SourceComponent, TargetComponent, SocketPair.TargetSocket);
+	}
+	if (GetNetMode() != NM_Standalone) { ReplicateFuse(); }
 	ClearFuseOperationData();
+	LatencyMarks.Resolve(EFuseLatencyEvent::Fuse);
     // Reset fuse state
     UpdateFuserState(FSTATE_NONE);
 }
 
 bool UFFuseComponent::TryDetachGrabbedComponent()
 {
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		if (HeldComponent) { ServerTryDetachGrabbedComponent(); }
+		return false;
+	}
+	if (GetCurrentFuseState() == FSTATE_FUSING && GetGrabbedComponent())
+	{
+		const bool bBroken = BreakFuseConstraints(GetGrabbedComponent());
+		// Clients have their own copies of the constraints, see OnRep_LastNetFuse
+		if (GetNetMode() != NM_Standalone) { MulticastBreakFuseConstraints(GetGrabbedComponent()); }
+		// Clients that join or become relevant later mustn't rebuild a fuse that's been broken
+		if (LastNetFuse.SourceComponent == GetGrabbedComponent() || LastNetFuse.TargetComponent == GetGrabbedComponent())
+		{
+			LastNetFuse = FFuseNetOperation(FFuseOperation(), LastNetFuse.FuseId + 1);
+		}
+		if (FFuseEventJournal::IsEnabled()) { FFuseEventJournal::Record(this, MakeJournalEntry(EFuseJournalEvent::Detach)); }
+		return bBroken;
+	}
+	return false;
+}
+
+void UFFuseComponent::MulticastBreakFuseConstraints_Implementation(UPrimitiveComponent* Component)
+{
+	// The server broke its own in TryDetachGrabbedComponent
+	if (GetOwnerRole() != ROLE_Authority) { BreakFuseConstraints(Component); }
+}
+
+bool UFFuseComponent::BreakFuseConstraints(UPrimitiveComponent* Component)
+{
+	bool bBroken = false;
 	// Finds the nearby fusable components, gets the attached constraints and searches through them to try find this component in its constraints
 	// Not an ideal solution, would be redesigned so that constraints components are part of a large actor so that the components and their relationships could be easily searched through
-	if (GetCurrentFuseState() == FSTATE_FUSING && GetGrabbedComponent())
+	if (Component)
 	{
 		TArray<AActor*> AttachedActors;
-		// Get attached actors for the grabbed comp
-		GetGrabbedComponent()->GetOwner()->GetAttachedActors(AttachedActors);
+		// Get attached actors for the component
+		Component->GetOwner()->GetAttachedActors(AttachedActors);
 		// Get attached actors for nearby comps
 		TArray<FHitResult> HitResults;
-		const FVector TraceLocation =  GetGrabbedComponent()->GetComponentLocation();
+		const FVector TraceLocation =  Component->GetComponentLocation();
 		FCollisionObjectQueryParams ObjectQueryParams;
 		ObjectQueryParams.AddObjectTypesToQuery(ECC_PhysicsBody);
 		FCollisionQueryParams CollisionParams;
-		CollisionParams.AddIgnoredComponent(GetGrabbedComponent());
+		CollisionParams.AddIgnoredComponent(Component);
 		FCollisionShape CollisionShape;
-		const float TraceRadius = GetGrabbedComponent()->GetLocalBounds().SphereRadius + 10.0f;
+		const float TraceRadius = Component->GetLocalBounds().SphereRadius + 10.0f;
 		CollisionShape.SetSphere(TraceRadius);
 
 		if (GetWorld()->SweepMultiByObjectType(
@@ -677,72 +1443,560 @@ bool UFFuseComponent::TryDetachGrabbedComponent()
 		{
 			if (APhysicsConstraintActor* ConstraintActor = Cast<APhysicsConstraintActor>(AttachedActor))
 			{
-				// Get both the constrained components and break the constraint if either match the grabbed component
+				// Replicated constraint actors are only destroyed by the server
+				if (ConstraintActor->GetIsReplicated() && !ConstraintActor->HasAuthority()) { continue; }
+				
+				// Get both the constrained components and break the constraint if either match the component
 				UPrimitiveComponent* ConstrainedCompA;
 				FName ConstrainedCompASocket;
 				UPrimitiveComponent* ConstrainedCompB;
 				FName ConstrainedCompBSocket;
 				ConstraintActor->GetConstraintComp()->GetConstrainedComponents(ConstrainedCompA, ConstrainedCompASocket, ConstrainedCompB, ConstrainedCompBSocket);
-				if (GetGrabbedComponent() == ConstrainedCompA || GetGrabbedComponent() == ConstrainedCompB)
+				if (Component == ConstrainedCompA || Component == ConstrainedCompB)
 				{
 					ConstraintActor->GetConstraintComp()->BreakConstraint();
                 	ConstraintActor->Destroy();	
+					bBroken = true;
 				}
 
 			}
 		}
 	}
-	return false;
+	return bBroken;
 }
 
 void UFFuseComponent::ClearFuseOperationData()
 {
-	FFuseOperationData ClearedOperationData;
-	LastFuseOperationData = ClearedOperationData;
+	LastFuseOperation.Reset();
+}
+
+FName UFFuseComponent::GetFuseSocketName(const UPrimitiveComponent* Component, const uint16 SocketIndex) const
+{
+	const FFuseSocketTable& Sockets = FFuseSocketTable::Get(Component, FusableSocketSubName);
+	return Sockets.GetSockets().IsValidIndex(SocketIndex) ? Sockets[SocketIndex].Name : NAME_None;
+}
+
+TArray<FFuseOperationData> UFFuseComponent::GetFuseCandidates() const
+{
+	TArray<FFuseOperationData> Candidates;
+	for (int32 CandidateIndex = 0; CandidateIndex < FuseCandidates.Num(); CandidateIndex++)
+	{
+		const FFuseCandidate& Candidate = FuseCandidates.Candidates[CandidateIndex];
+		if (CandidateIndex == FuseCandidates.ActiveIndex && LastFuseOperation.IsValid())
+		{
+			Candidates.Add(GetFuseOperationData());
+			continue;
+		}
+		Candidates.Add(MakeFuseOperationData(Candidate.SourceComponent.Get(), Candidate.TargetComponent.Get(), Candidate.Sockets, Candidate.Distance));
+	}
+	return Candidates;
+}
+
+bool UFFuseComponent::CycleFuseCandidate(const int32 Step)
+{
+	if (!GetGrabbedComponent() || CurrentFuserState != FSTATE_FUSING || FuseCandidates.Num() < 2) { return false; }
+	
+	const int32 NumCandidates = FuseCandidates.Num();
+	const int32 ActiveIndex = FMath::Max(FuseCandidates.ActiveIndex, 0);
+	FuseCandidates.ActiveIndex = ((ActiveIndex + Step) % NumCandidates + NumCandidates) % NumCandidates;
+	FuseCandidates.PinnedCandidate = FuseCandidates.Candidates[FuseCandidates.ActiveIndex];
+	ClearFuseOperationData();
+	ApplyActiveFuseCandidate(LastFuseOperation);
+	
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		const FFuseCandidate& Pinned = FuseCandidates.PinnedCandidate;
+		ServerSelectFuseCandidate(Pinned.SourceComponent.Get(), Pinned.TargetComponent.Get(), Pinned.TargetInstance,
+		                          Pinned.Sockets.SourceSocket, Pinned.Sockets.TargetSocket);
+	}
+	return true;
+}
+
+FFuseOperationData UFFuseComponent::MakeFuseOperationData(const UPrimitiveComponent* SourceComponent, const UPrimitiveComponent* TargetComponent,
+                                                          const FFuseSocketPair& Sockets, const float Distance) const
+{
+	FFuseOperationData OperationData;
+	OperationData.bHasValidFuse = Sockets.IsValid() && TargetComponent;
+	OperationData.DistanceBetweenSockets = Distance;
+	OperationData.IdealSourceComponent = const_cast<UPrimitiveComponent*>(SourceComponent ? SourceComponent : GetGrabbedComponent());
+	OperationData.IdealTargetComponent = const_cast<UPrimitiveComponent*>(TargetComponent);
+	OperationData.IdealSoureObjectSocket = GetFuseSocketName(OperationData.IdealSourceComponent, Sockets.SourceSocket);
+	OperationData.IdealTargetObjectSocket = GetFuseSocketName(TargetComponent, Sockets.TargetSocket);
+	return OperationData;
+}
+
+FFuseOperationData UFFuseComponent::GetFuseOperationData() const
+{
+	FFuseOperationData OperationData;
+	OperationData.bHasValidFuse = LastFuseOperation.IsValid();
+	OperationData.DistanceBetweenSockets = LastFuseOperation.DistanceBetweenSockets;
+	OperationData.IdealSourceComponent = LastFuseOperation.SourceComponent.Get();
+	OperationData.IdealTargetComponent = LastFuseOperation.TargetComponent.Get();
+	
+	// Before the fuse starts the source is whatever is being held
+	const UPrimitiveComponent* SourceComponent = OperationData.IdealSourceComponent ? OperationData.IdealSourceComponent : GetGrabbedComponent();
+	OperationData.IdealSoureObjectSocket = GetFuseSocketName(SourceComponent, LastFuseOperation.IdealSockets.SourceSocket);
+	OperationData.IdealTargetObjectSocket = GetFuseSocketName(OperationData.IdealTargetComponent, LastFuseOperation.IdealSockets.TargetSocket);
+	for (const FFuseSocketPair& SocketPair : LastFuseOperation.SupplementalPairs)
+	{
+		FSupplementalFuseSocketPairs& SupplementalPair = OperationData.SupplementalSocketPairs.AddDefaulted_GetRef();
+		SupplementalPair.SourceSocket = GetFuseSocketName(SourceComponent, SocketPair.SourceSocket);
+		SupplementalPair.TargetSocket = GetFuseSocketName(OperationData.IdealTargetComponent, SocketPair.TargetSocket);
+	}
+	return OperationData;
+}
+
+FFuseJournalEntry UFFuseComponent::MakeJournalEntry(const EFuseJournalEvent Event) const
+{
+	FFuseJournalEntry Entry;
+	Entry.Time = GetWorld()->GetTimeSeconds();
+	Entry.Fuser = GetUniqueID();
+	Entry.Event = Event;
+	Entry.PreviousState = static_cast<uint8>(GetCurrentFuseState());
+	Entry.State = static_cast<uint8>(GetCurrentFuseState());
+	Entry.Candidates = static_cast<uint16>(FuseCandidates.Candidates.Num());
+	if (LastFuseOperation.IsValid())
+	{
+		Entry.SourceSocket = LastFuseOperation.IdealSockets.SourceSocket;
+		Entry.TargetSocket = LastFuseOperation.IdealSockets.TargetSocket;
+	}
+	return Entry;
 }
 
 bool UFFuseComponent::GetFuseComponentDebugState()
 {
-	return CVarDrawDebugFuser.GetValueOnGameThread();
+	return FFuseDebugDraw::IsEnabled();
 }
 
 
 
-FRotator UFFuseComponent::GetOwnerControlRotation() const
+/* Replication */
+
+bool UFFuseComponent::IsLocalFuser() const
 {
-	return OwningCharacterController->GetControlRotation();
+	// The server drives its own players and bots, a client drives its own player
+	return GetOwnerRole() == ROLE_AutonomousProxy ||
+	       (GetOwnerRole() == ROLE_Authority && GetOwner()->GetRemoteRole() != ROLE_AutonomousProxy);
 }
 
-FRotator UFFuseComponent::GetOwnerControlRotationYaw() const
+void UFFuseComponent::OnRep_CurrentFuserState(const TEnumAsByte<EFuserState> PreviousState)
 {
-	FRotator PlayerXYControlRot = GetOwnerControlRotation();
- 	PlayerXYControlRot.Pitch = 0.0f;
- 	PlayerXYControlRot.Roll = 0.0f;
- 	return PlayerXYControlRot;
+	OnFuserStateChanged.Broadcast(GetCurrentFuseState(), PreviousState);
+}
+
+void UFFuseComponent::OnRep_HeldComponent(UPrimitiveComponent* PreviousHeldComponent)
+{
+	if (!IsLocalFuser()) { return; }
+	
+	// Drop the local grab of whatever the server has stopped holding
+	if (GetGrabbedComponent() && GetGrabbedComponent() != HeldComponent) { ReleaseComponent(); }
+	UpdateHeldVisuals(PreviousHeldComponent, false);
+	if (!HeldComponent) { return; }
+	
+	// Predict the held component from here on, starting from the targets the server's grab started from
+	InitHeldTargets(HeldComponent);
+	GrabComponentAtLocationWithRotation(HeldComponent, "None", HeldComponent->GetComponentLocation(), HeldComponent->GetComponentRotation());
+	SyncHeldAssembly();
+	PendingHeldInputs.Reset();
+	SentHeldInputs = 0;
+	PredictedLocations.Reset();
+	PredictionCorrectionOffset = FVector::ZeroVector;
+	PreviewMismatches = 0;
+	bAwaitingGrabState = true;
+	UpdateHeldVisuals(HeldComponent, true);
+	ClearFuseOperationData();
+	TryFindIdealFuseSockets(LastFuseOperation);
+	OwnerCameraRotCached = GetOwnerControlRotation();
+	ReconcileHeldState();
+}
+
+void UFFuseComponent::UpdateHeldVisuals(UPrimitiveComponent* Component, const bool bHeld)
+{
+	// Projection actors are pooled, along with their captures, decals and render targets
+	if (LastSpawnedOrthoProjectionActor)
+	{
+		FFuseActorPool::Release(LastSpawnedOrthoProjectionActor);
+		LastSpawnedOrthoProjectionActor = nullptr;
+	}
+	if (!Component) { return; }
+	
+	Component->SetRenderCustomDepth(bHeld);
+	Component->SetCustomDepthStencilValue(bHeld ? 1 : 0);
+	Component->SetCustomPrimitiveDataFloat(0, bHeld ? 1.0f : 0.0f);
+	Component->SetReceivesDecals(true);
+	if (bHeld && OrthographicProjectionActor)
+	{
+		LastSpawnedOrthoProjectionActor = FFuseActorPool::Acquire(GetWorld(), OrthographicProjectionActor,
+		                                                          FTransform(GetOwnerControlRotationYaw(), Component->GetComponentLocation()));
+		Component->SetReceivesDecals(false);
+	}
+}
+
+void UFFuseComponent::UpdateOrthoProjectionActor() const
+{
+	// Update location and rotation of orthographic projection actor
+	if (LastSpawnedOrthoProjectionActor && HeldComponent)
+	{
+		LastSpawnedOrthoProjectionActor->SetActorLocationAndRotation(HeldComponent->GetComponentLocation(), GetOwnerControlRotationYaw());
+	}
+}
+
+void UFFuseComponent::ReplicateFuse()
+{
+	LastNetFuse = FFuseNetOperation(LastFuseOperation, LastNetFuse.FuseId + 1);
+	
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	FFuseNetStats::RecordFuse(LastNetFuse.CalcNetBits(NetDriver),
+	                          LastNetFuse.CalcUnquantizedBits(NetDriver,
+	                                                          FFuseSocketTable::Get(LastNetFuse.SourceComponent, FusableSocketSubName),
+	                                                          FFuseSocketTable::Get(LastNetFuse.TargetComponent, FusableSocketSubName)));
+}
+
+void UFFuseComponent::OnRep_LastNetFuse()
+{
+	/*
+	 * Rebuild the server's fuse from socket indices and the orientation index
+	 * The source is placed where the sockets meet and the constraints are spawned locally, since constraint actors
+	 * don't replicate by default. Replicated movement keeps the pieces in line with the server afterwards
+	 */
+	if (!LastNetFuse.IsValid()) { return; }
+	UPrimitiveComponent* SourceComponent = LastNetFuse.SourceComponent;
+	UPrimitiveComponent* TargetComponent = LastNetFuse.TargetComponent;
+	const FFuseSocketTable& SourceSockets = FFuseSocketTable::Get(SourceComponent, FusableSocketSubName);
+	const FFuseSocketTable& TargetSockets = FFuseSocketTable::Get(TargetComponent, FusableSocketSubName);
+	const FFuseOrientationTable& Orientations = GetOrientationTable();
+	if (LastNetFuse.IdealSockets.SourceSocket >= SourceSockets.Num() || LastNetFuse.IdealSockets.TargetSocket >= TargetSockets.Num() ||
+	    LastNetFuse.Orientation >= Orientations.Num())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Replicated fuse of %s to %s doesn't match the local socket tables"),
+		       *SourceComponent->GetName(), *TargetComponent->GetName());
+		return;
+	}
+	
+	const FTransform SourceTargetTransform = FFuseTargetTransforms::ComputeForOrientation(
+		SourceComponent->GetComponentScale(), SourceSockets[LastNetFuse.IdealSockets.SourceSocket],
+		TargetComponent->GetComponentTransform(), TargetSockets[LastNetFuse.IdealSockets.TargetSocket],
+		Orientations, LastNetFuse.Orientation);
+	SourceComponent->SetWorldLocationAndRotation(SourceTargetTransform.GetLocation(), SourceTargetTransform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
+	
+	// A replicated constraint actor arrives from the server on its own
+	if (PhysicsConstraintActor && PhysicsConstraintActor.GetDefaultObject()->GetIsReplicated()) { return; }
+	if (APhysicsConstraintActor* ConstraintActor = SpawnFuseConstraint(SourceComponent, TargetComponent, LastNetFuse.IdealSockets.TargetSocket))
+	{
+		ConstraintActor->GetConstraintComp()->SetAngularTwistLimit(ACM_Limited, 1.0f);
+		ConstraintActor->GetConstraintComp()->SetAngularSwing1Limit(ACM_Limited, 1.0f);
+		ConstraintActor->GetConstraintComp()->SetAngularSwing2Limit(ACM_Limited, 1.0f);
+	}
+	for (const FFuseSocketPair& SocketPair : LastNetFuse.SupplementalPairs)
+	{
+		if (SocketPair.TargetSocket < TargetSockets.Num()) { SpawnFuseConstraint(SourceComponent, TargetComponent, SocketPair.TargetSocket); }
+	}
+}
+
+bool UFFuseComponent::IsWithinGrabReach(const UPrimitiveComponent* Component) const
+{
+	// The server's view of the owner lags the client's a little, so this only rejects grabs the search couldn't have made
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	GetFuseViewPoint(ViewLocation, ViewRotation);
+	const FBoxSphereBounds& Bounds = Component->Bounds;
+	const FVector AimPoint = FMath::ClosestPointOnSegment(Bounds.Origin, ViewLocation, ViewLocation + ViewRotation.Vector() * SearchTraceDistance);
+	const float AimSlack = FVector::Distance(ViewLocation, AimPoint) * FMath::Tan(FMath::DegreesToRadians(GrabReachAimSlack));
+	if (FVector::Distance(AimPoint, Bounds.Origin) - Bounds.SphereRadius > SearchTraceRadius + AimSlack) { return false; }
+	
+	// The search sweeps for physics bodies, so only something blocking the view in between hides the component
+	FCollisionQueryParams CollisionParams(SCENE_QUERY_STAT(FuseGrabReach));
+	CollisionParams.AddIgnoredActor(GetOwner());
+	CollisionParams.AddIgnoredActor(Component->GetOwner());
+	FHitResult BlockingHit;
+	return !GetWorld()->LineTraceSingleByChannel(BlockingHit, ViewLocation, Bounds.Origin, ECC_Visibility, CollisionParams);
+}
+
+void UFFuseComponent::SetClientPredictsHeldComponent(UPrimitiveComponent* Component, const bool bPredicted)
+{
+	// Owning the held actor makes it an autonomous proxy on the fuser's client, which is what the physics
+	// replication checks before sending it the server's state
+	AActor* HeldActor = Component->GetOwner();
+	if (!HeldActor || !HeldActor->GetIsReplicated()) { return; }
+	if (bPredicted)
+	{
+		HeldActorPreviousOwner = HeldActor->GetOwner();
+		HeldActor->SetOwner(GetOwner());
+	}
+	else
+	{
+		HeldActor->SetOwner(HeldActorPreviousOwner);
+		HeldActorPreviousOwner = nullptr;
+	}
+	HeldActor->SetAutonomousProxy(bPredicted);
+	Component->bReplicatePhysicsToAutonomousProxy = !bPredicted;
+}
+
+void UFFuseComponent::UpdateHeldState()
+{
+	HeldState.TargetDistance = GrabbedComponentTargetDistance;
+	HeldState.TargetHeight = GrabbedComponentTargetHeight;
+	HeldState.LocalOrientation = GrabbedComponentLocalOrientation;
+	HeldState.LocalRotation = GrabbedComponentLocalRotation;
+	HeldState.Location = GetGrabbedComponent()->GetComponentLocation();
+	HeldState.Preview = FFuseNetOperation(LastFuseOperation, 0);
+}
+
+void UFFuseComponent::OnRep_HeldState()
+{
+	SyncHeldAssembly();
+	ReconcileHeldState();
+}
+
+void UFFuseComponent::SendHeldInput(FFuseHeldInput Input)
+{
+	if (!HeldComponent) { return; }
+	
+	// Past the limit the oldest inputs are forgotten, and replays are approximate until the server catches up
+	Input.Sequence = ++SentHeldInputs;
+	if (PendingHeldInputs.Num() == MaxPendingHeldInputs)
+	{
+		PendingHeldInputs.RemoveAt(0, 1, false);
+		FFusePredictionStats::RecordDroppedInput();
+	}
+	PendingHeldInputs.Add(Input);
+}
+
+void UFFuseComponent::SendPendingHeldInputs()
+{
+	// Inputs made before the grab's first state are sent once the client knows which grab they're for
+	if (!HeldComponent || bAwaitingGrabState || PendingHeldInputs.Num() == 0) { return; }
+	ServerApplyHeldInputs(HeldState.GrabId, PendingHeldInputs);
+}
+
+void UFFuseComponent::ReconcileHeldState()
+{
+	/*
+	 * Replays the inputs the server hasn't applied yet on top of its held targets, and compares the result with the
+	 * prediction. Location errors are eased out through PredictionCorrectionOffset rather than snapped, unless they're
+	 * too large, and a fuse preview that keeps disagreeing with the server's is replaced by it
+	 */
+	UPrimitiveComponent* PredictedComponent = GetGrabbedComponent();
+	if (GetOwnerRole() == ROLE_Authority || !PredictedComponent || PredictedComponent != HeldComponent) { return; }
+	
+	// States from before the grab arrived are for the last held component
+	const bool bNewGrab = HeldState.GrabId != ReconciledGrabId;
+	if (bAwaitingGrabState && !bNewGrab) { return; }
+	
+	const uint16 AppliedInputs = HeldState.InputSequence;
+	PendingHeldInputs.RemoveAll([AppliedInputs](const FFuseHeldInput& Input)
+	{
+		return static_cast<int16>(Input.Sequence - AppliedInputs) <= 0;
+	});
+	
+	const float PredictedDistance = GrabbedComponentTargetDistance;
+	const float PredictedHeight = GrabbedComponentTargetHeight;
+	const uint16 PredictedOrientation = GrabbedComponentLocalOrientation;
+	GrabbedComponentTargetDistance = HeldState.TargetDistance;
+	GrabbedComponentTargetHeight = HeldState.TargetHeight;
+	GrabbedComponentLocalOrientation = HeldState.LocalOrientation;
+	GrabbedComponentLocalRotation = HeldState.LocalRotation;
+	for (const FFuseHeldInput& Input : PendingHeldInputs) { ApplyHeldInput(Input); }
+	
+	// The first state of a grab replaces the targets the client guessed at, it isn't a misprediction
+	if (bNewGrab)
+	{
+		ReconciledGrabId = HeldState.GrabId;
+		bAwaitingGrabState = false;
+		return;
+	}
+	FFusePredictionStats::RecordServerUpdate();
+	
+	const float InputError = FMath::Abs(GrabbedComponentTargetDistance - PredictedDistance) + FMath::Abs(GrabbedComponentTargetHeight - PredictedHeight);
+	const bool bOrientationCorrected = GrabbedComponentLocalOrientation != PredictedOrientation;
+	if (InputError > 1.0f || bOrientationCorrected) { FFusePredictionStats::RecordInputCorrection(InputError, bOrientationCorrected); }
+	
+	// The server's location is from a round trip ago, so compare it with the nearest of the client's since then
+	const UNetConnection* NetConnection = GetOwner()->GetNetConnection();
+	const double OldestMatchTime = GetWorld()->GetRealTimeSeconds() - (NetConnection ? NetConnection->AvgLag : 0.0) - 2.0 * GetDeltaFuseTickTime();
+	FVector LocationError = FVector(HeldState.Location) - PredictedComponent->GetComponentLocation();
+	for (const FPredictedLocation& Predicted : PredictedLocations)
+	{
+		const FVector Error = FVector(HeldState.Location) - Predicted.Location;
+		if (Predicted.Time >= OldestMatchTime && Error.SizeSquared() < LocationError.SizeSquared()) { LocationError = Error; }
+	}
+	const float LocationErrorSize = LocationError.Size();
+	if (LocationErrorSize > PredictionSnapDistance)
+	{
+		PredictedComponent->SetWorldLocation(HeldState.Location, false, nullptr, ETeleportType::TeleportPhysics);
+		PredictionCorrectionOffset = FVector::ZeroVector;
+		PredictedLocations.Reset();
+		FFusePredictionStats::RecordPositionCorrection(LocationErrorSize);
+	}
+	else if (LocationErrorSize > PredictionCorrectionThreshold)
+	{
+		PredictionCorrectionOffset = LocationError;
+		FFusePredictionStats::RecordPositionCorrection(LocationErrorSize);
+	}
+	
+	// Previews are only comparable once the server has every input, and one disagreement can just be timing
+	if (PendingHeldInputs.Num() == 0)
+	{
+		const bool bPreviewMatches = HeldState.Preview.TargetComponent == LastFuseOperation.TargetComponent.Get() &&
+		                             HeldState.Preview.SourceComponent == LastFuseOperation.SourceComponent.Get() &&
+		                             HeldState.Preview.IdealSockets == LastFuseOperation.IdealSockets;
+		PreviewMismatches = bPreviewMatches ? 0 : PreviewMismatches + 1;
+		if (PreviewMismatches >= 2)
+		{
+			HeldState.Preview.ToOperation(LastFuseOperation);
+			PreviewMismatches = 0;
+			FFusePredictionStats::RecordPreviewCorrection();
+		}
+	}
 }
 
-FRotator UFFuseComponent::RotateRotator(FRotator RotA, FRotator RotB)
+void UFFuseComponent::ServerTryStartSearching_Implementation()
 {
-	return FRotator(FQuat(RotA) * FQuat(RotB));
+	FFuseNetStats::RecordIntent(0);
+	TryStartSearching();
 }
 
-FRotator UFFuseComponent::InverseRotateRotator(FRotator RotA, FRotator RotB)
+void UFFuseComponent::ServerTryStopSearching_Implementation()
 {
-	return FRotator(FQuat(RotA.GetInverse()) * FQuat(RotB));
+	FFuseNetStats::RecordIntent(0);
+	TryStopSearching();
 }
 
-float UFFuseComponent::RoundFloatToNearestMultiple(float Value, float Multiple) const
+void UFFuseComponent::ServerTryGrabTargetedFusable_Implementation(UPrimitiveComponent* TargetComponent)
 {
-	return FMath::RoundToFloat(Value/Multiple) * Multiple;
+	FFuseNetStats::RecordIntent(FFuseNetOperation::CalcObjectBits(GetWorld()->GetNetDriver(), TargetComponent));
+	if (CurrentFuserState != FSTATE_SEARCHING || !IsComponentFusable(TargetComponent)) { return; }
+	
+	// Run the same search from the server's view of the owner, and fall back to the client's pick if it's within reach
+	SearchForFusable();
+	if (LastSearchHitResult.GetComponent() != TargetComponent)
+	{
+		if (!IsWithinGrabReach(TargetComponent)) { return; }
+		LastSearchHitResult.Component = TargetComponent;
+		// The client's instance index isn't sent, so an instanced pick has to be found by the server's own search
+		LastSearchHitResult.Item = INDEX_NONE;
+	}
+	TryGrabTargetedFusable();
 }
 
-FRotator UFFuseComponent::RoundRotatorToNearestMultiple(FRotator InRotator, float Multiple) const
+void UFFuseComponent::ServerApplyHeldInputs_Implementation(const uint8 GrabId, const TArray<FFuseHeldInput>& Inputs)
 {
-	const FRotator OldRot = InRotator;
-	FRotator NewRot;
-	NewRot.Pitch = RoundFloatToNearestMultiple(OldRot.Pitch, Multiple);
-	NewRot.Yaw = RoundFloatToNearestMultiple(OldRot.Yaw, Multiple);
-	NewRot.Roll = RoundFloatToNearestMultiple(OldRot.Roll, Multiple);
-	return NewRot;
+	int32 InputBits = 8;
+	for (const FFuseHeldInput& Input : Inputs) { InputBits += Input.GetNetBits(); }
+	FFuseNetStats::RecordIntent(InputBits);
+	// Inputs that arrive after the release or the next grab belong to the last grab, applying them would put this one out of step
+	if (!GetGrabbedComponent() || GrabId != HeldState.GrabId) { return; }
+	
+	for (const FFuseHeldInput& Input : TConstArrayView<FFuseHeldInput>(Inputs.GetData(), FMath::Min(Inputs.Num(), MaxPendingHeldInputs)))
+	{
+		// Inputs the client dropped past its limit leave a gap, they're skipped on both sides
+		if (static_cast<int16>(Input.Sequence - HeldState.InputSequence) <= 0) { continue; }
+		switch (Input.Type)
+		{
+		case EFuseHeldInputType::Distance:
+			AdjustGrabbedComponentTargetDistance(Input.X);
+			break;
+		case EFuseHeldInputType::Rotation:
+			AdjustGrabbedComponentTargetRotation(Input.X, Input.Y);
+			break;
+		case EFuseHeldInputType::Height:
+			AdjustGrabbedComponentTargetHeight(Input.X);
+			break;
+		}
+		HeldState.InputSequence = Input.Sequence;
+	}
 }
 
+void UFFuseComponent::ServerTryFuseObjects_Implementation()
+{
+	FFuseNetStats::RecordIntent(0);
+	if (!GetGrabbedComponent()) { return; }
+	
+	// The held update only searches when the view turns, so search again with where the held component is now
+	const bool bPinned = FuseCandidates.PinnedCandidate.IsValid();
+	ClearFuseOperationData();
+	TryFindIdealFuseSockets(LastFuseOperation, true);
+	// A picked candidate the search no longer finds is unpinned, and isn't swapped for another the player didn't pick
+	if (bPinned && !FuseCandidates.PinnedCandidate.IsValid()) { return; }
+	TryFuseObjects();
+}
+
+void UFFuseComponent::ServerSelectFuseCandidate_Implementation(UPrimitiveComponent* SourceComponent, UPrimitiveComponent* TargetComponent,
+                                                               const int32 TargetInstance, const uint16 SourceSocket, const uint16 TargetSocket)
+{
+	FFuseNetStats::RecordIntent(FFuseNetOperation::CalcObjectBits(GetWorld()->GetNetDriver(), SourceComponent)
+	                            + FFuseNetOperation::CalcObjectBits(GetWorld()->GetNetDriver(), TargetComponent) + 64);
+	if (!GetGrabbedComponent() || !SourceComponent || !TargetComponent) { return; }
+	
+	// Only ever picks between candidates the server's own search found
+	FFuseCandidate Picked;
+	Picked.SourceComponent = SourceComponent;
+	Picked.TargetComponent = TargetComponent;
+	Picked.TargetInstance = TargetInstance;
+	Picked.Sockets = {SourceSocket, TargetSocket};
+	FuseCandidates.PinnedCandidate = Picked;
+	// The server's set can be older than the client's, a pick it hasn't found yet stays pinned for its next search
+	if (FuseCandidates.Find(Picked) == INDEX_NONE) { return; }
+	FuseCandidates.UpdateActive(FFuseCandidate(), 0.0f, false);
+	ClearFuseOperationData();
+	ApplyActiveFuseCandidate(LastFuseOperation);
+}
+
+void UFFuseComponent::ServerTryDetachGrabbedComponent_Implementation()
+{
+	FFuseNetStats::RecordIntent(0);
+	TryDetachGrabbedComponent();
+}
+
+bool UFFuseComponent::ResolveOwningController()
+{
+	if (const APawn* OwningPawn = Cast<APawn>(GetOwner()))
+	{
+		OwningController = OwningPawn->GetController();
+	}
+	return OwningController != nullptr;
+}
+
+bool UFFuseComponent::GetFuseViewPoint(FVector& OutLocation, FRotator& OutRotation) const
+{
+	if (const IFFuseViewPointProvider* Provider = ViewPointProvider.GetInterface())
+	{
+		Provider->GetFuseViewPoint(OutLocation, OutRotation);
+		return true;
+	}
+	if (OwningController)
+	{
+		OwningController->GetPlayerViewPoint(OutLocation, OutRotation);
+		return true;
+	}
+	OutLocation = GetOwner()->GetActorLocation();
+	OutRotation = GetOwner()->GetActorRotation();
+	return false;
+}
+
+FRotator UFFuseComponent::GetOwnerControlRotation() const
+{
+	// Providers don't have a separate control rotation, so the view rotation is used for both
+	if (const IFFuseViewPointProvider* Provider = ViewPointProvider.GetInterface())
+	{
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		Provider->GetFuseViewPoint(ViewLocation, ViewRotation);
+		return ViewRotation;
+	}
+	return OwningController ? OwningController->GetControlRotation() : GetOwner()->GetActorRotation();
+}
+
+FRotator UFFuseComponent::GetOwnerControlRotationYaw() const
+{
+	FRotator PlayerXYControlRot = GetOwnerControlRotation();
+ 	PlayerXYControlRot.Pitch = 0.0f;
+ 	PlayerXYControlRot.Roll = 0.0f;
+ 	return PlayerXYControlRot;
+}
+
+const FFuseOrientationTable& UFFuseComponent::GetOrientationTable() const
+{
+	// Components driven before begin play (eg. by the benchmark) look the table up each time
+	return OrientationTable ? *OrientationTable : FFuseOrientationTable::Get(ComponentRotationMultiplier);
+}
@@ -4,8 +4,17 @@
 #include "CoreMinimal.h"
 #include "PhysicsEngine/PhysicsHandleComponent.h"
 #include "PhysicsEngine/PhysicsConstraintActor.h"
+#include "Engine/OverlapResult.h"
+#include "FFuseViewPointProvider.h"
+#include "FuseEventJournal.h"
+#include "FuseLatencyTracker.h"
+#include "FuseOperation.h"
+#include "FuseNetPrediction.h"
+#include "FuseOrientationTable.h"
 #include "FFuseComponent.generated.h"
 
+class FFuseSocketTable;
+
 // Enum for tracking the current state of the fuser (owning character)
 UENUM(BlueprintType)
 enum EFuserState
@@ -31,6 +40,7 @@ struct FSupplementalFuseSocketPairs
 };
 
 // Struct for containing data on potential fuse operations
+// Blueprint view of an FFuseOperation, built on demand by UFFuseComponent::GetFuseOperationData
 USTRUCT(BlueprintType)
 struct FFuseOperationData
 {
@@ -71,6 +81,11 @@ class FUSE_API UFFuseComponent : public UPhysicsHandleComponent
 {
 	GENERATED_BODY()
 
+public:
+	UFFuseComponent();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
@@ -103,6 +118,7 @@ public:
 	// Try and grab the targeted fusable component
 	// Requires fuser state to be Searching
 	// If successful, will change fuser state to Fusing
+	// On clients this asks the server to grab it, and the state changes when the server's grab replicates
 	UFUNCTION(BlueprintCallable, Category = "Fuse")
 	bool TryGrabTargetedFusable();
 
@@ -120,15 +136,34 @@ public:
 	void AdjustGrabbedComponentTargetHeight(float Delta);
 
 	// Try to find and fuse a held object with an adjacent object
+	// On clients the server searches for the sockets again and fuses them, the result replicates to every client
 	UFUNCTION(BlueprintCallable, Category = "Fuse")
 	bool TryFuseObjects();
 
-	// Get the state of cvar f.drawdebugfuser for drawing additional fuse component debug info
+	// Is fuse component debug output being drawn or captured, see f.drawdebugfuser. Always false in shipping builds
 	UFUNCTION(BlueprintPure, Category = "Fuse")
 	static bool GetFuseComponentDebugState();
 
+	// Break the fuse constraints on the grabbed component, true if any were broken. Clients ask the server and return false
 	UFUNCTION(BlueprintCallable, Category = "Fuse")
 	bool TryDetachGrabbedComponent();
+
+	// Override the view point used to search for and hold fusables
+	// By default a provider on the owner is found at begin play, otherwise the owner's controller is used
+	void SetViewPointProvider(TScriptInterface<IFFuseViewPointProvider> NewViewPointProvider);
+
+	// Does the component have any sockets containing FusableSocketSubName
+	bool IsComponentFusable(const UPrimitiveComponent* Component) const;
+
+	// Is the component held or part of a fuse in progress, so nothing else should move or freeze it
+	bool IsComponentInUse(const UPrimitiveComponent* Component) const;
+
+	// Every component IsComponentInUse is true for
+	void GetComponentsInUse(TArray<UPrimitiveComponent*>& OutComponents) const;
+
+	// Let go of whatever is held, or stop a fuse in progress without joining the parts, on the server
+	// For when the components are about to be removed from under the fuser, like a cell unloading
+	void AbortFuse();
 	
 #pragma endregion
 
@@ -165,13 +200,23 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "Fuse", meta = (ClampMin = 1.0f, ClampMax = 50.0f))
 	float SearchTraceRadius = 16.0f;
 
+	// Degrees a client's aim may be off the server's view of it when the server checks a grab it didn't find itself
+	UPROPERTY(EditDefaultsOnly, Category = "Fuse", meta = (ClampMin = 0.0f, ClampMax = 20.0f))
+	float GrabReachAimSlack = 5.0f;
+
 	// Multiplier for rotation values input in AdjustGrabbedComponentTargetRotation
-	UPROPERTY(EditDefaultsOnly, Category = "Fuse")
+	// Held and fused rotations snap to the orientations reachable in steps of this
+	UPROPERTY(EditDefaultsOnly, Category = "Fuse", meta = (ClampMin = 15.0f, ClampMax = 180.0f))
 	float ComponentRotationMultiplier = 45.0f;
 
 	// The specific physics constraint actor to spawn when constraining fusables
 	UPROPERTY(EditDefaultsOnly, Category = "Fuse")
 	TSubclassOf<APhysicsConstraintActor> PhysicsConstraintActor = APhysicsConstraintActor::StaticClass();
+
+	// Grabbing a part of an assembly grabs the whole assembly. The other parts are welded into the grabbed part's body
+	// while it's held, so the solver moves it as one body, and every free socket of the assembly can be fused
+	UPROPERTY(EditDefaultsOnly, Category = "Fuse")
+	bool bGrabWholeAssemblies = false;
 	
 	// Maximum distance for object fusing
 	UPROPERTY(EditDefaultsOnly, Category = "Fuse", meta = (ClampMin = 5.0f, ClampMax = 200.0f))
@@ -201,6 +246,19 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "Fuse")
 	TEnumAsByte<ECollisionChannel> FusableIgnoredTraceChannel = ECC_Camera;
 
+	// Distance between a client's predicted held component and the server's before the client is pulled towards the
+	// server's, measured against where the client had it over the last round trip
+	UPROPERTY(EditDefaultsOnly, Category = "Fuse|Prediction")
+	float PredictionCorrectionThreshold = 50.0f;
+
+	// Time for a pull towards the server's held component location to fade out
+	UPROPERTY(EditDefaultsOnly, Category = "Fuse|Prediction")
+	float PredictionCorrectionSmoothingTime = 0.25f;
+
+	// Distance past which the predicted held component is moved straight to the server's location instead
+	UPROPERTY(EditDefaultsOnly, Category = "Fuse|Prediction")
+	float PredictionSnapDistance = 500.0f;
+
 	// Blueprint event for fuser state changed
 	UPROPERTY(BlueprintAssignable, Category = "Fuse")
 	FOnFuserStateChanged OnFuserStateChanged;
@@ -224,20 +282,75 @@ public:
 	// Getter for the current grabbed component target distance
 	UFUNCTION(BlueprintGetter, Category = "Fuse")
 	float GetGrabbedComponentTargetDistance() const {return GrabbedComponentTargetDistance;}
+
+	// Get the most recent fuse operation, with socket names resolved
+	// May not be valid
+	UFUNCTION(BlueprintPure, Category = "Fuse")
+	FFuseOperationData GetFuseOperationData() const;
+
+	// Ranked fuse candidates from the last search, nearest first, so UI can offer alternatives without searching again
+	// Supplemental socket pairs are only filled in for the active candidate
+	UFUNCTION(BlueprintPure, Category = "Fuse")
+	TArray<FFuseOperationData> GetFuseCandidates() const;
+
+	// Index in GetFuseCandidates of the candidate that would be fused, or -1 if there isn't one
+	UFUNCTION(BlueprintPure, Category = "Fuse")
+	int32 GetActiveFuseCandidateIndex() const { return FuseCandidates.ActiveIndex; }
+
+	// Make another ranked candidate the active one, eg. 1 for the next and -1 for the previous
+	// The picked candidate stays active while it's in range, clients send it to the server for the fuse
+	UFUNCTION(BlueprintCallable, Category = "Fuse")
+	bool CycleFuseCandidate(int32 Step = 1);
 	
 private:
+	// The benchmarks and fast forward sim drive the search and fuse steps directly, without the fuse tick timer
+	friend class FFuseBenchmark;
+	friend class FFuseFastForward;
+	friend class UFFuseBenchmarkCommandlet;
+	
+	UPROPERTY()
+	AController* OwningController;
+
 	UPROPERTY()
-	APlayerController* OwningCharacterController;
-	EFuserState CurrentFuserState;
+	TScriptInterface<IFFuseViewPointProvider> ViewPointProvider;
+
+	// Refresh the owning controller from the owning pawn, returns false if there isn't one
+	bool ResolveOwningController();
+	
+	// Get the view point to search and hold fusables from, from the provider or the owning controller
+	bool GetFuseViewPoint(FVector& OutLocation, FRotator& OutRotation) const;
+	
+	UPROPERTY(ReplicatedUsing = OnRep_CurrentFuserState)
+	TEnumAsByte<EFuserState> CurrentFuserState;
 	FHitResult LastSearchHitResult;
+	// Transform of the instance the search hit, when it hit an instanced fusable
+	FTransform LastSearchInstanceTransform;
+
+	UFUNCTION()
+	void OnRep_CurrentFuserState(TEnumAsByte<EFuserState> PreviousState);
 
 	// The most recent fuse data
 	// May not be valid
-	FFuseOperationData LastFuseOperationData;
+	FFuseOperation LastFuseOperation;
 	void ClearFuseOperationData();
+
+	// Name of a socket in a component's socket table, or None if the index is out of range
+	FName GetFuseSocketName(const UPrimitiveComponent* Component, uint16 SocketIndex) const;
 	
 	UPROPERTY()
 	AActor* LastSpawnedOrthoProjectionActor;
+
+	// The grabbed component, replicated so clients without the physics handle grab can show what's held
+	UPROPERTY(ReplicatedUsing = OnRep_HeldComponent)
+	UPrimitiveComponent* HeldComponent;
+
+	UFUNCTION()
+	void OnRep_HeldComponent(UPrimitiveComponent* PreviousHeldComponent);
+
+	// Highlight and project a held component, or undo it
+	// Only done where the fuser is controlled, there's nobody to see it on the server of a remote player
+	void UpdateHeldVisuals(UPrimitiveComponent* Component, bool bHeld);
+	void UpdateOrthoProjectionActor() const;
 	
 	UPROPERTY()
 	APhysicsConstraintActor* LastSpawnedConstraintActor;
@@ -247,30 +360,234 @@ private:
 
 	float GrabbedComponentTargetHeight;
 	
-	// Rotator that is transformed to the owner's control rotation space for the final target
-	FRotator GrabbedComponentLocalTargetRotator;
+	// Orientation that is transformed to the owner's control rotation space for the final target
+	uint16 GrabbedComponentLocalOrientation = 0;
+	// Rotation inputs added up without snapping, the orientation is this snapped, so inputs under half a step add up
+	FQuat GrabbedComponentLocalRotation = FQuat::Identity;
+
+	// Orientations reachable with ComponentRotationMultiplier
+	const FFuseOrientationTable* OrientationTable = nullptr;
+	const FFuseOrientationTable& GetOrientationTable() const;
 	
 	// Tick function running on a looped timer
 	// Not using PrimaryObjectTick.TickInterval as to not mess with the parent
 	void FuseTick();
+	void StartFuseTick();
 	FTimerHandle FuseTickTimerHandle;
 	
 	// Trace for a potential fusable object from the owning character's camera viewpoint
 	void SearchForFusable();
-	bool IsComponentFusable(FHitResult InHitResult);
 	// Update location and rotation of held fusable
 	void UpdateHeldFusable();
 
-	// Search for nearby fusable objects and loop through sockets to try and find the best fusable sockets
-	bool TryFindIdealFuseSockets(FFuseOperationData& FuseOperationData);
-
-	FTransform FindSourceFusableTargetTransform(UPrimitiveComponent* SourceComponent, FName SourceSocketName,
-	                                            UPrimitiveComponent* TargetComponent, FName TargetSocketName);	
+	// Rank the nearby fusable sockets and make the active candidate the fuse operation
+	// Candidates are re-scored rather than searched for again while the held component stays near where they were found,
+	// unless bRediscover is set
+	bool TryFindIdealFuseSockets(FFuseOperation& FuseOperation, bool bRediscover = false);
+
+	// The ranked candidates for the held component, see f.fusecandidates.hysteresis and f.fusecandidates.rescoredistance
+	FFuseCandidateSet FuseCandidates;
+
+	// Update the distances of the current candidates, returns false if none are left
+	bool RescoreFuseCandidates();
+	// Search for fusable objects near a held part and rank the nearest socket pairs that don't overlap, adding to the candidates
+	// Only the source sockets set in FreeSockets are used when it's given
+	// The neighbours already in ScratchHitResults are searched when bNeighboursFound is set, instead of sweeping again
+	void DiscoverFuseCandidates(UPrimitiveComponent* SourceComponent, const FFuseSocketTable& SourceSockets, const TBitArray<>* FreeSockets = nullptr,
+	                            bool bNeighboursFound = false);
+	// Fill in a fuse operation and its supplemental pairs from the active candidate, returns false if there isn't one
+	bool ApplyActiveFuseCandidate(FFuseOperation& FuseOperation);
+	// Blueprint view of a candidate
+	FFuseOperationData MakeFuseOperationData(const UPrimitiveComponent* SourceComponent, const UPrimitiveComponent* TargetComponent,
+	                                         const FFuseSocketPair& Sockets, float Distance) const;
+
+	// An assembly held as one body, see bGrabWholeAssemblies
+	struct FWeldedAssembly
+	{
+		// The grabbed part first, every other part is welded into its body
+		TArray<TWeakObjectPtr<UPrimitiveComponent>> Parts;
+		// Joints between the parts, terminated while they're welded
+		TArray<TWeakObjectPtr<UPhysicsConstraintComponent>> Joints;
+		// Sockets of each part that aren't already joined to another part of the assembly
+		TArray<TBitArray<>> FreeSockets;
+		// False on the owning client, which only has the server's parts to search from, see FFuseHeldState::AssemblyParts
+		bool bWelded = false;
+
+		bool IsValid() const { return Parts.Num() > 1; }
+		int32 Find(const UPrimitiveComponent* Part) const { return Part ? Parts.IndexOfByKey(Part) : INDEX_NONE; }
+	};
+	// The assembly of the held component while it's held, then of the fused part until EndFuseObjects
+	FWeldedAssembly HeldAssembly;
+	FWeldedAssembly FusingAssembly;
+
+	// Weld the assembly a grabbed part is in into the part's body, returns false if it's not in one or it can't be welded
+	bool TryWeldHeldAssembly(UPrimitiveComponent* Component);
+	// Unweld the parts back into their own bodies, moving as the assembly was, and restore the joints between them
+	static void UnweldAssembly(FWeldedAssembly& Assembly);
+	// Find the sockets of each part that aren't joined to another part
+	void FindFreeSockets(FWeldedAssembly& Assembly) const;
+	// Take the held assembly's parts from the server's held state on the owning client
+	void SyncHeldAssembly();
+	// Ignore every held part in a query for where a held part would go, they move with it
+	void IgnoreHeldAssembly(FComponentQueryParams& QueryParams) const;
+
+	// Query results reused between searches, so the hot path doesn't reallocate them every update
+	TArray<FHitResult> ScratchHitResults;
+	TArray<FOverlapResult> ScratchOverlapResults;
+
+	// Sweep for fusables within Radius of a location, ignoring a component
+	void FindNeighbourHits(const FVector& Location, float Radius, const UPrimitiveComponent* IgnoredComponent, TArray<FHitResult>& OutHits) const;
+
+	// Fuse data prepared for the targeted fusable while searching, so grabbing it doesn't start cold
+	struct FTargetPrefetch
+	{
+		TWeakObjectPtr<UPrimitiveComponent> Component;
+		// Where the neighbours were found, they're only reused while the component hasn't moved
+		FTransform Transform;
+		double Time = 0.0;
+		float NeighbourRadius = 0.0f;
+		TArray<FHitResult> NeighbourHits;
+		// Last rotation relative to the owner's yaw that was snapped, and the orientation it snapped to
+		FQuat LocalRotation = FQuat::Identity;
+		uint16 LocalOrientation = 0;
+		bool bHasLocalOrientation = false;
+	};
+	FTargetPrefetch TargetPrefetch;
+
+	// Warm the socket table, find the neighbours, snap the orientation and reserve a projection actor for the
+	// targeted fusable, see f.fuseprefetch
+	void PrefetchTargetedFusable();
+	// Copy the prefetched neighbours of a component into ScratchHitResults if they're still valid for a sweep of Radius
+	bool TryUsePrefetchedNeighbours(const UPrimitiveComponent* Component, float Radius);
+	// Snap a component's rotation relative to the owner's yaw, reusing the last snap when the rotation hasn't changed
+	uint16 SnapLocalOrientation(const UPrimitiveComponent* Component);
+
+	// Single pair version of FFuseTargetTransforms::Compute, for sockets in the components' socket tables
+	FTransform FindSourceFusableTargetTransform(UPrimitiveComponent* SourceComponent, uint16 SourceSocket,
+	                                            UPrimitiveComponent* TargetComponent, uint16 TargetSocket,
+	                                            uint16* OutOrientation = nullptr) const;
 	
 	void FuseObjects(float DeltaTime);
 	float FuseOperationTime;
 
 	void EndFuseObjects();
+
+	// Spawn a constraint joining the source to a target socket
+	APhysicsConstraintActor* SpawnFuseConstraint(UPrimitiveComponent* SourceComponent, UPrimitiveComponent* TargetComponent, uint16 TargetSocket) const;
+
+	/* Replication */
+
+	// Is this fuser driven from this machine, rather than by a remote client or another machine's server
+	bool IsLocalFuser() const;
+
+	// The last fuse completed on the server, clients rebuild the fuse from it. Invalid once either part is detached
+	UPROPERTY(ReplicatedUsing = OnRep_LastNetFuse)
+	FFuseNetOperation LastNetFuse;
+
+	UFUNCTION()
+	void OnRep_LastNetFuse();
+
+	void ReplicateFuse();
+
+	// Client intents, the server re-runs the search or fuse itself rather than trusting the client's result
+	UFUNCTION(Server, Reliable)
+	void ServerTryStartSearching();
+
+	UFUNCTION(Server, Reliable)
+	void ServerTryStopSearching();
+
+	UFUNCTION(Server, Reliable)
+	void ServerTryGrabTargetedFusable(UPrimitiveComponent* TargetComponent);
+
+	// Every held input the server hasn't applied yet, sent unreliably each held update until the held state acknowledges
+	// them, so a lost batch is made up by the next one. Inputs the server already has, or from another grab, are skipped
+	UFUNCTION(Server, Unreliable)
+	void ServerApplyHeldInputs(uint8 GrabId, const TArray<FFuseHeldInput>& Inputs);
+
+	UFUNCTION(Server, Reliable)
+	void ServerTryFuseObjects();
+
+	// A candidate picked with CycleFuseCandidate, pinned on the server until its own search fails to find it
+	UFUNCTION(Server, Reliable)
+	void ServerSelectFuseCandidate(UPrimitiveComponent* SourceComponent, UPrimitiveComponent* TargetComponent, int32 TargetInstance,
+	                               uint16 SourceSocket, uint16 TargetSocket);
+
+	UFUNCTION(Server, Reliable)
+	void ServerTryDetachGrabbedComponent();
+
+	// Break the constraints on a component on every client
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastBreakFuseConstraints(UPrimitiveComponent* Component);
+
+	// Break and destroy the fuse constraints on a component, true if there were any
+	bool BreakFuseConstraints(UPrimitiveComponent* Component);
+
+	// Is a component near enough to the server's view of the owner's aim, and in sight, for the client to have found it
+	// with its own search
+	bool IsWithinGrabReach(const UPrimitiveComponent* Component) const;
+
+	/* Prediction */
+
+	// The server's held targets and location, for the owning client to reconcile its prediction against
+	UPROPERTY(ReplicatedUsing = OnRep_HeldState)
+	FFuseHeldState HeldState;
+
+	UFUNCTION()
+	void OnRep_HeldState();
+
+	void UpdateHeldState();
+	void ReconcileHeldState();
+
+	// Let the owning client move the held component itself, the server stops sending it the component's physics
+	void SetClientPredictsHeldComponent(UPrimitiveComponent* Component, bool bPredicted);
+
+	UPROPERTY()
+	AActor* HeldActorPreviousOwner;
+
+	// Set the held targets from where a component is relative to the view, as a grab does
+	void InitHeldTargets(const UPrimitiveComponent* Component);
+
+	// Apply an input to the held targets, on the server or the predicting client
+	void ApplyHeldInput(const FFuseHeldInput& Input);
+
+	// Predict an input and queue it for the server
+	void SendHeldInput(FFuseHeldInput Input);
+	// Send the inputs the server hasn't applied yet
+	void SendPendingHeldInputs();
+
+	// Inputs sent but not yet applied in a held state from the server, oldest first
+	// Past the limit the oldest are dropped and counted in the prediction stats
+	// Reserved to the limit in BeginPlay, and the default allocator so it's sent as it is without a copy
+	static constexpr int32 MaxPendingHeldInputs = 64;
+	TArray<FFuseHeldInput> PendingHeldInputs;
+	// Inputs sent since the grab, the server counts the inputs it applies from the grab too
+	uint16 SentHeldInputs = 0;
+
+	uint8 ReconciledGrabId = 0;
+	bool bAwaitingGrabState = false;
+
+	// Where the predicted held component was on recent updates, to match against the server's older location
+	struct FPredictedLocation
+	{
+		double Time;
+		FVector Location;
+	};
+	static constexpr int32 MaxPredictedLocations = 32;
+	TArray<FPredictedLocation, TFixedAllocator<MaxPredictedLocations>> PredictedLocations;
+
+	// Pull on the held target towards the server's location, fading out over PredictionCorrectionSmoothingTime
+	FVector PredictionCorrectionOffset = FVector::ZeroVector;
+
+	// Consecutive held states where the server's fuse preview didn't match the client's
+	int32 PreviewMismatches = 0;
+
+	// Timestamps of inputs and fuse operations that haven't taken effect yet
+	FFuseLatencyMarks LatencyMarks;
+
+	// Journal entry for an event with the current state, candidate count and fuse sockets, see FFuseEventJournal
+	FFuseJournalEntry MakeJournalEntry(EFuseJournalEvent Event) const;
+	// World time the held component was grabbed, for its hold duration in the journal
+	double GrabTime = 0.0;
 	
 	/* Utility */
 	
@@ -279,13 +596,6 @@ private:
 	FRotator GetOwnerControlRotationYaw() const;
 	FRotator OwnerCameraRotCached;
 
-	// Rotate or inverse rotate rotators
-	static FRotator RotateRotator(FRotator RotA, FRotator RotB);
-	static FRotator InverseRotateRotator(FRotator RotA, FRotator RotB);
-	
-	float RoundFloatToNearestMultiple(float Value, float Multiple) const;
-	FRotator RoundRotatorToNearestMultiple(FRotator InRotator, float Multiple) const;
-
 
 };
 
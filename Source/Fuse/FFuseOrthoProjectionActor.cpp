@@ -1,5 +1,6 @@
 
 #include "FFuseOrthoProjectionActor.h"
+#include "FuseStats.h"
 #include "Components/DecalComponent.h"
 #include "Engine/TextureRenderTarget2D.h"
 
@@ -7,7 +8,7 @@ AFFuseOrthoProjectionActor::AFFuseOrthoProjectionActor()
 {
  	// Actor ticks at ProjectionUpdateRate per second
 	PrimaryActorTick.bCanEverTick = true;
-	PrimaryActorTick.TickInterval = 1 / ProjectionUpdateRate;
+	PrimaryActorTick.TickInterval = 1.0f / ProjectionUpdateRate;
 
 	USceneComponent* SceneComponent = CreateDefaultSubobject<USceneComponent>("Scene Component");
 	SetRootComponent(SceneComponent);
@@ -29,10 +30,13 @@ void AFFuseOrthoProjectionActor::BeginPlay()
 void AFFuseOrthoProjectionActor::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+	FUSE_SCOPE_CYCLE_COUNTER(OrthoCapture);
 
 	SceneCaptureComponentForward->CaptureScene();
 	SceneCaptureComponentRight->CaptureScene();
 	SceneCaptureComponentUp->CaptureScene();
+	// Three a tick, which is at ProjectionUpdateRate rather than every frame
+	FUSE_INC_COUNTER(CapturesRendered, 3);
 }
 
 USceneCaptureComponent2D* AFFuseOrthoProjectionActor::InitSceneCaptureComponent(UTextureRenderTarget2D* RenderTarget, FRotator CaptureRotation, FName CompName)
@@ -41,6 +45,9 @@ USceneCaptureComponent2D* AFFuseOrthoProjectionActor::InitSceneCaptureComponent(
 	NewCaptureComponent->SetupAttachment(RootComponent);
 	NewCaptureComponent->SetRelativeRotation(CaptureRotation);
 	NewCaptureComponent->SetRelativeLocation(CaptureRotation.Vector() * -SceneCaptureComponentDistance);
+	// Captured on demand from Tick, so a hidden or pooled actor doesn't render anything
+	NewCaptureComponent->bCaptureEveryFrame = false;
+	NewCaptureComponent->bCaptureOnMovement = false;
 	
 	if (RenderTarget) { NewCaptureComponent->TextureTarget = RenderTargetForward; }
 	else { UE_LOG(LogTemp, Error, TEXT("Component %s failed to allocate a render target to a SceneCaptureComponent"), *this->GetName()); }
@@ -0,0 +1,344 @@
+
+#include "FFuseStressWorldGenerator.h"
+#include "FuseSocketTable.h"
+#include "FFusableSocketTableUserData.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/StaticMeshSocket.h"
+#include "PhysicsEngine/PhysicsConstraintComponent.h"
+
+static FAutoConsoleCommandWithWorldAndArgs FuseStressWorldCommand(
+	TEXT("f.fusestressworld"),
+	TEXT("Spawn a fuse stress world generator at the world origin. Args: Seed=1 Props=500 SocketDensity=1 AssemblySize=20 Assemblies=4 Simulate=1 Instanced=0"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World) { return; }
+		const FString Params = FString::Join(Args, TEXT(" "));
+
+		AFFuseStressWorldGenerator* Generator = World->SpawnActorDeferred<AFFuseStressWorldGenerator>(
+			AFFuseStressWorldGenerator::StaticClass(), FTransform::Identity);
+		FParse::Value(*Params, TEXT("Seed="), Generator->Seed);
+		FParse::Value(*Params, TEXT("Props="), Generator->PropCount);
+		FParse::Value(*Params, TEXT("SocketDensity="), Generator->SocketDensity);
+		FParse::Value(*Params, TEXT("AssemblySize="), Generator->AssemblySize);
+		FParse::Value(*Params, TEXT("Assemblies="), Generator->AssemblyCount);
+		FParse::Bool(*Params, TEXT("Simulate="), Generator->bSimulatePhysics);
+		FParse::Bool(*Params, TEXT("Instanced="), Generator->bInstanceLooseProps);
+		Generator->bGenerateOnBeginPlay = true;
+		Generator->FinishSpawning(FTransform::Identity);
+	}),
+	ECVF_Cheat);
+
+AFFuseStressWorldGenerator::AFFuseStressWorldGenerator()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	SetRootComponent(CreateDefaultSubobject<USceneComponent>("Scene Component"));
+
+	PropMeshes.Add(TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Game/Fuse/Props/SM_Prop_Planks.SM_Prop_Planks"))));
+	PropMeshes.Add(TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Game/Fuse/Props/SM_Prop_Log.SM_Prop_Log"))));
+	PropMeshes.Add(TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Game/LevelPrototyping/Meshes/SM_Cube.SM_Cube"))));
+	PhysicsConstraintActor = APhysicsConstraintActor::StaticClass();
+}
+
+void AFFuseStressWorldGenerator::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (bGenerateOnBeginPlay)
+	{
+		Generate();
+		return;
+	}
+
+	// Props saved with the level still need their generated sockets
+	TArray<UStaticMesh*> Meshes;
+	for (const TSoftObjectPtr<UStaticMesh>& PropMesh : PropMeshes)
+	{
+		if (UStaticMesh* Mesh = PropMesh.LoadSynchronous()) { Meshes.AddUnique(Mesh); }
+	}
+	PrepareMeshSockets(Meshes);
+}
+
+void AFFuseStressWorldGenerator::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Sockets are added to shared mesh assets, so don't leave them behind after play
+	for (UStaticMesh* Mesh : SocketGeneratedMeshes)
+	{
+		if (Mesh) { RemoveGeneratedAttachSockets(Mesh, FusableSocketSubName); }
+	}
+	SocketGeneratedMeshes.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AFFuseStressWorldGenerator::Generate()
+{
+	Clear();
+
+	TArray<UStaticMesh*> Meshes;
+	for (const TSoftObjectPtr<UStaticMesh>& PropMesh : PropMeshes)
+	{
+		if (UStaticMesh* Mesh = PropMesh.LoadSynchronous()) { Meshes.AddUnique(Mesh); }
+	}
+	if (Meshes.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Stress world generator %s has no valid prop meshes"), *GetName());
+		return;
+	}
+	PrepareMeshSockets(Meshes);
+
+	FRandomStream Stream(Seed);
+	const FVector Origin = GetActorLocation();
+
+	// Scatter loose props on a jittered grid so they never start overlapping
+	FVector MaxPropExtent = FVector::ZeroVector;
+	for (const UStaticMesh* Mesh : Meshes) { MaxPropExtent = MaxPropExtent.ComponentMax(Mesh->GetBoundingBox().GetExtent()); }
+	const float CellSize = MaxPropExtent.Size() * 2.0f * PropSpacing;
+	const int32 GridSide = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(PropCount)));
+	const float Jitter = (CellSize - MaxPropExtent.Size() * 2.0f) * 0.5f;
+	for (int32 PropIndex = 0; PropIndex < PropCount; PropIndex++)
+	{
+		UStaticMesh* Mesh = Meshes[Stream.RandRange(0, Meshes.Num() - 1)];
+		const FVector Location = Origin + FVector(
+			(PropIndex % GridSide) * CellSize + Stream.FRandRange(-Jitter, Jitter),
+			(PropIndex / GridSide) * CellSize + Stream.FRandRange(-Jitter, Jitter),
+			Mesh->GetBoundingBox().GetExtent().Z - Mesh->GetBoundingBox().GetCenter().Z);
+		const FTransform PropTransform(FRotator(0.0f, Stream.FRandRange(0.0f, 360.0f), 0.0f), Location);
+		if (bInstanceLooseProps) { AddPropInstance(Mesh, PropTransform); }
+		else { SpawnProp(Mesh, PropTransform); }
+	}
+
+	// Build assemblies in a row past the scattered props, spaced generously since growth can go in any direction
+	const float AssemblySpacing = CellSize * FMath::Max(4.0f, FMath::Sqrt(static_cast<float>(AssemblySize)) * 2.0f);
+	FVector AssemblyOrigin = Origin + FVector(AssemblySpacing * 0.5f, GridSide * CellSize + AssemblySpacing * 0.5f, 0.0f);
+	for (int32 AssemblyIndex = 0; AssemblyIndex < AssemblyCount; AssemblyIndex++)
+	{
+		UStaticMesh* Mesh = Meshes[Stream.RandRange(0, Meshes.Num() - 1)];
+		BuildAssembly(Mesh, AssemblyOrigin, Stream);
+		AssemblyOrigin.X += AssemblySpacing;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Stress world generator %s spawned %d actors and %d instanced props from seed %d"),
+	       *GetName(), SpawnedActors.Num(), bInstanceLooseProps ? PropCount : 0, Seed);
+}
+
+void AFFuseStressWorldGenerator::Clear()
+{
+	for (AActor* SpawnedActor : SpawnedActors)
+	{
+		if (SpawnedActor) { SpawnedActor->Destroy(); }
+	}
+	SpawnedActors.Reset();
+
+	for (UHierarchicalInstancedStaticMeshComponent* Instances : PropInstances)
+	{
+		if (Instances) { Instances->DestroyComponent(); }
+	}
+	PropInstances.Reset();
+}
+
+void AFFuseStressWorldGenerator::PrepareMeshSockets(const TArray<UStaticMesh*>& Meshes)
+{
+	// Don't modify mesh assets in the editor, sockets are generated again when play begins
+	if (SocketDensity <= 0.0f || !GetWorld() || !GetWorld()->IsGameWorld()) { return; }
+
+	for (UStaticMesh* Mesh : Meshes)
+	{
+		const FVector Size = Mesh->GetBoundingBox().GetSize();
+		const float SurfaceArea = 2.0f * (Size.X * Size.Y + Size.Y * Size.Z + Size.X * Size.Z);
+		// Always at least one socket per face, so assemblies can connect on every side
+		const int32 SocketCount = FMath::Max(6, FMath::RoundToInt(SurfaceArea / 10000.0f * SocketDensity));
+
+		RemoveGeneratedAttachSockets(Mesh, FusableSocketSubName);
+		AddGeneratedAttachSockets(Mesh, FusableSocketSubName, SocketCount);
+		SocketGeneratedMeshes.AddUnique(Mesh);
+	}
+}
+
+AStaticMeshActor* AFFuseStressWorldGenerator::SpawnProp(UStaticMesh* Mesh, const FTransform& Transform)
+{
+	AStaticMeshActor* Prop = GetWorld()->SpawnActor<AStaticMeshActor>(Transform.GetLocation(), Transform.Rotator());
+	if (!Prop) { return nullptr; }
+
+	UStaticMeshComponent* PropComponent = Prop->GetStaticMeshComponent();
+	PropComponent->SetMobility(EComponentMobility::Movable);
+	PropComponent->SetStaticMesh(Mesh);
+	PropComponent->SetCollisionProfileName(UCollisionProfile::PhysicsActor_ProfileName);
+	PropComponent->SetSimulatePhysics(bSimulatePhysics);
+#if WITH_EDITOR
+	Prop->SetFolderPath(*FString::Printf(TEXT("%s_Generated"), *GetName()));
+#endif
+	SpawnedActors.Add(Prop);
+	return Prop;
+}
+
+void AFFuseStressWorldGenerator::AddPropInstance(UStaticMesh* Mesh, const FTransform& Transform)
+{
+	UHierarchicalInstancedStaticMeshComponent* Instances = nullptr;
+	for (UHierarchicalInstancedStaticMeshComponent* PropInstance : PropInstances)
+	{
+		if (PropInstance && PropInstance->GetStaticMesh() == Mesh) { Instances = PropInstance; }
+	}
+	if (!Instances)
+	{
+		// Instances can't simulate, but need the physics body object type to be found by fuse searches
+		Instances = NewObject<UHierarchicalInstancedStaticMeshComponent>(this);
+		Instances->SetupAttachment(GetRootComponent());
+		Instances->SetStaticMesh(Mesh);
+		Instances->SetCollisionProfileName(UCollisionProfile::PhysicsActor_ProfileName);
+		Instances->RegisterComponent();
+		PropInstances.Add(Instances);
+	}
+	Instances->AddInstance(Transform, true);
+}
+
+void AFFuseStressWorldGenerator::BuildAssembly(UStaticMesh* Mesh, const FVector& Origin, FRandomStream& Stream)
+{
+	// Grow the assembly randomly on a lattice of mesh sized cells, so neighbouring parts share a face
+	// and the generated face sockets of neighbours line up exactly
+	static const FIntVector Directions[6] = {
+		FIntVector(1, 0, 0), FIntVector(-1, 0, 0), FIntVector(0, 1, 0),
+		FIntVector(0, -1, 0), FIntVector(0, 0, 1), FIntVector(0, 0, -1)};
+
+	TArray<FIntVector> Cells;
+	TArray<int32> ParentCells;
+	TArray<int32> ParentDirections;
+	TSet<FIntVector> OccupiedCells;
+	Cells.Add(FIntVector::ZeroValue);
+	ParentCells.Add(INDEX_NONE);
+	ParentDirections.Add(INDEX_NONE);
+	OccupiedCells.Add(FIntVector::ZeroValue);
+
+	// Bound the attempts, very dense growth can run out of free neighbours
+	for (int32 Attempt = 0; Cells.Num() < AssemblySize && Attempt < AssemblySize * 32; Attempt++)
+	{
+		const int32 ParentIndex = Stream.RandRange(0, Cells.Num() - 1);
+		const int32 Direction = Stream.RandRange(0, 5);
+		// Keep assemblies on or above the ground plane
+		const FIntVector Cell = Cells[ParentIndex] + Directions[Direction];
+		if (Cell.Z < 0 || OccupiedCells.Contains(Cell)) { continue; }
+
+		Cells.Add(Cell);
+		ParentCells.Add(ParentIndex);
+		ParentDirections.Add(Direction);
+		OccupiedCells.Add(Cell);
+	}
+
+	const FBox Bounds = Mesh->GetBoundingBox();
+	const FVector CellSize = Bounds.GetSize();
+	const FVector BaseLocation = Origin + FVector(0.0f, 0.0f, Bounds.GetExtent().Z - Bounds.GetCenter().Z);
+	TArray<UPrimitiveComponent*> Parts;
+	for (int32 CellIndex = 0; CellIndex < Cells.Num(); CellIndex++)
+	{
+		const FVector Location = BaseLocation + FVector(Cells[CellIndex]) * CellSize;
+		AStaticMeshActor* Part = SpawnProp(Mesh, FTransform(Location));
+		Parts.Add(Part ? Part->GetStaticMeshComponent() : nullptr);
+
+		// Constrain to the parent part at the parent socket facing this part, the same as a finished fuse
+		const int32 ParentIndex = ParentCells[CellIndex];
+		if (ParentIndex != INDEX_NONE && Parts[CellIndex] && Parts[ParentIndex])
+		{
+			SpawnAssemblyConstraint(Parts[ParentIndex], GetGeneratedSocketName(FusableSocketSubName, ParentDirections[CellIndex]), Parts[CellIndex]);
+		}
+	}
+}
+
+void AFFuseStressWorldGenerator::SpawnAssemblyConstraint(UPrimitiveComponent* TargetComponent, const FName TargetSocket, UPrimitiveComponent* SourceComponent)
+{
+	APhysicsConstraintActor* ConstraintActor = GetWorld()->SpawnActor<APhysicsConstraintActor>(
+		PhysicsConstraintActor, TargetComponent->GetComponentLocation(), TargetComponent->GetComponentRotation());
+	if (!ConstraintActor) { return; }
+
+	UPhysicsConstraintComponent* ConstraintComp = ConstraintActor->GetConstraintComp();
+	if (TargetComponent->DoesSocketExist(TargetSocket))
+	{
+		ConstraintComp->AttachToComponent(TargetComponent, FAttachmentTransformRules::SnapToTargetNotIncludingScale, TargetSocket);
+	}
+	else
+	{
+		// Sockets are only generated in game worlds, so fall back to the point between the two parts
+		ConstraintComp->AttachToComponent(TargetComponent, FAttachmentTransformRules::KeepWorldTransform);
+		ConstraintComp->SetWorldLocation((TargetComponent->GetComponentLocation() + SourceComponent->GetComponentLocation()) * 0.5f);
+	}
+	ConstraintComp->SetAngularTwistLimit(ACM_Limited, 1.0f);
+	ConstraintComp->SetAngularSwing1Limit(ACM_Limited, 1.0f);
+	ConstraintComp->SetAngularSwing2Limit(ACM_Limited, 1.0f);
+
+	// Actor references are saved with the level, component overrides are only used in game worlds
+	ConstraintComp->ConstraintActor1 = TargetComponent->GetOwner();
+	ConstraintComp->ConstraintActor2 = SourceComponent->GetOwner();
+	if (GetWorld()->IsGameWorld())
+	{
+		ConstraintComp->SetConstrainedComponents(TargetComponent, NAME_None, SourceComponent, NAME_None);
+	}
+#if WITH_EDITOR
+	ConstraintActor->SetFolderPath(*FString::Printf(TEXT("%s_Generated"), *GetName()));
+#endif
+	SpawnedActors.Add(ConstraintActor);
+}
+
+FName AFFuseStressWorldGenerator::GetGeneratedSocketName(const FString& SocketSubName, const int32 SocketIndex)
+{
+	return FName(FString::Printf(TEXT("%s_Gen%03d"), *SocketSubName, SocketIndex));
+}
+
+void AFFuseStressWorldGenerator::AddGeneratedAttachSockets(UStaticMesh* Mesh, const FString& SocketSubName, const int32 SocketCount)
+{
+	// Spread sockets evenly over the 6 faces of the bounds, on a square grid per face
+	const FBox Bounds = Mesh->GetBoundingBox();
+	const FVector Centre = Bounds.GetCenter();
+	const FVector Extent = Bounds.GetExtent();
+	const int32 SocketsPerFace = FMath::DivideAndRoundUp(SocketCount, 6);
+	const int32 FaceGridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(SocketsPerFace)));
+
+	for (int32 SocketIndex = 0; SocketIndex < SocketCount; SocketIndex++)
+	{
+		const int32 Face = SocketIndex % 6;
+		// Offset the face index so the first socket on every face is as close to the middle as the grid allows
+		const int32 FaceIndex = (SocketIndex / 6 + (FaceGridSize * FaceGridSize) / 2) % (FaceGridSize * FaceGridSize);
+		const int32 Axis = Face / 2;
+		const float Side = Face % 2 == 0 ? 1.0f : -1.0f;
+
+		// Position on the face, in -1 to 1 on the two axes perpendicular to the face normal
+		const float U = (FaceIndex % FaceGridSize + 0.5f) / FaceGridSize * 2.0f - 1.0f;
+		const float V = (FaceIndex / FaceGridSize + 0.5f) / FaceGridSize * 2.0f - 1.0f;
+		FVector Offset;
+		Offset[Axis] = Side * Extent[Axis];
+		Offset[(Axis + 1) % 3] = U * Extent[(Axis + 1) % 3];
+		Offset[(Axis + 2) % 3] = V * Extent[(Axis + 2) % 3];
+
+		UStaticMeshSocket* Socket = NewObject<UStaticMeshSocket>(Mesh);
+		Socket->SocketName = GetGeneratedSocketName(SocketSubName, SocketIndex);
+		Socket->RelativeLocation = Centre + Offset;
+		// AddSocket is editor only, the socket array is all the runtime lookups use
+		Mesh->Sockets.Add(Socket);
+	}
+	RebuildSocketTable(Mesh);
+}
+
+void AFFuseStressWorldGenerator::RemoveGeneratedAttachSockets(UStaticMesh* Mesh, const FString& SocketSubName)
+{
+	const FString GeneratedPrefix = SocketSubName + TEXT("_Gen");
+	for (int32 SocketIndex = Mesh->Sockets.Num() - 1; SocketIndex >= 0; SocketIndex--)
+	{
+		UStaticMeshSocket* Socket = Mesh->Sockets[SocketIndex];
+		if (Socket && Socket->SocketName.ToString().StartsWith(GeneratedPrefix))
+		{
+			Mesh->Sockets.RemoveAt(SocketIndex);
+		}
+	}
+	RebuildSocketTable(Mesh);
+}
+
+void AFFuseStressWorldGenerator::RebuildSocketTable(UStaticMesh* Mesh)
+{
+	// Generated sockets need to be in the baked table too, if the mesh has one
+	if (UFFusableSocketTableUserData* BakedTable = Mesh->GetAssetUserData<UFFusableSocketTableUserData>())
+	{
+		BakedTable->Bake();
+	}
+	FFuseSocketTable::Invalidate(Mesh);
+}
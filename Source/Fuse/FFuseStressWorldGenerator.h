@@ -0,0 +1,118 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "PhysicsEngine/PhysicsConstraintActor.h"
+#include "FFuseStressWorldGenerator.generated.h"
+
+class AStaticMeshActor;
+class UHierarchicalInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/*
+ *
+ * Actor that generates reproducible stress worlds for the fuse mechanic.
+ * Props are scattered and pre-fused into assemblies from a seed, so every run of the same settings produces the same
+ * world. Attach sockets are generated on the prop meshes at runtime, so any mesh can be used.
+ * Place it in an empty level and generate on begin play, or press Generate in the editor and save the level.
+ * Can also be spawned with f.fusestressworld Seed=1 Props=5000 SocketDensity=4 AssemblySize=500 Assemblies=1 Instanced=1
+ *
+ */
+
+UCLASS()
+class FUSE_API AFFuseStressWorldGenerator : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AFFuseStressWorldGenerator();
+
+	// Seed for every random choice made by the generator
+	UPROPERTY(EditAnywhere, Category = "Stress World")
+	int32 Seed = 1;
+
+	// Number of loose props to scatter
+	UPROPERTY(EditAnywhere, Category = "Stress World", meta = (ClampMin = 0))
+	int32 PropCount = 500;
+
+	// Generated attach sockets per 100x100 unit area of mesh bounds surface, 0 to use the existing mesh sockets
+	UPROPERTY(EditAnywhere, Category = "Stress World", meta = (ClampMin = 0.0f))
+	float SocketDensity = 1.0f;
+
+	// Number of pre-fused assemblies to build
+	UPROPERTY(EditAnywhere, Category = "Stress World", meta = (ClampMin = 0))
+	int32 AssemblyCount = 4;
+
+	// Number of parts in each pre-fused assembly
+	UPROPERTY(EditAnywhere, Category = "Stress World", meta = (ClampMin = 2))
+	int32 AssemblySize = 20;
+
+	// Spacing between scattered props, relative to the largest prop bounds
+	UPROPERTY(EditAnywhere, Category = "Stress World", meta = (ClampMin = 1.0f))
+	float PropSpacing = 1.5f;
+
+	// Should generated props simulate physics
+	UPROPERTY(EditAnywhere, Category = "Stress World")
+	bool bSimulatePhysics = true;
+
+	// Scatter loose props as instances of one instanced component per mesh, promoted to actors when grabbed or fused
+	UPROPERTY(EditAnywhere, Category = "Stress World")
+	bool bInstanceLooseProps = false;
+
+	// Generate when play begins, rather than using props saved with the level
+	UPROPERTY(EditAnywhere, Category = "Stress World")
+	bool bGenerateOnBeginPlay = true;
+
+	// Meshes picked from at random for each prop or assembly
+	UPROPERTY(EditAnywhere, Category = "Stress World")
+	TArray<TSoftObjectPtr<UStaticMesh>> PropMeshes;
+
+	// The physics constraint actor used for pre-fused assemblies
+	UPROPERTY(EditAnywhere, Category = "Stress World")
+	TSubclassOf<APhysicsConstraintActor> PhysicsConstraintActor;
+
+	// Subname of generated sockets, should match the fuse component FusableSocketSubName
+	UPROPERTY(EditAnywhere, Category = "Stress World")
+	FString FusableSocketSubName = "Attach";
+
+	// Destroy any previously generated props and generate the world from the current settings
+	UFUNCTION(CallInEditor, BlueprintCallable, Category = "Stress World")
+	void Generate();
+
+	// Destroy all props and constraints spawned by this generator
+	UFUNCTION(CallInEditor, BlueprintCallable, Category = "Stress World")
+	void Clear();
+
+	// Add generated sockets named <SubName>_Gen<Index> spread over the faces of the mesh bounds
+	// Socket <Face> is on that face, where faces are ordered +X, -X, +Y, -Y, +Z, -Z
+	// Every face uses the same socket layout, so the touching faces of neighbouring props line up
+	static void AddGeneratedAttachSockets(UStaticMesh* Mesh, const FString& SocketSubName, int32 SocketCount);
+	static void RemoveGeneratedAttachSockets(UStaticMesh* Mesh, const FString& SocketSubName);
+	static FName GetGeneratedSocketName(const FString& SocketSubName, int32 SocketIndex);
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	UPROPERTY()
+	TArray<AActor*> SpawnedActors;
+
+	// Instanced components holding the loose props when they're instanced
+	UPROPERTY()
+	TArray<UHierarchicalInstancedStaticMeshComponent*> PropInstances;
+
+	// Meshes that had sockets generated by this generator, to be removed on end play
+	UPROPERTY(Transient)
+	TArray<UStaticMesh*> SocketGeneratedMeshes;
+
+	void PrepareMeshSockets(const TArray<UStaticMesh*>& Meshes);
+	AStaticMeshActor* SpawnProp(UStaticMesh* Mesh, const FTransform& Transform);
+	void AddPropInstance(UStaticMesh* Mesh, const FTransform& Transform);
+	void BuildAssembly(UStaticMesh* Mesh, const FVector& Origin, FRandomStream& Stream);
+	void SpawnAssemblyConstraint(UPrimitiveComponent* TargetComponent, FName TargetSocket, UPrimitiveComponent* SourceComponent);
+
+	// Refresh the fuse socket table of a mesh after its sockets change
+	static void RebuildSocketTable(UStaticMesh* Mesh);
+};
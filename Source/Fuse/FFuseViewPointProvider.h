@@ -0,0 +1,29 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "FFuseViewPointProvider.generated.h"
+
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class UFFuseViewPointProvider : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/*
+ *
+ * Supplies the view point a fuse component searches and holds fusables from.
+ * Fuse components use a provider on their owner (the actor itself or one of its components) when there is one,
+ * otherwise they fall back to the view point of the owning pawn's controller.
+ * Native only, as it's called on every fuse tick.
+ *
+ */
+
+class FUSE_API IFFuseViewPointProvider
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GetFuseViewPoint(FVector& OutLocation, FRotator& OutRotation) const = 0;
+};
@@ -9,5 +9,13 @@ public class Fuse : ModuleRules
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "HeadMountedDisplay", "EnhancedInput" });
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "Json", "AssetRegistry" });
+
+		// The networked prediction automation test runs a PIE session
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("UnrealEd");
+		}
 	}
 }
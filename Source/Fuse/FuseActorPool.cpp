@@ -0,0 +1,115 @@
+
+#include "FuseActorPool.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/SceneCaptureComponent.h"
+
+namespace FuseActorPool
+{
+	using FClassPools = TMap<TObjectKey<UClass>, TArray<TWeakObjectPtr<AActor>>>;
+	static TMap<TObjectKey<UWorld>, FClassPools> Pools;
+	static FDelegateHandle WorldCleanupHandle;
+
+	static void RemoveWorldPools(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+	{
+		Pools.Remove(World);
+	}
+
+	static void Deactivate(AActor* Actor)
+	{
+		if (UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Actor->GetRootComponent()))
+		{
+			Primitive->SetSimulatePhysics(false);
+		}
+		Actor->SetActorHiddenInGame(true);
+		Actor->SetActorEnableCollision(false);
+		Actor->SetActorTickEnabled(false);
+		for (UActorComponent* Component : Actor->GetComponents())
+		{
+			Component->SetComponentTickEnabled(false);
+			// Scene captures still render while hidden, pooled actors that use them capture on demand
+			if (USceneCaptureComponent* SceneCapture = Cast<USceneCaptureComponent>(Component))
+			{
+				SceneCapture->bCaptureEveryFrame = false;
+				SceneCapture->bCaptureOnMovement = false;
+			}
+		}
+	}
+}
+
+AActor* FFuseActorPool::Acquire(UWorld* World, UClass* ActorClass, const FTransform& Transform)
+{
+	if (!World || !ActorClass) { return nullptr; }
+
+	if (FuseActorPool::FClassPools* ClassPools = FuseActorPool::Pools.Find(World))
+	{
+		if (TArray<TWeakObjectPtr<AActor>>* Pool = ClassPools->Find(ActorClass))
+		{
+			while (Pool->Num() > 0)
+			{
+				AActor* Actor = Pool->Pop(false).Get();
+				if (!Actor || Actor->IsActorBeingDestroyed()) { continue; }
+
+				Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+				Actor->SetActorHiddenInGame(false);
+				Actor->SetActorEnableCollision(true);
+				Actor->SetActorTickEnabled(Actor->PrimaryActorTick.bStartWithTickEnabled);
+				for (UActorComponent* Component : Actor->GetComponents())
+				{
+					Component->SetComponentTickEnabled(Component->PrimaryComponentTick.bStartWithTickEnabled);
+				}
+				return Actor;
+			}
+		}
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return World->SpawnActor<AActor>(ActorClass, Transform, SpawnParameters);
+}
+
+void FFuseActorPool::Release(AActor* Actor)
+{
+	UWorld* World = Actor ? Actor->GetWorld() : nullptr;
+	if (!World || Actor->IsActorBeingDestroyed()) { return; }
+
+	if (!FuseActorPool::WorldCleanupHandle.IsValid())
+	{
+		FuseActorPool::WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&FuseActorPool::RemoveWorldPools);
+	}
+
+	FuseActorPool::Deactivate(Actor);
+	FuseActorPool::Pools.FindOrAdd(World).FindOrAdd(Actor->GetClass()).Add(Actor);
+}
+
+void FFuseActorPool::Prewarm(UWorld* World, UClass* ActorClass, const int32 Count)
+{
+	if (!World || !ActorClass) { return; }
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		// Released straight away, they're moved into place when acquired
+		if (AActor* Actor = World->SpawnActor<AActor>(ActorClass, FTransform::Identity, SpawnParameters))
+		{
+			Release(Actor);
+		}
+	}
+}
+
+int32 FFuseActorPool::NumPooled(const UWorld* World)
+{
+	const FuseActorPool::FClassPools* ClassPools = FuseActorPool::Pools.Find(World);
+	if (!ClassPools) { return 0; }
+
+	int32 Pooled = 0;
+	for (const TPair<TObjectKey<UClass>, TArray<TWeakObjectPtr<AActor>>>& ClassPool : *ClassPools) { Pooled += ClassPool.Value.Num(); }
+	return Pooled;
+}
+
+int32 FFuseActorPool::NumPooled(const UWorld* World, const UClass* ActorClass)
+{
+	const FuseActorPool::FClassPools* ClassPools = FuseActorPool::Pools.Find(World);
+	const TArray<TWeakObjectPtr<AActor>>* Pool = ClassPools ? ClassPools->Find(ActorClass) : nullptr;
+	return Pool ? Pool->Num() : 0;
+}
@@ -0,0 +1,31 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+ *
+ * Pools of hidden actors per world and class, so bulk spawns like assembly templates reuse actors rather than
+ * constructing new ones. Released actors are hidden with collision, physics and actor and component ticking off, and
+ * scene captures only capture on demand. They are destroyed with their world.
+ *
+ */
+
+class FUSE_API FFuseActorPool
+{
+public:
+	// Take a pooled actor of a class and move it to Transform, or spawn one if the pool is empty
+	static AActor* Acquire(UWorld* World, UClass* ActorClass, const FTransform& Transform);
+
+	// Return an actor to the pool of its class
+	static void Release(AActor* Actor);
+
+	// Spawn actors into a pool ahead of time, so the first acquire doesn't construct them
+	static void Prewarm(UWorld* World, UClass* ActorClass, int32 Count);
+
+	// Actors waiting in every pool of a world
+	static int32 NumPooled(const UWorld* World);
+
+	// Actors waiting in the pool of one class
+	static int32 NumPooled(const UWorld* World, const UClass* ActorClass);
+};
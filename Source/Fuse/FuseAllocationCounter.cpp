@@ -0,0 +1,161 @@
+
+#include "FuseAllocationCounter.h"
+
+#if FUSE_ALLOCATION_COUNTER
+
+#include <atomic>
+
+static FAutoConsoleCommand FuseAllocsCommand(
+	TEXT("f.fuseallocs"),
+	TEXT("Count heap allocations made by fuse ticks. Args: start, stop (logs the result)"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() > 0 && Args[0] == TEXT("start"))
+		{
+			FFuseAllocationCounter::Start();
+		}
+		else
+		{
+			FFuseAllocationCounter::Stop();
+			FFuseAllocationCounter::Dump();
+		}
+	}));
+
+namespace FuseAllocationCounter
+{
+	static std::atomic<bool> bCounting = false;
+	// Only touched on the game thread
+	static bool bInScope = false;
+	static uint64 Allocations = 0;
+	static uint32 Samples = 0;
+	static uint32 SamplesWithAllocations = 0;
+	static uint64 MaxSampleAllocations = 0;
+
+	// Forwards everything to the wrapped allocator, counting game thread allocations inside fuse scopes
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* InInnerMalloc) : InnerMalloc(InInnerMalloc) {}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			// A realloc to zero is a free
+			if (Count > 0) { CountAllocation(); }
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0) { CountAllocation(); }
+			return InnerMalloc->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override { InnerMalloc->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return InnerMalloc->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return InnerMalloc->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { InnerMalloc->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { InnerMalloc->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void UpdateStats() override { InnerMalloc->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { InnerMalloc->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { InnerMalloc->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return InnerMalloc->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return InnerMalloc->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return InnerMalloc->GetDescriptiveName(); }
+
+	private:
+		static void CountAllocation()
+		{
+			if (bCounting.load(std::memory_order_relaxed) && IsInGameThread() && bInScope) { Allocations++; }
+		}
+
+		FMalloc* InnerMalloc;
+	};
+
+	static void InstallCountingMalloc()
+	{
+		// Other threads keep allocating while it's swapped, the exchange publishes the fully constructed proxy to them
+		// Threads still holding the old pointer call the same allocator the proxy forwards to, so either is safe to use
+		static bool bInstalled = false;
+		if (!bInstalled)
+		{
+			FCountingMalloc* CountingMalloc = new FCountingMalloc(GMalloc);
+			FPlatformAtomics::InterlockedExchangePtr(reinterpret_cast<void**>(&GMalloc), CountingMalloc);
+			bInstalled = true;
+		}
+	}
+}
+
+FFuseAllocationCounter::FScope::FScope()
+	: StartCount(FuseAllocationCounter::Allocations), bWasInScope(FuseAllocationCounter::bInScope)
+{
+	FuseAllocationCounter::bInScope = true;
+}
+
+FFuseAllocationCounter::FScope::~FScope()
+{
+	FuseAllocationCounter::bInScope = bWasInScope;
+
+	// Nested scopes are part of the outer sample
+	if (bWasInScope || !IsCounting()) { return; }
+	const uint64 SampleAllocations = FuseAllocationCounter::Allocations - StartCount;
+	FuseAllocationCounter::Samples++;
+	if (SampleAllocations > 0) { FuseAllocationCounter::SamplesWithAllocations++; }
+	FuseAllocationCounter::MaxSampleAllocations = FMath::Max(FuseAllocationCounter::MaxSampleAllocations, SampleAllocations);
+}
+
+void FFuseAllocationCounter::Start()
+{
+	check(IsInGameThread());
+	FuseAllocationCounter::InstallCountingMalloc();
+	FuseAllocationCounter::Allocations = 0;
+	FuseAllocationCounter::Samples = 0;
+	FuseAllocationCounter::SamplesWithAllocations = 0;
+	FuseAllocationCounter::MaxSampleAllocations = 0;
+	FuseAllocationCounter::bCounting = true;
+	UE_LOG(LogTemp, Display, TEXT("Counting fuse tick allocations"));
+}
+
+void FFuseAllocationCounter::Stop()
+{
+	FuseAllocationCounter::bCounting = false;
+}
+
+bool FFuseAllocationCounter::IsCounting()
+{
+	return FuseAllocationCounter::bCounting.load(std::memory_order_relaxed);
+}
+
+uint64 FFuseAllocationCounter::GetAllocationCount()
+{
+	return FuseAllocationCounter::Allocations;
+}
+
+void FFuseAllocationCounter::Dump()
+{
+	const uint32 Samples = FuseAllocationCounter::Samples;
+	UE_LOG(LogTemp, Display, TEXT("Fuse allocations: %llu over %u ticks, %u ticks allocated, max %llu in one tick"),
+	       FuseAllocationCounter::Allocations, Samples, FuseAllocationCounter::SamplesWithAllocations,
+	       FuseAllocationCounter::MaxSampleAllocations);
+
+	// The first search after a new mesh is seen builds its socket table, anything past that is a regression
+	if (FuseAllocationCounter::SamplesWithAllocations > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Fuse ticks allocated in %.1f%% of ticks, the steady state should be allocation free"),
+		       Samples > 0 ? 100.0 * FuseAllocationCounter::SamplesWithAllocations / Samples : 0.0);
+	}
+}
+
+#endif
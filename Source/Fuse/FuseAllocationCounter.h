@@ -0,0 +1,52 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Allocation counting is a development tool, it's compiled out of shipping builds
+#define FUSE_ALLOCATION_COUNTER !UE_BUILD_SHIPPING
+
+/*
+ *
+ * Counts game thread heap allocations made inside fuse scopes, to check the fuse hot path stays allocation free.
+ * Counting wraps GMalloc in a forwarding proxy the first time it's enabled, the proxy is left in place afterwards
+ * since other threads may still be calling through it. f.fuseallocs [start|stop], the Fuse.Performance.SearchAllocations
+ * automation test fails if a steady state socket search allocates.
+ *
+ */
+
+#if FUSE_ALLOCATION_COUNTER
+
+class FUSE_API FFuseAllocationCounter
+{
+public:
+	// Counts allocations made while it's in scope, each scope is one sample
+	class FScope
+	{
+	public:
+		FScope();
+		~FScope();
+
+	private:
+		uint64 StartCount;
+		bool bWasInScope;
+	};
+
+	static void Start();
+	static void Stop();
+	static bool IsCounting();
+
+	// Allocations counted inside scopes since counting started
+	static uint64 GetAllocationCount();
+
+	// Log the samples since counting started
+	static void Dump();
+};
+
+#define FUSE_SCOPE_ALLOCATION_COUNTER() FFuseAllocationCounter::FScope FuseAllocationScope
+
+#else
+
+#define FUSE_SCOPE_ALLOCATION_COUNTER()
+
+#endif
@@ -0,0 +1,795 @@
+
+#include "FuseAssembly.h"
+#include "FuseActorPool.h"
+#include "FFuseComponent.h"
+#include "FuseOrientationTable.h"
+#include "FuseSocketTable.h"
+#include "FuseStats.h"
+#include "EngineUtils.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/StaticMesh.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "PhysicsEngine/PhysicsConstraintActor.h"
+#include "PhysicsEngine/PhysicsConstraintComponent.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace FuseAssembly
+{
+	static constexpr uint32 Magic = 0x41535546; // "FUSA"
+	// Part locations are stored in whole multiples of this, relative to the first part
+	static constexpr double LocationResolution = 0.01;
+	// Relative rotations further than this from the orientation grid are stored in full
+	static constexpr float SnapToleranceRadians = 0.001f;
+	// Counts in a loaded file past this are treated as corrupt, rather than allocated
+	static constexpr int32 MaxCount = 1 << 20;
+	// Parts joined to another sit at its bounds, this covers sockets slightly outside them
+	static constexpr float JointSearchMargin = 10.0f;
+
+	enum EPartFlags : uint8
+	{
+		PartFlag_PlacedActor = 1 << 0,
+		PartFlag_ExactRotation = 1 << 1,
+		PartFlag_Scaled = 1 << 2,
+	};
+
+	static void SerializePacked(FArchive& Ar, int32& Value)
+	{
+		uint32 Packed = static_cast<uint32>(Value);
+		Ar.SerializeIntPacked(Packed);
+		Value = static_cast<int32>(Packed);
+	}
+
+	// Zigzag encode signed values, so small negative values pack as small as small positive ones
+	static void SerializeSignedPacked(FArchive& Ar, int32& Value)
+	{
+		uint32 Packed = (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+		Ar.SerializeIntPacked(Packed);
+		Value = static_cast<int32>(Packed >> 1) ^ -static_cast<int32>(Packed & 1);
+	}
+
+	static bool SerializeCount(FArchive& Ar, int32& Count)
+	{
+		SerializePacked(Ar, Count);
+		if (Ar.IsLoading() && (Count < 0 || Count > MaxCount)) { Ar.SetError(); }
+		return !Ar.IsError();
+	}
+
+	static void SerializeName(FArchive& Ar, FName& Name)
+	{
+		FString String = Name.ToString();
+		Ar << String;
+		if (Ar.IsLoading()) { Name = FName(*String); }
+	}
+
+	static void SerializeQuantizedLocation(FArchive& Ar, FVector& Location)
+	{
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			int32 Quantized = FMath::RoundToInt32(FMath::Clamp(Location[Axis] / LocationResolution, static_cast<double>(MIN_int32), static_cast<double>(MAX_int32)));
+			SerializeSignedPacked(Ar, Quantized);
+			Location[Axis] = Quantized * LocationResolution;
+		}
+	}
+
+	static void SerializePart(FArchive& Ar, FFuseAssemblyPart& Part, const FFuseOrientationTable& Orientations)
+	{
+		FVector Location = Part.RelativeTransform.GetLocation();
+		FQuat Rotation = Part.RelativeTransform.GetRotation();
+		FVector Scale = Part.RelativeTransform.GetScale3D();
+
+		// Fused parts are on the orientation grid relative to each other, so most rotations are a single index
+		uint16 Orientation = 0;
+		uint8 Flags = 0;
+		if (Ar.IsSaving())
+		{
+			Orientation = Orientations.Snap(Rotation);
+			if (Orientations.GetQuat(Orientation).AngularDistance(Rotation) > SnapToleranceRadians) { Flags |= PartFlag_ExactRotation; }
+			if (Part.PlacedActor != INDEX_NONE) { Flags |= PartFlag_PlacedActor; }
+			if (!Scale.Equals(FVector::OneVector)) { Flags |= PartFlag_Scaled; }
+		}
+
+		Ar << Flags;
+		SerializePacked(Ar, Part.Asset);
+		if (Flags & PartFlag_PlacedActor) { SerializePacked(Ar, Part.PlacedActor); }
+		SerializeQuantizedLocation(Ar, Location);
+		if (Flags & PartFlag_ExactRotation)
+		{
+			FQuat4f ExactRotation(Rotation);
+			Ar << ExactRotation;
+			Rotation = FQuat(ExactRotation);
+		}
+		else
+		{
+			uint32 PackedOrientation = Orientation;
+			Ar.SerializeIntPacked(PackedOrientation);
+			if (Ar.IsLoading() && static_cast<int32>(PackedOrientation) >= Orientations.Num()) { Ar.SetError(); return; }
+			Rotation = Orientations.GetQuat(static_cast<uint16>(PackedOrientation));
+		}
+		if (Flags & PartFlag_Scaled)
+		{
+			FVector3f PartScale(Scale);
+			Ar << PartScale;
+			Scale = FVector(PartScale);
+		}
+
+		Part.RelativeTransform = FTransform(Rotation.GetNormalized(), Location, Scale);
+	}
+
+	static void SerializeJoint(FArchive& Ar, FFuseAssemblyJoint& Joint)
+	{
+		int32 SourceSocket = Joint.Sockets.SourceSocket;
+		int32 TargetSocket = Joint.Sockets.TargetSocket;
+		SerializePacked(Ar, Joint.SourcePart);
+		SerializePacked(Ar, Joint.TargetPart);
+		SerializePacked(Ar, SourceSocket);
+		SerializePacked(Ar, TargetSocket);
+		Joint.Sockets.SourceSocket = static_cast<uint16>(SourceSocket);
+		Joint.Sockets.TargetSocket = static_cast<uint16>(TargetSocket);
+	}
+
+	// Only the server builds assemblies, clients follow the replicated movement of the parts
+	static bool CanSaveOrLoad(const UWorld* World)
+	{
+		if (!World) { return false; }
+		if (World->GetNetMode() == NM_Client)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Fuse assemblies can only be saved and loaded on the server"));
+			return false;
+		}
+		return true;
+	}
+
+	// Actor classes and meshes of an archive, loaded on first use so each is resolved once rather than once per part
+	struct FResolvedAssets
+	{
+		explicit FResolvedAssets(const FFuseAssemblyArchive& InArchive)
+			: Archive(InArchive), Resolved(false, InArchive.Assets.Num())
+		{
+			ActorClasses.SetNumZeroed(Archive.Assets.Num());
+			StaticMeshes.SetNumZeroed(Archive.Assets.Num());
+		}
+
+		void Resolve(const int32 AssetIndex)
+		{
+			if (Resolved[AssetIndex]) { return; }
+			Resolved[AssetIndex] = true;
+			const FFuseAssemblyAsset& Asset = Archive.Assets[AssetIndex];
+			ActorClasses[AssetIndex] = Asset.ActorClass.TryLoadClass<AActor>();
+			StaticMeshes[AssetIndex] = Cast<UStaticMesh>(Asset.StaticMesh.TryLoad());
+			if (!ActorClasses[AssetIndex]) { UE_LOG(LogTemp, Warning, TEXT("Fuse assembly part class %s couldn't be loaded"), *Asset.ActorClass.ToString()); }
+		}
+
+		UClass* GetActorClass(const int32 AssetIndex) { Resolve(AssetIndex); return ActorClasses[AssetIndex]; }
+		UStaticMesh* GetStaticMesh(const int32 AssetIndex) { Resolve(AssetIndex); return StaticMeshes[AssetIndex]; }
+
+		const FFuseAssemblyArchive& Archive;
+		TBitArray<> Resolved;
+		TArray<UClass*> ActorClasses;
+		TArray<UStaticMesh*> StaticMeshes;
+	};
+
+	// Instantiated assemblies are inset by this much for the placement check, so resting on the ground isn't an overlap
+	static constexpr float PlacementInset = 2.0f;
+
+	// Assemblies built by f.fusespawnassembly, so they can be released again
+	static TArray<TWeakObjectPtr<UPrimitiveComponent>> SpawnedParts;
+
+	// Get the parts a fuse constraint joins, false if it isn't between the fusable sockets of two components
+	static bool GetFuseJoint(UPhysicsConstraintComponent* Constraint, const FString& SocketSubName,
+	                         UPrimitiveComponent*& OutTargetComponent, UPrimitiveComponent*& OutSourceComponent)
+	{
+		if (!Constraint) { return false; }
+		FName TargetBone, SourceBone;
+		Constraint->GetConstrainedComponents(OutTargetComponent, TargetBone, OutSourceComponent, SourceBone);
+		if (!OutTargetComponent || !OutSourceComponent || OutTargetComponent == OutSourceComponent) { return false; }
+		return FFuseSocketTable::Get(OutTargetComponent, SocketSubName).FindSocketIndex(Constraint->GetAttachSocketName()) != INDEX_NONE
+		       && !FFuseSocketTable::Get(OutSourceComponent, SocketSubName).IsEmpty();
+	}
+
+	// Fuse settings of a world, from its first fuse component or the defaults
+	static const UFFuseComponent* FindFuseSettings(const UWorld* World)
+	{
+		for (TObjectIterator<UFFuseComponent> It; It; ++It)
+		{
+			if (It->GetWorld() == World) { return *It; }
+		}
+		return GetDefault<UFFuseComponent>();
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs FuseSaveAssembliesCommand(
+	TEXT("f.fusesaveassemblies"),
+	TEXT("Save every fused assembly in the world. Args: [File]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!FuseAssembly::CanSaveOrLoad(World)) { return; }
+		const UFFuseComponent* Settings = FuseAssembly::FindFuseSettings(World);
+		FFuseAssemblySerializer::SaveToFile(World, Args.Num() > 0 ? Args[0] : FFuseAssemblySerializer::GetDefaultFileName(),
+		                                    Settings->FusableSocketSubName, Settings->ComponentRotationMultiplier);
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs FuseLoadAssembliesCommand(
+	TEXT("f.fuseloadassemblies"),
+	TEXT("Build the fused assemblies saved by f.fusesaveassemblies. Args: [File]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!FuseAssembly::CanSaveOrLoad(World)) { return; }
+		const UFFuseComponent* Settings = FuseAssembly::FindFuseSettings(World);
+		FFuseAssemblySerializer::LoadFromFile(World, Args.Num() > 0 ? Args[0] : FFuseAssemblySerializer::GetDefaultFileName(),
+		                                      Settings->PhysicsConstraintActor, Settings->FusableSocketSubName);
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs FuseSpawnAssemblyCommand(
+	TEXT("f.fusespawnassembly"),
+	TEXT("Build a copy of a saved assembly in front of the player, or release the copies built so far. Args: Index=0 File= Prewarm=0 | release"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!FuseAssembly::CanSaveOrLoad(World)) { return; }
+		if (Args.Num() > 0 && Args[0] == TEXT("release"))
+		{
+			TArray<UPrimitiveComponent*> Parts;
+			for (const TWeakObjectPtr<UPrimitiveComponent>& Part : FuseAssembly::SpawnedParts)
+			{
+				if (Part.IsValid()) { Parts.Add(Part.Get()); }
+			}
+			FFuseAssemblySerializer::Release(Parts);
+			FuseAssembly::SpawnedParts.Reset();
+			UE_LOG(LogTemp, Display, TEXT("Released %d assembly parts to the pool"), Parts.Num());
+			return;
+		}
+
+		const FString Params = FString::Join(Args, TEXT(" "));
+		int32 Index = 0;
+		int32 Prewarm = 0;
+		FString FileName = FFuseAssemblySerializer::GetDefaultFileName();
+		FParse::Value(*Params, TEXT("Index="), Index);
+		FParse::Value(*Params, TEXT("Prewarm="), Prewarm);
+		FParse::Value(*Params, TEXT("File="), FileName);
+
+		FFuseAssemblyArchive Archive;
+		if (!FFuseAssemblySerializer::ReadFromFile(FileName, Archive)) { return; }
+		if (!Archive.Assemblies.IsValidIndex(Index))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s has %d assemblies, there's no assembly %d"), *FileName, Archive.Assemblies.Num(), Index);
+			return;
+		}
+		const FFuseAssembly& Assembly = Archive.Assemblies[Index];
+		if (Prewarm > 0) { FFuseAssemblySerializer::Prewarm(World, Archive, Assembly, Prewarm); }
+
+		APlayerController* PlayerController = World->GetFirstPlayerController();
+		if (!PlayerController) { return; }
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		FCollisionQueryParams QueryParams;
+		QueryParams.AddIgnoredActor(PlayerController->GetPawn());
+
+		// In front of the player far enough to clear them, facing the same way and resting on whatever is below
+		const FQuat Facing = FRotator(0.0f, ViewRotation.Yaw, 0.0f).Quaternion();
+		const FBox Bounds = FFuseAssemblySerializer::CalcTemplateBounds(Archive, Assembly);
+		const FVector Centre = ViewLocation + Facing.GetForwardVector() * (Bounds.GetExtent().Size2D() + 200.0f);
+		FVector Location = Centre - Facing.RotateVector(Bounds.GetCenter());
+		FHitResult GroundHit;
+		if (World->LineTraceSingleByChannel(GroundHit, Centre, Centre - FVector(0.0f, 0.0f, 10000.0f), ECC_WorldStatic, QueryParams))
+		{
+			Location.Z = GroundHit.ImpactPoint.Z - Bounds.Min.Z;
+		}
+
+		const UFFuseComponent* Settings = FuseAssembly::FindFuseSettings(World);
+		const int32 PooledBefore = FFuseActorPool::NumPooled(World);
+		const double StartTime = FPlatformTime::Seconds();
+		TArray<UPrimitiveComponent*> Parts;
+		if (!FFuseAssemblySerializer::Instantiate(World, Archive, Assembly, FTransform(Facing, Location), Settings->PhysicsConstraintActor,
+		                                          Settings->FusableSocketSubName, Parts, QueryParams))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Assembly %d doesn't fit in front of the player"), Index);
+			return;
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("Built assembly %d: %d parts (%d from the pool), %d joints in %.2fms"), Index, Parts.Num(),
+		       PooledBefore - FFuseActorPool::NumPooled(World), Assembly.Joints.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+		FuseAssembly::SpawnedParts.Append(Parts);
+	}),
+	ECVF_Cheat);
+
+int32 FFuseAssemblyArchive::NumParts() const
+{
+	int32 Parts = 0;
+	for (const FFuseAssembly& Assembly : Assemblies) { Parts += Assembly.Parts.Num(); }
+	return Parts;
+}
+
+int32 FFuseAssemblyArchive::NumJoints() const
+{
+	int32 Joints = 0;
+	for (const FFuseAssembly& Assembly : Assemblies) { Joints += Assembly.Joints.Num(); }
+	return Joints;
+}
+
+void FFuseAssemblySerializer::FindAssemblies(UWorld* World, const FString& SocketSubName, TArray<FFuseAssemblyComponents>& OutAssemblies)
+{
+	OutAssemblies.Reset();
+	if (!World) { return; }
+
+	// Union find over the fused components, so every assembly is collected in one pass over the constraints
+	TMap<UPrimitiveComponent*, int32> ComponentIndices;
+	TArray<UPrimitiveComponent*> Components;
+	TArray<int32> Parents;
+	TArray<TPair<UPhysicsConstraintComponent*, int32>> Joints;
+	auto FindRoot = [&Parents](int32 Index)
+	{
+		while (Parents[Index] != Index)
+		{
+			Parents[Index] = Parents[Parents[Index]];
+			Index = Parents[Index];
+		}
+		return Index;
+	};
+	auto AddComponent = [&](UPrimitiveComponent* Component)
+	{
+		if (const int32* Found = ComponentIndices.Find(Component)) { return *Found; }
+		const int32 Index = Components.Add(Component);
+		Parents.Add(Index);
+		ComponentIndices.Add(Component, Index);
+		return Index;
+	};
+
+	for (TActorIterator<APhysicsConstraintActor> It(World); It; ++It)
+	{
+		UPhysicsConstraintComponent* Constraint = It->GetConstraintComp();
+		UPrimitiveComponent* TargetComponent = nullptr;
+		UPrimitiveComponent* SourceComponent = nullptr;
+		if (!FuseAssembly::GetFuseJoint(Constraint, SocketSubName, TargetComponent, SourceComponent)) { continue; }
+
+		const int32 TargetIndex = AddComponent(TargetComponent);
+		const int32 SourceIndex = AddComponent(SourceComponent);
+		Joints.Emplace(Constraint, TargetIndex);
+		Parents[FindRoot(SourceIndex)] = FindRoot(TargetIndex);
+	}
+
+	// Split the components into assemblies, the first component found in each is its first part
+	TMap<int32, int32> AssemblyIndices;
+	for (int32 Index = 0; Index < Components.Num(); Index++)
+	{
+		int32& AssemblyIndex = AssemblyIndices.FindOrAdd(FindRoot(Index), INDEX_NONE);
+		if (AssemblyIndex == INDEX_NONE) { AssemblyIndex = OutAssemblies.AddDefaulted(); }
+		OutAssemblies[AssemblyIndex].Parts.Add(Components[Index]);
+	}
+	for (const TPair<UPhysicsConstraintComponent*, int32>& Joint : Joints)
+	{
+		OutAssemblies[AssemblyIndices[FindRoot(Joint.Value)]].Joints.Add(Joint.Key);
+	}
+}
+
+bool FFuseAssemblySerializer::FindAssembly(UWorld* World, const FString& SocketSubName, UPrimitiveComponent* Part,
+                                          FFuseAssemblyComponents& OutAssembly)
+{
+	OutAssembly.Parts.Reset();
+	OutAssembly.Joints.Reset();
+	if (!World || !Part) { return false; }
+
+	// Walk the joints out from the part rather than every constraint in the world, so the cost only grows with the
+	// assembly. Joints are attached to their target part, so the ones a part is the source of are on the parts it touches
+	TSet<const UPrimitiveComponent*> FoundParts;
+	TSet<const UPhysicsConstraintComponent*> FoundJoints;
+	TArray<FOverlapResult> Neighbours;
+	FCollisionObjectQueryParams ObjectQueryParams;
+	ObjectQueryParams.AddObjectTypesToQuery(ECC_PhysicsBody);
+	OutAssembly.Parts.Add(Part);
+	FoundParts.Add(Part);
+	for (int32 PartIndex = 0; PartIndex < OutAssembly.Parts.Num(); PartIndex++)
+	{
+		UPrimitiveComponent* Current = OutAssembly.Parts[PartIndex];
+		auto AddJointsOn = [&](const UPrimitiveComponent* JointParent)
+		{
+			for (USceneComponent* Child : JointParent->GetAttachChildren())
+			{
+				UPhysicsConstraintComponent* Constraint = Cast<UPhysicsConstraintComponent>(Child);
+				UPrimitiveComponent* TargetComponent = nullptr;
+				UPrimitiveComponent* SourceComponent = nullptr;
+				if (!FuseAssembly::GetFuseJoint(Constraint, SocketSubName, TargetComponent, SourceComponent)) { continue; }
+				if ((TargetComponent != Current && SourceComponent != Current) || FoundJoints.Contains(Constraint)) { continue; }
+
+				FoundJoints.Add(Constraint);
+				OutAssembly.Joints.Add(Constraint);
+				UPrimitiveComponent* Other = TargetComponent == Current ? SourceComponent : TargetComponent;
+				if (!FoundParts.Contains(Other))
+				{
+					FoundParts.Add(Other);
+					OutAssembly.Parts.Add(Other);
+				}
+			}
+		};
+		AddJointsOn(Current);
+
+		Neighbours.Reset();
+		World->OverlapMultiByObjectType(Neighbours, Current->Bounds.Origin, FQuat::Identity, ObjectQueryParams,
+		                                FCollisionShape::MakeSphere(Current->Bounds.SphereRadius + FuseAssembly::JointSearchMargin));
+		FUSE_INC_COUNTER(OverlapQueries, 1);
+		for (const FOverlapResult& Neighbour : Neighbours)
+		{
+			if (Neighbour.GetComponent() && Neighbour.GetComponent() != Current) { AddJointsOn(Neighbour.GetComponent()); }
+		}
+	}
+	return OutAssembly.Joints.Num() > 0;
+}
+
+void FFuseAssemblySerializer::Gather(UWorld* World, const FString& SocketSubName, const float RotationMultiple, FFuseAssemblyArchive& OutArchive)
+{
+	TArray<FFuseAssemblyComponents> AssemblyComponents;
+	FindAssemblies(World, SocketSubName, AssemblyComponents);
+	Gather(World, AssemblyComponents, SocketSubName, RotationMultiple, OutArchive);
+}
+
+void FFuseAssemblySerializer::Gather(UWorld* World, const TConstArrayView<FFuseAssemblyComponents> AssemblyComponents, const FString& SocketSubName,
+                                     const float RotationMultiple, FFuseAssemblyArchive& OutArchive)
+{
+	OutArchive = FFuseAssemblyArchive();
+	OutArchive.RotationMultiple = RotationMultiple;
+
+	TMap<FString, int32> AssetIndices;
+	TMap<const UPrimitiveComponent*, int32> PartIndices;
+	for (const FFuseAssemblyComponents& Components : AssemblyComponents)
+	{
+		FFuseAssembly& Assembly = OutArchive.Assemblies.AddDefaulted_GetRef();
+		Assembly.RootTransform = Components.Parts[0]->GetComponentTransform();
+		PartIndices.Reset();
+		for (UPrimitiveComponent* Component : Components.Parts)
+		{
+			PartIndices.Add(Component, Assembly.Parts.Num());
+			FFuseAssemblyPart& Part = Assembly.Parts.AddDefaulted_GetRef();
+			Part.RelativeTransform = Component->GetComponentTransform().GetRelativeTransform(Assembly.RootTransform);
+
+			FFuseAssemblyAsset Asset;
+			const AActor* Owner = Component->GetOwner();
+			if (Owner) { Asset.ActorClass = Owner->GetClass(); }
+			if (const UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(Component))
+			{
+				Asset.StaticMesh = StaticMeshComponent->GetStaticMesh();
+			}
+			Asset.ComponentName = Component->GetFName();
+			Asset.CollisionProfile = Component->GetCollisionProfileName();
+			const FString AssetKey = FString::Printf(TEXT("%s|%s|%s|%s"), *Asset.ActorClass.ToString(), *Asset.StaticMesh.ToString(),
+			                                         *Asset.ComponentName.ToString(), *Asset.CollisionProfile.ToString());
+			int32& AssetIndex = AssetIndices.FindOrAdd(AssetKey, INDEX_NONE);
+			if (AssetIndex == INDEX_NONE) { AssetIndex = OutArchive.Assets.Add(Asset); }
+			Part.Asset = AssetIndex;
+
+			if (Owner && Owner->HasAnyFlags(RF_WasLoaded))
+			{
+				Part.PlacedActor = OutArchive.PlacedActors.Add(Owner->GetPathName(World));
+			}
+		}
+
+		for (UPhysicsConstraintComponent* Constraint : Components.Joints)
+		{
+			UPrimitiveComponent* TargetComponent = nullptr;
+			UPrimitiveComponent* SourceComponent = nullptr;
+			FuseAssembly::GetFuseJoint(Constraint, SocketSubName, TargetComponent, SourceComponent);
+			const FFuseSocketTable& TargetSockets = FFuseSocketTable::Get(TargetComponent, SocketSubName);
+			const FFuseSocketTable& SourceSockets = FFuseSocketTable::Get(SourceComponent, SocketSubName);
+			const int32 TargetSocket = TargetSockets.FindSocketIndex(Constraint->GetAttachSocketName());
+
+			// Constraints only record the target socket, the source socket is the one that was fused on to it
+			const FVector JointLocation = TargetSockets.GetSocketLocation(TargetSocket, TargetComponent->GetComponentTransform());
+			const FTransform& SourceTransform = SourceComponent->GetComponentTransform();
+			int32 SourceSocket = 0;
+			double ClosestDistanceSquared = MAX_dbl;
+			for (int32 Index = 0; Index < SourceSockets.Num(); Index++)
+			{
+				const double DistanceSquared = FVector::DistSquared(JointLocation, SourceSockets.GetSocketLocation(Index, SourceTransform));
+				if (DistanceSquared < ClosestDistanceSquared)
+				{
+					ClosestDistanceSquared = DistanceSquared;
+					SourceSocket = Index;
+				}
+			}
+
+			FFuseAssemblyJoint& Joint = Assembly.Joints.AddDefaulted_GetRef();
+			Joint.TargetPart = PartIndices[TargetComponent];
+			Joint.SourcePart = PartIndices[SourceComponent];
+			Joint.Sockets.SourceSocket = static_cast<uint16>(SourceSocket);
+			Joint.Sockets.TargetSocket = static_cast<uint16>(TargetSocket);
+		}
+	}
+}
+
+bool FFuseAssemblySerializer::Serialize(FArchive& Ar, FFuseAssemblyArchive& Archive)
+{
+	uint32 Magic = FuseAssembly::Magic;
+	uint16 ArchiveVersion = Version;
+	Ar << Magic;
+	Ar << ArchiveVersion;
+	if (Ar.IsLoading() && (Magic != FuseAssembly::Magic || ArchiveVersion == 0 || ArchiveVersion > Version))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Not a fuse assembly save, or saved by a newer version"));
+		return false;
+	}
+	Ar << Archive.RotationMultiple;
+	const FFuseOrientationTable& Orientations = FFuseOrientationTable::Get(Archive.RotationMultiple);
+
+	int32 NumAssets = Archive.Assets.Num();
+	if (!FuseAssembly::SerializeCount(Ar, NumAssets)) { return false; }
+	if (Ar.IsLoading()) { Archive.Assets.SetNum(NumAssets); }
+	for (FFuseAssemblyAsset& Asset : Archive.Assets)
+	{
+		FString ActorClass = Asset.ActorClass.ToString();
+		FString StaticMesh = Asset.StaticMesh.ToString();
+		Ar << ActorClass;
+		Ar << StaticMesh;
+		FuseAssembly::SerializeName(Ar, Asset.ComponentName);
+		FuseAssembly::SerializeName(Ar, Asset.CollisionProfile);
+		if (Ar.IsLoading())
+		{
+			Asset.ActorClass = FSoftClassPath(ActorClass);
+			Asset.StaticMesh = FSoftObjectPath(StaticMesh);
+		}
+	}
+
+	int32 NumPlacedActors = Archive.PlacedActors.Num();
+	if (!FuseAssembly::SerializeCount(Ar, NumPlacedActors)) { return false; }
+	if (Ar.IsLoading()) { Archive.PlacedActors.SetNum(NumPlacedActors); }
+	for (FString& PlacedActor : Archive.PlacedActors) { Ar << PlacedActor; }
+
+	int32 NumAssemblies = Archive.Assemblies.Num();
+	if (!FuseAssembly::SerializeCount(Ar, NumAssemblies)) { return false; }
+	if (Ar.IsLoading()) { Archive.Assemblies.SetNum(NumAssemblies); }
+	for (FFuseAssembly& Assembly : Archive.Assemblies)
+	{
+		// The root is the only full precision transform in an assembly
+		FVector RootLocation = Assembly.RootTransform.GetLocation();
+		FQuat4f RootRotation(Assembly.RootTransform.GetRotation());
+		FVector3f RootScale(Assembly.RootTransform.GetScale3D());
+		Ar << RootLocation;
+		Ar << RootRotation;
+		Ar << RootScale;
+		Assembly.RootTransform = FTransform(FQuat(RootRotation).GetNormalized(), RootLocation, FVector(RootScale));
+
+		int32 NumParts = Assembly.Parts.Num();
+		if (!FuseAssembly::SerializeCount(Ar, NumParts)) { return false; }
+		if (Ar.IsLoading()) { Assembly.Parts.SetNum(NumParts); }
+		for (FFuseAssemblyPart& Part : Assembly.Parts)
+		{
+			FuseAssembly::SerializePart(Ar, Part, Orientations);
+			if (Ar.IsLoading() && (!Archive.Assets.IsValidIndex(Part.Asset) ||
+			                       (Part.PlacedActor != INDEX_NONE && !Archive.PlacedActors.IsValidIndex(Part.PlacedActor))))
+			{
+				Ar.SetError();
+			}
+			if (Ar.IsError()) { return false; }
+		}
+
+		int32 NumJoints = Assembly.Joints.Num();
+		if (!FuseAssembly::SerializeCount(Ar, NumJoints)) { return false; }
+		if (Ar.IsLoading()) { Assembly.Joints.SetNum(NumJoints); }
+		for (FFuseAssemblyJoint& Joint : Assembly.Joints)
+		{
+			FuseAssembly::SerializeJoint(Ar, Joint);
+			if (Ar.IsLoading() && (!Assembly.Parts.IsValidIndex(Joint.SourcePart) || !Assembly.Parts.IsValidIndex(Joint.TargetPart))) { Ar.SetError(); }
+			if (Ar.IsError()) { return false; }
+		}
+	}
+	return !Ar.IsError();
+}
+
+void FFuseAssemblySerializer::Spawn(UWorld* World, const FFuseAssemblyArchive& Archive, const FFuseAssembly& Assembly, const FTransform& RootTransform,
+                                    const TSubclassOf<APhysicsConstraintActor> ConstraintClass, const FString& SocketSubName,
+                                    const bool bReusePlacedActors, TArray<UPrimitiveComponent*>& OutParts)
+{
+	OutParts.Reset();
+	OutParts.SetNumZeroed(Assembly.Parts.Num());
+	if (!World) { return; }
+
+	FuseAssembly::FResolvedAssets ResolvedAssets(Archive);
+
+	// Place every part with physics off, so nothing is pushed apart or dropped before the joints exist
+	for (int32 PartIndex = 0; PartIndex < Assembly.Parts.Num(); PartIndex++)
+	{
+		const FFuseAssemblyPart& Part = Assembly.Parts[PartIndex];
+		if (!Archive.Assets.IsValidIndex(Part.Asset)) { continue; }
+		const FFuseAssemblyAsset& Asset = Archive.Assets[Part.Asset];
+
+		const FTransform Transform = Part.RelativeTransform * RootTransform;
+		AActor* Actor = bReusePlacedActors && Archive.PlacedActors.IsValidIndex(Part.PlacedActor)
+			? FindObject<AActor>(World, *Archive.PlacedActors[Part.PlacedActor]) : nullptr;
+		if (Actor && Actor->IsActorBeingDestroyed()) { Actor = nullptr; }
+		const bool bSpawned = !Actor;
+		if (bSpawned) { Actor = FFuseActorPool::Acquire(World, ResolvedAssets.GetActorClass(Part.Asset), Transform); }
+		if (!Actor) { continue; }
+
+		UPrimitiveComponent* Component = nullptr;
+		for (UActorComponent* ActorComponent : Actor->GetComponents())
+		{
+			if (ActorComponent->GetFName() == Asset.ComponentName) { Component = Cast<UPrimitiveComponent>(ActorComponent); break; }
+		}
+		if (!Component) { Component = Cast<UPrimitiveComponent>(Actor->GetRootComponent()); }
+		if (!Component) { continue; }
+
+		Component->SetMobility(EComponentMobility::Movable);
+		if (bSpawned)
+		{
+			UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(Component);
+			UStaticMesh* StaticMesh = ResolvedAssets.GetStaticMesh(Part.Asset);
+			if (StaticMeshComponent && StaticMesh) { StaticMeshComponent->SetStaticMesh(StaticMesh); }
+			if (!Asset.CollisionProfile.IsNone()) { Component->SetCollisionProfileName(Asset.CollisionProfile); }
+		}
+		Component->SetSimulatePhysics(false);
+		Component->SetWorldTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+		OutParts[PartIndex] = Component;
+	}
+
+	// Every joint in one pass, the parts are already where the fuse would have left them
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	for (const FFuseAssemblyJoint& Joint : Assembly.Joints)
+	{
+		UPrimitiveComponent* SourceComponent = OutParts.IsValidIndex(Joint.SourcePart) ? OutParts[Joint.SourcePart] : nullptr;
+		UPrimitiveComponent* TargetComponent = OutParts.IsValidIndex(Joint.TargetPart) ? OutParts[Joint.TargetPart] : nullptr;
+		if (!SourceComponent || !TargetComponent) { continue; }
+		const FFuseSocketTable& TargetSockets = FFuseSocketTable::Get(TargetComponent, SocketSubName);
+		if (Joint.Sockets.TargetSocket >= TargetSockets.Num()) { continue; }
+
+		APhysicsConstraintActor* ConstraintActor = World->SpawnActor<APhysicsConstraintActor>(
+			ConstraintClass, TargetComponent->GetComponentLocation(), TargetComponent->GetComponentRotation(), SpawnParameters);
+		if (!ConstraintActor) { continue; }
+		FUSE_INC_COUNTER(ConstraintsSpawned, 1);
+
+		UPhysicsConstraintComponent* ConstraintComp = ConstraintActor->GetConstraintComp();
+		ConstraintComp->AttachToComponent(TargetComponent, FAttachmentTransformRules::SnapToTargetNotIncludingScale, TargetSockets[Joint.Sockets.TargetSocket].Name);
+		ConstraintComp->SetAngularTwistLimit(ACM_Limited, 1.0f);
+		ConstraintComp->SetAngularSwing1Limit(ACM_Limited, 1.0f);
+		ConstraintComp->SetAngularSwing2Limit(ACM_Limited, 1.0f);
+		ConstraintComp->SetConstrainedComponents(TargetComponent, NAME_None, SourceComponent, NAME_None);
+	}
+
+	for (UPrimitiveComponent* Component : OutParts)
+	{
+		if (Component) { Component->SetSimulatePhysics(true); }
+	}
+}
+
+FBox FFuseAssemblySerializer::CalcTemplateBounds(const FFuseAssemblyArchive& Archive, const FFuseAssembly& Assembly)
+{
+	FuseAssembly::FResolvedAssets ResolvedAssets(Archive);
+	const FTransform TemplateRoot(Assembly.RootTransform.GetRotation(), FVector::ZeroVector, Assembly.RootTransform.GetScale3D());
+	FBox Bounds(ForceInit);
+	for (const FFuseAssemblyPart& Part : Assembly.Parts)
+	{
+		const FTransform Transform = Part.RelativeTransform * TemplateRoot;
+		const UStaticMesh* StaticMesh = Archive.Assets.IsValidIndex(Part.Asset) ? ResolvedAssets.GetStaticMesh(Part.Asset) : nullptr;
+		if (StaticMesh) { Bounds += StaticMesh->GetBoundingBox().TransformBy(Transform); }
+		else { Bounds += Transform.GetLocation(); }
+	}
+	return Bounds;
+}
+
+bool FFuseAssemblySerializer::Instantiate(UWorld* World, const FFuseAssemblyArchive& Archive, const FFuseAssembly& Assembly, const FTransform& Transform,
+                                          const TSubclassOf<APhysicsConstraintActor> ConstraintClass, const FString& SocketSubName,
+                                          TArray<UPrimitiveComponent*>& OutParts, const FCollisionQueryParams& QueryParams)
+{
+	OutParts.Reset();
+	if (!World) { return false; }
+
+	// One box around the whole assembly rather than a query per part, it can reject a fit a per part check would
+	// allow around concave assemblies, but its cost doesn't grow with the part count
+	const FBox Bounds = CalcTemplateBounds(Archive, Assembly);
+	const FVector Extent = (Bounds.GetExtent() * Transform.GetScale3D().GetAbs() - FVector(FuseAssembly::PlacementInset)).ComponentMax(FVector::ZeroVector);
+	FCollisionObjectQueryParams ObjectQueryParams;
+	ObjectQueryParams.AddObjectTypesToQuery(ECC_WorldStatic);
+	ObjectQueryParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+	ObjectQueryParams.AddObjectTypesToQuery(ECC_PhysicsBody);
+	FUSE_INC_COUNTER(OverlapQueries, 1);
+	if (World->OverlapAnyTestByObjectType(Transform.TransformPosition(Bounds.GetCenter()), Transform.GetRotation(), ObjectQueryParams,
+	                                      FCollisionShape::MakeBox(Extent), QueryParams))
+	{
+		return false;
+	}
+
+	const FTransform TemplateRoot(Assembly.RootTransform.GetRotation(), FVector::ZeroVector, Assembly.RootTransform.GetScale3D());
+	Spawn(World, Archive, Assembly, TemplateRoot * Transform, ConstraintClass, SocketSubName, false, OutParts);
+	return true;
+}
+
+void FFuseAssemblySerializer::Prewarm(UWorld* World, const FFuseAssemblyArchive& Archive, const FFuseAssembly& Assembly, const int32 Copies)
+{
+	TMap<int32, int32> AssetParts;
+	for (const FFuseAssemblyPart& Part : Assembly.Parts)
+	{
+		if (Archive.Assets.IsValidIndex(Part.Asset)) { AssetParts.FindOrAdd(Part.Asset)++; }
+	}
+
+	FuseAssembly::FResolvedAssets ResolvedAssets(Archive);
+	for (const TPair<int32, int32>& AssetPart : AssetParts)
+	{
+		FFuseActorPool::Prewarm(World, ResolvedAssets.GetActorClass(AssetPart.Key), AssetPart.Value * Copies);
+	}
+}
+
+void FFuseAssemblySerializer::Release(const TConstArrayView<UPrimitiveComponent*> Parts)
+{
+	for (UPrimitiveComponent* Part : Parts)
+	{
+		if (!Part) { continue; }
+
+		// Joints are attached to their target part, so every joint between the parts is found from one side
+		for (USceneComponent* Child : TArray<USceneComponent*>(Part->GetAttachChildren()))
+		{
+			const UPhysicsConstraintComponent* Constraint = Cast<UPhysicsConstraintComponent>(Child);
+			if (Constraint && Constraint->GetOwner()) { Constraint->GetOwner()->Destroy(); }
+		}
+	}
+	for (UPrimitiveComponent* Part : Parts)
+	{
+		if (Part) { FFuseActorPool::Release(Part->GetOwner()); }
+	}
+}
+
+bool FFuseAssemblySerializer::ReadFromFile(const FString& FileName, FFuseAssemblyArchive& OutArchive, int64* OutFileSize)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FileName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't read fuse assemblies from %s"), *FileName);
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	if (!Serialize(Reader, OutArchive))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s isn't a valid fuse assembly save"), *FileName);
+		return false;
+	}
+	if (OutFileSize) { *OutFileSize = Bytes.Num(); }
+	return true;
+}
+
+bool FFuseAssemblySerializer::SaveToFile(UWorld* World, const FString& FileName, const FString& SocketSubName, const float RotationMultiple)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	FFuseAssemblyArchive Archive;
+	Gather(World, SocketSubName, RotationMultiple, Archive);
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	Serialize(Writer, Archive);
+	if (!FFileHelper::SaveArrayToFile(Bytes, *FileName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't write fuse assemblies to %s"), *FileName);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Saved %d fuse assemblies (%d parts, %d joints) to %s: %d bytes in %.2fms"),
+	       Archive.Assemblies.Num(), Archive.NumParts(), Archive.NumJoints(), *FileName, Bytes.Num(),
+	       (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return true;
+}
+
+bool FFuseAssemblySerializer::LoadFromFile(UWorld* World, const FString& FileName, const TSubclassOf<APhysicsConstraintActor> ConstraintClass, const FString& SocketSubName)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	FFuseAssemblyArchive Archive;
+	int64 FileSize = 0;
+	if (!ReadFromFile(FileName, Archive, &FileSize)) { return false; }
+	const double ReadTime = FPlatformTime::Seconds();
+
+	TArray<UPrimitiveComponent*> Parts;
+	for (const FFuseAssembly& Assembly : Archive.Assemblies)
+	{
+		Spawn(World, Archive, Assembly, Assembly.RootTransform, ConstraintClass, SocketSubName, true, Parts);
+	}
+
+	const double EndTime = FPlatformTime::Seconds();
+	UE_LOG(LogTemp, Display, TEXT("Loaded %d fuse assemblies (%d parts, %d joints) from %s: %lld bytes, read in %.2fms, built in %.2fms"),
+	       Archive.Assemblies.Num(), Archive.NumParts(), Archive.NumJoints(), *FileName, FileSize,
+	       (ReadTime - StartTime) * 1000.0, (EndTime - ReadTime) * 1000.0);
+	return true;
+}
+
+FString FFuseAssemblySerializer::GetDefaultFileName()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Fuse") / TEXT("Assemblies.fuse");
+}
@@ -0,0 +1,140 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FuseOperation.h"
+#include "CollisionQueryParams.h"
+
+class APhysicsConstraintActor;
+class UPhysicsConstraintComponent;
+class UPrimitiveComponent;
+
+// An actor class and mesh that parts are spawned from, shared by every part using them
+struct FFuseAssemblyAsset
+{
+	FSoftClassPath ActorClass;
+	// Only set for static mesh parts
+	FSoftObjectPath StaticMesh;
+	// The fusable component of the actor
+	FName ComponentName;
+	// Spawned parts get their collision from the actor class, which isn't always what the part used
+	FName CollisionProfile;
+};
+
+// A part of an assembly, placed relative to the first part of the assembly
+struct FFuseAssemblyPart
+{
+	// Index into the file assets
+	int32 Asset = INDEX_NONE;
+	// Index into the file placed actors when the part was placed in the level rather than spawned, so reloading
+	// the level moves the placed actor back into the assembly instead of spawning a copy
+	int32 PlacedActor = INDEX_NONE;
+	FTransform RelativeTransform;
+};
+
+// A fuse constraint between two parts, the same as a constraint spawned by a finished fuse
+struct FFuseAssemblyJoint
+{
+	// Indices into the assembly parts, the source is the part that was fused on to the target
+	int32 SourcePart = INDEX_NONE;
+	int32 TargetPart = INDEX_NONE;
+	FFuseSocketPair Sockets;
+};
+
+// A set of parts held together by fuse constraints
+struct FFuseAssembly
+{
+	// World transform of the first part
+	FTransform RootTransform;
+	TArray<FFuseAssemblyPart> Parts;
+	TArray<FFuseAssemblyJoint> Joints;
+};
+
+// The live components of an assembly in a world
+struct FFuseAssemblyComponents
+{
+	TArray<UPrimitiveComponent*> Parts;
+	TArray<UPhysicsConstraintComponent*> Joints;
+};
+
+// Every assembly in a save, with the assets and placed actors they share
+struct FFuseAssemblyArchive
+{
+	// Multiple the relative rotations were snapped to, see FFuseOrientationTable
+	float RotationMultiple = 45.0f;
+	TArray<FFuseAssemblyAsset> Assets;
+	TArray<FString> PlacedActors;
+	TArray<FFuseAssembly> Assemblies;
+
+	int32 NumParts() const;
+	int32 NumJoints() const;
+};
+
+/*
+ *
+ * Saves fused assemblies to a compact binary form and builds them again from it.
+ * Assemblies are found by walking the fuse constraints in the world. Parts are stored as indices into a shared asset
+ * table with transforms relative to the first part, rotations as FFuseOrientationTable indices when they're on the
+ * fuse rotation grid and locations quantized to packed integers. Joints are stored as socket indices.
+ * Loading spawns every part with physics off, constrains them all in one pass and then simulates them together,
+ * nothing goes through the fuse interpolation.
+ * Saved assemblies are also templates that can be built again anywhere with Instantiate, from pooled part actors and
+ * with a single overlap query around the whole assembly to check it fits.
+ * f.fusesaveassemblies [File] / f.fuseloadassemblies [File] / f.fusespawnassembly Index=0 File= Prewarm=0
+ *
+ */
+
+class FUSE_API FFuseAssemblySerializer
+{
+public:
+	// Bumped whenever the binary layout changes, older versions are still read
+	static constexpr uint16 Version = 1;
+
+	// Find the components of every assembly in a world, joined by fuse constraints between fusable sockets
+	static void FindAssemblies(UWorld* World, const FString& SocketSubName, TArray<FFuseAssemblyComponents>& OutAssemblies);
+
+	// Find the components of the assembly a part is in, returns false if it isn't fused to anything
+	// Walks the joints out from the part, with an overlap query per part, so it doesn't depend on the size of the world
+	static bool FindAssembly(UWorld* World, const FString& SocketSubName, UPrimitiveComponent* Part, FFuseAssemblyComponents& OutAssembly);
+
+	// Find every assembly of fused components in a world
+	static void Gather(UWorld* World, const FString& SocketSubName, float RotationMultiple, FFuseAssemblyArchive& OutArchive);
+
+	// Only the given assemblies, in the same order and with their parts in the same order, see FindAssemblies
+	static void Gather(UWorld* World, TConstArrayView<FFuseAssemblyComponents> Assemblies, const FString& SocketSubName, float RotationMultiple,
+	                   FFuseAssemblyArchive& OutArchive);
+
+	// Read or write an archive, returns false if a loaded archive is invalid
+	static bool Serialize(FArchive& Ar, FFuseAssemblyArchive& Archive);
+
+	// Build an assembly with its first part at RootTransform, returns the parts in assembly order
+	// Parts that couldn't be spawned are null, and their joints are skipped
+	// Parts that were placed in the level are moved into the assembly when bReusePlacedActors, otherwise they're copied
+	static void Spawn(UWorld* World, const FFuseAssemblyArchive& Archive, const FFuseAssembly& Assembly, const FTransform& RootTransform,
+	                  TSubclassOf<APhysicsConstraintActor> ConstraintClass, const FString& SocketSubName, bool bReusePlacedActors,
+	                  TArray<UPrimitiveComponent*>& OutParts);
+
+	// Bounds of an assembly's part meshes in template space, its saved world orientation with the first part at the origin
+	static FBox CalcTemplateBounds(const FFuseAssemblyArchive& Archive, const FFuseAssembly& Assembly);
+
+	// Build a copy of an assembly with its template space at Transform, see CalcTemplateBounds
+	// Returns false without spawning anything if the assembly bounds overlap anything
+	static bool Instantiate(UWorld* World, const FFuseAssemblyArchive& Archive, const FFuseAssembly& Assembly, const FTransform& Transform,
+	                        TSubclassOf<APhysicsConstraintActor> ConstraintClass, const FString& SocketSubName, TArray<UPrimitiveComponent*>& OutParts,
+	                        const FCollisionQueryParams& QueryParams = FCollisionQueryParams::DefaultQueryParam);
+
+	// Fill the actor pools with the parts of an assembly, so that many copies can be instantiated without spawning
+	static void Prewarm(UWorld* World, const FFuseAssemblyArchive& Archive, const FFuseAssembly& Assembly, int32 Copies);
+
+	// Break the joints of instantiated parts and return them to the actor pools
+	static void Release(TConstArrayView<UPrimitiveComponent*> Parts);
+
+	// Read an archive saved by SaveToFile, without building anything
+	static bool ReadFromFile(const FString& FileName, FFuseAssemblyArchive& OutArchive, int64* OutFileSize = nullptr);
+
+	static bool SaveToFile(UWorld* World, const FString& FileName, const FString& SocketSubName, float RotationMultiple);
+	static bool LoadFromFile(UWorld* World, const FString& FileName, TSubclassOf<APhysicsConstraintActor> ConstraintClass, const FString& SocketSubName);
+
+	// Default save file, in the project saved directory
+	static FString GetDefaultFileName();
+};
@@ -0,0 +1,308 @@
+
+#include "FuseBenchmark.h"
+#include "FuseAllocationCounter.h"
+#include "FFuseComponent.h"
+#include "FFuseStressWorldGenerator.h"
+#include "FuseSocketTable.h"
+#include "FuseTargetTransforms.h"
+#include "EngineUtils.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/CollisionProfile.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+static FAutoConsoleCommandWithWorldAndArgs FuseBenchmarkCommand(
+	TEXT("f.fusebenchmark"),
+	TEXT("Run the fuse socket search and fuse benchmark. Args: Grid=2+4+8 Sockets=4+8+16 Iterations=20 Mesh=<path> Output=<file>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		FFuseBenchmarkSettings Settings;
+		Settings.ParseFromString(FString::Join(Args, TEXT(" ")));
+		FFuseBenchmark::Run(World, Settings);
+	}),
+	ECVF_Cheat);
+
+namespace FuseBenchmark
+{
+	// Lists are separated with + or , since ExecCmds already splits commands on commas
+	static void ParseIntList(const TCHAR* Stream, const TCHAR* Match, TArray<int32>& OutList)
+	{
+		FString ListString;
+		if (!FParse::Value(Stream, Match, ListString, false)) { return; }
+
+		TArray<FString> Entries;
+		ListString.Replace(TEXT("+"), TEXT(",")).ParseIntoArray(Entries, TEXT(","));
+		OutList.Reset();
+		for (const FString& Entry : Entries)
+		{
+			const int32 Value = FCString::Atoi(*Entry);
+			if (Value > 0) { OutList.Add(Value); }
+		}
+	}
+
+	static double CyclesToMs(const uint64 Cycles)
+	{
+		return FPlatformTime::ToMilliseconds64(Cycles);
+	}
+
+	// The scene component version of FFuseTargetTransforms, reading socket and component transforms from the components
+	static FTransform ReferenceTargetTransform(const UPrimitiveComponent* Source, const FName SourceSocket,
+		const UPrimitiveComponent* Target, const FName TargetSocket, const FFuseOrientationTable& Orientations)
+	{
+		const FQuat TargetRotation = Target->GetComponentQuat();
+		const FQuat SourceTargetRotation = TargetRotation * Orientations.GetQuat(Orientations.Snap(TargetRotation.Inverse() * Source->GetSocketQuaternion(SourceSocket)));
+		const FVector ZeroedSocketOffset = Source->GetComponentQuat().UnrotateVector(Source->GetComponentLocation() - Source->GetSocketLocation(SourceSocket));
+		return FTransform(SourceTargetRotation, SourceTargetRotation.RotateVector(ZeroedSocketOffset) + Target->GetSocketLocation(TargetSocket));
+	}
+}
+
+void FFuseBenchmarkSettings::ParseFromString(const FString& Params)
+{
+	FuseBenchmark::ParseIntList(*Params, TEXT("Grid="), GridSizes);
+	FuseBenchmark::ParseIntList(*Params, TEXT("Sockets="), SocketCounts);
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	FParse::Value(*Params, TEXT("Spacing="), GridSpacing);
+	FParse::Value(*Params, TEXT("Mesh="), MeshPath, false);
+	FParse::Value(*Params, TEXT("Output="), OutputPath, false);
+	Iterations = FMath::Max(1, Iterations);
+	GridSpacing = FMath::Max(1.0f, GridSpacing);
+}
+
+TSharedRef<FJsonObject> FFuseBenchmark::Run(UWorld* World, const FFuseBenchmarkSettings& Settings)
+{
+	TSharedRef<FJsonObject> Results = MakeShared<FJsonObject>();
+	if (!World)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Fuse benchmark requires a game world"));
+		return Results;
+	}
+
+	UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, *Settings.MeshPath);
+	if (!Mesh)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Fuse benchmark failed to load mesh %s"), *Settings.MeshPath);
+		return Results;
+	}
+
+	Results->SetStringField(TEXT("Map"), World->GetMapName());
+	Results->SetStringField(TEXT("Mesh"), Settings.MeshPath);
+	Results->SetNumberField(TEXT("Iterations"), Settings.Iterations);
+	Results->SetStringField(TEXT("Timestamp"), FDateTime::UtcNow().ToIso8601());
+
+	TArray<TSharedPtr<FJsonValue>> Cases;
+	for (const int32 SocketCount : Settings.SocketCounts)
+	{
+		for (const int32 GridSize : Settings.GridSizes)
+		{
+			Cases.Add(MakeShared<FJsonValueObject>(RunCase(World, Mesh, GridSize, SocketCount, Settings)));
+		}
+	}
+	Results->SetArrayField(TEXT("Cases"), Cases);
+
+	const FString OutputPath = Settings.OutputPath.IsEmpty()
+		? FPaths::ProjectSavedDir() / TEXT("Fuse") / FString::Printf(TEXT("Benchmark_%s.json"), *FDateTime::Now().ToString())
+		: Settings.OutputPath;
+	WriteResults(Results, OutputPath);
+	return Results;
+}
+
+TSharedRef<FJsonObject> FFuseBenchmark::RunCase(UWorld* World, UStaticMesh* Mesh, const int32 GridSize,
+	const int32 SocketCount, const FFuseBenchmarkSettings& Settings)
+{
+	TSharedRef<FJsonObject> Case = MakeShared<FJsonObject>();
+	Case->SetNumberField(TEXT("GridSize"), GridSize);
+	Case->SetNumberField(TEXT("Props"), GridSize * GridSize);
+	Case->SetNumberField(TEXT("Sockets"), SocketCount);
+
+	// Keep track of constraints that existed before the case, so only the ones spawned by the case are cleaned up
+	TSet<AActor*> ExistingConstraintActors;
+	for (TActorIterator<APhysicsConstraintActor> It(World); It; ++It) { ExistingConstraintActors.Add(*It); }
+
+	UFFuseComponent* Fuser = SpawnBenchmarkFuser(World, FVector::ZeroVector);
+	AFFuseStressWorldGenerator::AddGeneratedAttachSockets(Mesh, Fuser->FusableSocketSubName, SocketCount);
+
+	// Spawn the grid far away from anything in the loaded map, props don't simulate so the layout stays fixed
+	const FVector GridOrigin(0.0f, 0.0f, 100000.0f);
+	const FVector PropExtent = Mesh->GetBoundingBox().GetExtent() * 2.0f;
+	const FVector PropSpacing = PropExtent * Settings.GridSpacing;
+	TArray<AStaticMeshActor*> Props;
+	auto SpawnProp = [&](const FVector& Location)
+	{
+		AStaticMeshActor* Prop = World->SpawnActor<AStaticMeshActor>(Location, FRotator::ZeroRotator);
+		Prop->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+		Prop->GetStaticMeshComponent()->SetStaticMesh(Mesh);
+		Prop->GetStaticMeshComponent()->SetCollisionProfileName(UCollisionProfile::PhysicsActor_ProfileName);
+		Props.Add(Prop);
+		return Prop;
+	};
+	for (int32 X = 0; X < GridSize; X++)
+	{
+		for (int32 Y = 0; Y < GridSize; Y++)
+		{
+			SpawnProp(GridOrigin + FVector(X * PropSpacing.X, Y * PropSpacing.Y, 0.0f));
+		}
+	}
+
+	// Hold the source prop just above the middle of the grid, within fuse distance of the grid props below it
+	const FVector GridCentre = GridOrigin + FVector((GridSize - 1) * PropSpacing.X, (GridSize - 1) * PropSpacing.Y, 0.0f) * 0.5f;
+	const AStaticMeshActor* SourceProp = SpawnProp(GridCentre + FVector(0.0f, 0.0f, PropExtent.Z + Fuser->MaxFuseDistance * 0.25f));
+	UPrimitiveComponent* SourceComponent = SourceProp->GetStaticMeshComponent();
+	Fuser->GrabComponentAtLocationWithRotation(SourceComponent, NAME_None, SourceComponent->GetComponentLocation(), SourceComponent->GetComponentRotation());
+	Fuser->UpdateFuserState(FSTATE_FUSING);
+
+	// Socket search
+	uint64 SearchTotalCycles = 0;
+	uint64 SearchMinCycles = MAX_uint64;
+	uint64 SearchMaxCycles = 0;
+	bool bFoundFuse = false;
+#if FUSE_ALLOCATION_COUNTER
+	// The first search builds the socket tables, every search after it should be allocation free
+	const bool bWasCountingAllocations = FFuseAllocationCounter::IsCounting();
+	if (!bWasCountingAllocations) { FFuseAllocationCounter::Start(); }
+	uint64 SearchAllocations = 0;
+#endif
+	for (int32 Iteration = 0; Iteration < Settings.Iterations; Iteration++)
+	{
+		Fuser->ClearFuseOperationData();
+#if FUSE_ALLOCATION_COUNTER
+		const uint64 StartAllocations = FFuseAllocationCounter::GetAllocationCount();
+#endif
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		{
+			FUSE_SCOPE_ALLOCATION_COUNTER();
+			bFoundFuse = Fuser->TryFindIdealFuseSockets(Fuser->LastFuseOperation, true);
+		}
+		const uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+#if FUSE_ALLOCATION_COUNTER
+		if (Iteration > 0) { SearchAllocations += FFuseAllocationCounter::GetAllocationCount() - StartAllocations; }
+#endif
+		SearchTotalCycles += Cycles;
+		SearchMinCycles = FMath::Min(SearchMinCycles, Cycles);
+		SearchMaxCycles = FMath::Max(SearchMaxCycles, Cycles);
+	}
+#if FUSE_ALLOCATION_COUNTER
+	if (!bWasCountingAllocations) { FFuseAllocationCounter::Stop(); }
+	Case->SetNumberField(TEXT("SearchAllocations"), SearchAllocations);
+#endif
+	Case->SetBoolField(TEXT("FoundFuse"), bFoundFuse);
+	Case->SetNumberField(TEXT("SupplementalPairs"), Fuser->LastFuseOperation.SupplementalPairs.Num());
+	Case->SetNumberField(TEXT("SearchAvgMs"), FuseBenchmark::CyclesToMs(SearchTotalCycles) / Settings.Iterations);
+	Case->SetNumberField(TEXT("SearchMinMs"), FuseBenchmark::CyclesToMs(SearchMinCycles));
+	Case->SetNumberField(TEXT("SearchMaxMs"), FuseBenchmark::CyclesToMs(SearchMaxCycles));
+
+	// Check the batched target transforms against the scene component path, for every socket pair with every prop
+	const FFuseSocketTable& SourceSockets = FFuseSocketTable::Get(SourceComponent, Fuser->FusableSocketSubName);
+	const FFuseOrientationTable& Orientations = Fuser->GetOrientationTable();
+	TArray<FFuseSocketPair> Pairs;
+	TArray<FTransform> BatchTransforms;
+	uint64 BatchCycles = 0;
+	uint64 ReferenceCycles = 0;
+	double MaxLocationError = 0.0;
+	double MaxAngleError = 0.0;
+	for (const AStaticMeshActor* Prop : Props)
+	{
+		const UPrimitiveComponent* TargetComponent = Prop->GetStaticMeshComponent();
+		if (TargetComponent == SourceComponent) { continue; }
+		const FFuseSocketTable& TargetSockets = FFuseSocketTable::Get(TargetComponent, Fuser->FusableSocketSubName);
+		Pairs.Reset();
+		for (int32 SourceIndex = 0; SourceIndex < SourceSockets.Num(); SourceIndex++)
+		{
+			for (int32 TargetIndex = 0; TargetIndex < TargetSockets.Num(); TargetIndex++)
+			{
+				Pairs.Add({static_cast<uint16>(SourceIndex), static_cast<uint16>(TargetIndex)});
+			}
+		}
+		BatchTransforms.SetNumUninitialized(Pairs.Num());
+
+		uint64 StartCycles = FPlatformTime::Cycles64();
+		FFuseTargetTransforms::Compute(SourceComponent->GetComponentTransform(), SourceSockets.GetSockets(),
+		                               TargetComponent->GetComponentTransform(), TargetSockets.GetSockets(),
+		                               Pairs, Orientations, BatchTransforms);
+		BatchCycles += FPlatformTime::Cycles64() - StartCycles;
+
+		for (int32 PairIndex = 0; PairIndex < Pairs.Num(); PairIndex++)
+		{
+			StartCycles = FPlatformTime::Cycles64();
+			const FTransform Reference = FuseBenchmark::ReferenceTargetTransform(
+				SourceComponent, SourceSockets[Pairs[PairIndex].SourceSocket].Name,
+				TargetComponent, TargetSockets[Pairs[PairIndex].TargetSocket].Name, Orientations);
+			ReferenceCycles += FPlatformTime::Cycles64() - StartCycles;
+
+			MaxLocationError = FMath::Max(MaxLocationError, FVector::Distance(Reference.GetLocation(), BatchTransforms[PairIndex].GetLocation()));
+			MaxAngleError = FMath::Max(MaxAngleError, Reference.GetRotation().AngularDistance(BatchTransforms[PairIndex].GetRotation()));
+		}
+	}
+	Case->SetNumberField(TEXT("TargetTransformBatchMs"), FuseBenchmark::CyclesToMs(BatchCycles));
+	Case->SetNumberField(TEXT("TargetTransformReferenceMs"), FuseBenchmark::CyclesToMs(ReferenceCycles));
+	Case->SetNumberField(TEXT("TargetTransformMaxLocationError"), MaxLocationError);
+	Case->SetNumberField(TEXT("TargetTransformMaxAngleError"), MaxAngleError);
+	if (MaxLocationError > 0.01 || MaxAngleError > 0.001)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Batched fuse target transforms differ from the scene component path by up to %.4f units, %.5f radians"),
+		       MaxLocationError, MaxAngleError);
+	}
+
+	// Fuse, stepping the interp at a fixed rate until it finishes or hits the snap failsafe
+	const float FuseDeltaTime = 1.0f / 60.0f;
+	const int32 MaxFuseSteps = FMath::CeilToInt((Fuser->FuseMaxTimeBeforeSnap + 1.0f) / FuseDeltaTime);
+	int32 FuseSteps = 0;
+	uint64 FuseStartCycles = FPlatformTime::Cycles64();
+	if (Fuser->TryFuseObjects())
+	{
+		while (Fuser->GetCurrentFuseState() == FSTATE_ACTIVEFUSING && FuseSteps < MaxFuseSteps)
+		{
+			Fuser->FuseObjects(FuseDeltaTime);
+			FuseSteps++;
+		}
+	}
+	const double FuseTotalMs = FuseBenchmark::CyclesToMs(FPlatformTime::Cycles64() - FuseStartCycles);
+	Case->SetBoolField(TEXT("FuseCompleted"), bFoundFuse && Fuser->GetCurrentFuseState() == FSTATE_NONE);
+	Case->SetNumberField(TEXT("FuseSteps"), FuseSteps);
+	Case->SetNumberField(TEXT("FuseTotalMs"), FuseTotalMs);
+	Case->SetNumberField(TEXT("FuseAvgStepMs"), FuseSteps > 0 ? FuseTotalMs / FuseSteps : 0.0);
+
+	UE_LOG(LogTemp, Display, TEXT("Fuse benchmark: %d props, %d sockets, search avg %.3fms, fuse %.3fms over %d steps"),
+	       GridSize * GridSize, SocketCount, FuseBenchmark::CyclesToMs(SearchTotalCycles) / Settings.Iterations, FuseTotalMs, FuseSteps);
+
+	// Clean up everything spawned by the case
+	if (Fuser->GetGrabbedComponent()) { Fuser->ReleaseComponent(); }
+	for (TActorIterator<APhysicsConstraintActor> It(World); It; ++It)
+	{
+		if (!ExistingConstraintActors.Contains(*It)) { It->Destroy(); }
+	}
+	for (AStaticMeshActor* Prop : Props) { Prop->Destroy(); }
+	Fuser->GetOwner()->Destroy();
+	AFFuseStressWorldGenerator::RemoveGeneratedAttachSockets(Mesh, Fuser->FusableSocketSubName);
+
+	return Case;
+}
+
+UFFuseComponent* FFuseBenchmark::SpawnBenchmarkFuser(UWorld* World, const FVector& Location)
+{
+	// A pawn without a controller, so the fuse tick never has a view point to search from
+	AActor* FuserActor = World->SpawnActor<APawn>(Location, FRotator::ZeroRotator);
+	UFFuseComponent* Fuser = NewObject<UFFuseComponent>(FuserActor);
+	FuserActor->AddInstanceComponent(Fuser);
+	Fuser->RegisterComponent();
+	return Fuser;
+}
+
+void FFuseBenchmark::WriteResults(const TSharedRef<FJsonObject>& Results, const FString& OutputPath)
+{
+	FString OutputString;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputString);
+	FJsonSerializer::Serialize(Results, Writer);
+
+	if (FFileHelper::SaveStringToFile(OutputString, *OutputPath))
+	{
+		UE_LOG(LogTemp, Display, TEXT("Fuse results written to %s"), *OutputPath);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("Fuse failed to write results to %s"), *OutputPath);
+	}
+}
@@ -0,0 +1,57 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+
+class UFFuseComponent;
+class UStaticMesh;
+
+// Settings for a fuse benchmark run, parsed from the f.fusebenchmark console command
+struct FFuseBenchmarkSettings
+{
+	// Side lengths of the square prop grids to test, eg. 4 spawns 16 neighbouring props
+	TArray<int32> GridSizes = {2, 4, 8};
+
+	// Number of generated attach sockets on every prop
+	TArray<int32> SocketCounts = {4, 8, 16};
+
+	// Socket search repeats per case, timings are averaged
+	int32 Iterations = 20;
+
+	// Spacing between props in the grid, relative to the prop bounds
+	float GridSpacing = 1.1f;
+
+	// Mesh used for every prop in the grid
+	FString MeshPath = TEXT("/Game/LevelPrototyping/Meshes/SM_Cube.SM_Cube");
+
+	// Where the JSON results are written, defaults to Saved/Fuse/
+	FString OutputPath;
+
+	void ParseFromString(const FString& Params);
+};
+
+/*
+ *
+ * Headless benchmark for the fuse socket search and fuse operation.
+ * Spawns grids of fusable props with generated attach sockets, drives a fuse component through grab, search and fuse,
+ * and reports the timings of TryFindIdealFuseSockets and FuseObjects at each scale as JSON.
+ * Run with -nullrhi, eg. -ExecCmds="f.fusebenchmark Grid=4+8+16 Sockets=8+32, quit", lists are joined with + as
+ * ExecCmds splits on commas. The Fuse.Performance.Benchmark automation test runs it at a few scales
+ *
+ */
+
+class FUSE_API FFuseBenchmark
+{
+public:
+	// Run every grid size/socket count combination in the given world and write the results to disk
+	static TSharedRef<FJsonObject> Run(UWorld* World, const FFuseBenchmarkSettings& Settings);
+
+	// Spawn an actor with a fuse component that is driven manually by the benchmark
+	static UFFuseComponent* SpawnBenchmarkFuser(UWorld* World, const FVector& Location);
+
+	static void WriteResults(const TSharedRef<FJsonObject>& Results, const FString& OutputPath);
+
+private:
+	static TSharedRef<FJsonObject> RunCase(UWorld* World, UStaticMesh* Mesh, int32 GridSize, int32 SocketCount, const FFuseBenchmarkSettings& Settings);
+};
@@ -0,0 +1,158 @@
+
+#include "FuseDebugDraw.h"
+
+#if FUSE_DEBUG_DRAW
+
+#include "Components/LineBatchComponent.h"
+#include "VisualLogger/VisualLogger.h"
+
+static TAutoConsoleVariable<int32> CVarDrawDebugFuser(
+	TEXT("f.drawdebugfuser"), 0, TEXT("Debug output from fuse components. 0 off, 1 draw it, 2 capture it to the Visual Logger (record with vislog)"), ECVF_Cheat);
+
+namespace FuseDebugDraw
+{
+	enum EMode
+	{
+		Off = 0,
+		Draw = 1,
+		VisualLogger = 2
+	};
+
+	// Lines recorded this frame in each world, waiting to be handed to its line batcher
+	static TMap<TObjectKey<UWorld>, TArray<FBatchedLine>> Pending;
+	static FDelegateHandle PostActorTickHandle;
+	static FDelegateHandle WorldCleanupHandle;
+
+	static int32 GetMode() { return CVarDrawDebugFuser.GetValueOnGameThread(); }
+
+	// One submission per frame, however many shapes were recorded
+	static void SubmitPendingLines(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+	{
+		TArray<FBatchedLine>* WorldLines = Pending.Find(World);
+		if (!WorldLines || WorldLines->Num() == 0) { return; }
+
+		if (World->LineBatcher) { World->LineBatcher->DrawLines(*WorldLines); }
+		WorldLines->Reset();
+	}
+
+	static void RemoveWorldLines(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+	{
+		Pending.Remove(World);
+	}
+
+	static void AddLine(const UObject* Owner, const FVector& Start, const FVector& End, const FColor& Color, const float LifeTime, const float Thickness)
+	{
+		UWorld* World = Owner ? Owner->GetWorld() : nullptr;
+		if (!World) { return; }
+
+		if (!PostActorTickHandle.IsValid())
+		{
+			PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddStatic(&SubmitPendingLines);
+			WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&RemoveWorldLines);
+		}
+
+		// Same lifetime rules as DrawDebugLine
+		const float LineLifeTime = LifeTime > 0.0f || !World->LineBatcher ? LifeTime : World->LineBatcher->DefaultLifeTime;
+		Pending.FindOrAdd(World).Emplace(Start, End, FLinearColor(Color), LineLifeTime, Thickness, SDPG_World);
+	}
+
+	// Circle of lines around Centre in the plane of the X and Y axes, or an arc from X towards Y
+	static void AddArc(const UObject* Owner, const FVector& Centre, const FVector& X, const FVector& Y, const float Radius, const float Angle,
+	                   const int32 Segments, const FColor& Color, const float LifeTime, const float Thickness)
+	{
+		FVector Previous = Centre + X * Radius;
+		for (int32 Segment = 1; Segment <= Segments; Segment++)
+		{
+			float Sin, Cos;
+			FMath::SinCos(&Sin, &Cos, Angle * Segment / Segments);
+			const FVector Next = Centre + (X * Cos + Y * Sin) * Radius;
+			AddLine(Owner, Previous, Next, Color, LifeTime, Thickness);
+			Previous = Next;
+		}
+	}
+}
+
+bool FFuseDebugDraw::IsEnabled()
+{
+	const int32 Mode = FuseDebugDraw::GetMode();
+#if ENABLE_VISUAL_LOG
+	return Mode == FuseDebugDraw::Draw || (Mode == FuseDebugDraw::VisualLogger && FVisualLogger::IsRecording());
+#else
+	return Mode == FuseDebugDraw::Draw;
+#endif
+}
+
+void FFuseDebugDraw::Line(const UObject* Owner, const FVector& Start, const FVector& End, const FColor& Color, const float LifeTime, const float Thickness)
+{
+	if (FuseDebugDraw::GetMode() == FuseDebugDraw::VisualLogger)
+	{
+		UE_VLOG_SEGMENT_THICK(Owner, LogTemp, Verbose, Start, End, Color, static_cast<uint16>(Thickness), TEXT(""));
+		return;
+	}
+	FuseDebugDraw::AddLine(Owner, Start, End, Color, LifeTime, Thickness);
+}
+
+void FFuseDebugDraw::Arrow(const UObject* Owner, const FVector& Start, const FVector& End, const float ArrowSize, const FColor& Color,
+                           const float LifeTime, const float Thickness)
+{
+	if (FuseDebugDraw::GetMode() == FuseDebugDraw::VisualLogger)
+	{
+		UE_VLOG_ARROW(Owner, LogTemp, Verbose, Start, End, Color, TEXT(""));
+		return;
+	}
+
+	FuseDebugDraw::AddLine(Owner, Start, End, Color, LifeTime, Thickness);
+	const FVector Direction = (End - Start).GetSafeNormal();
+	if (Direction.IsZero()) { return; }
+	FVector Side, Up;
+	Direction.FindBestAxisVectors(Side, Up);
+	const FVector HeadBase = End - Direction * ArrowSize;
+	FuseDebugDraw::AddLine(Owner, End, HeadBase + Side * ArrowSize * 0.5f, Color, LifeTime, Thickness);
+	FuseDebugDraw::AddLine(Owner, End, HeadBase - Side * ArrowSize * 0.5f, Color, LifeTime, Thickness);
+}
+
+void FFuseDebugDraw::Sphere(const UObject* Owner, const FVector& Centre, const float Radius, const int32 Segments, const FColor& Color, const float LifeTime)
+{
+	if (FuseDebugDraw::GetMode() == FuseDebugDraw::VisualLogger)
+	{
+		UE_VLOG_LOCATION(Owner, LogTemp, Verbose, Centre, Radius, Color, TEXT(""));
+		return;
+	}
+
+	// Three rings rather than a full wire sphere, enough to see where and how big it is
+	const int32 RingSegments = FMath::Max(Segments, 4);
+	FuseDebugDraw::AddArc(Owner, Centre, FVector::XAxisVector, FVector::YAxisVector, Radius, UE_TWO_PI, RingSegments, Color, LifeTime, 0.0f);
+	FuseDebugDraw::AddArc(Owner, Centre, FVector::YAxisVector, FVector::ZAxisVector, Radius, UE_TWO_PI, RingSegments, Color, LifeTime, 0.0f);
+	FuseDebugDraw::AddArc(Owner, Centre, FVector::ZAxisVector, FVector::XAxisVector, Radius, UE_TWO_PI, RingSegments, Color, LifeTime, 0.0f);
+}
+
+void FFuseDebugDraw::Capsule(const UObject* Owner, const FVector& Centre, const float HalfHeight, const float Radius, const FQuat& Rotation,
+                             const FColor& Color, const float LifeTime, const float Thickness)
+{
+	const FVector AxisX = Rotation.GetAxisX();
+	const FVector AxisY = Rotation.GetAxisY();
+	const FVector AxisZ = Rotation.GetAxisZ();
+	if (FuseDebugDraw::GetMode() == FuseDebugDraw::VisualLogger)
+	{
+		UE_VLOG_CAPSULE(Owner, LogTemp, Verbose, Centre - AxisZ * HalfHeight, HalfHeight, Radius, Rotation, Color, TEXT(""));
+		return;
+	}
+
+	// Half height includes the caps, as with DrawDebugCapsule
+	constexpr int32 Segments = 8;
+	const float CylinderHalfHeight = FMath::Max(HalfHeight - Radius, 0.0f);
+	const FVector Top = Centre + AxisZ * CylinderHalfHeight;
+	const FVector Bottom = Centre - AxisZ * CylinderHalfHeight;
+	FuseDebugDraw::AddArc(Owner, Top, AxisX, AxisY, Radius, UE_TWO_PI, Segments, Color, LifeTime, Thickness);
+	FuseDebugDraw::AddArc(Owner, Bottom, AxisX, AxisY, Radius, UE_TWO_PI, Segments, Color, LifeTime, Thickness);
+	FuseDebugDraw::AddArc(Owner, Top, AxisX, AxisZ, Radius, UE_PI, Segments / 2, Color, LifeTime, Thickness);
+	FuseDebugDraw::AddArc(Owner, Top, AxisY, AxisZ, Radius, UE_PI, Segments / 2, Color, LifeTime, Thickness);
+	FuseDebugDraw::AddArc(Owner, Bottom, AxisX, -AxisZ, Radius, UE_PI, Segments / 2, Color, LifeTime, Thickness);
+	FuseDebugDraw::AddArc(Owner, Bottom, AxisY, -AxisZ, Radius, UE_PI, Segments / 2, Color, LifeTime, Thickness);
+	for (const FVector& Side : {AxisX, -AxisX, AxisY, -AxisY})
+	{
+		FuseDebugDraw::AddLine(Owner, Top + Side * Radius, Bottom + Side * Radius, Color, LifeTime, Thickness);
+	}
+}
+
+#endif
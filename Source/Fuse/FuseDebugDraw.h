@@ -0,0 +1,46 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Fuse debug drawing is a development tool, it's compiled out of shipping builds
+#define FUSE_DEBUG_DRAW !UE_BUILD_SHIPPING
+
+/*
+ *
+ * Recorder for fuse debug output. Shapes are broken into lines and batched per world, then handed to the world's line
+ * batcher once per frame, rather than each one being drawn immediately.
+ * f.drawdebugfuser 1 draws live, f.drawdebugfuser 2 captures to the Visual Logger instead, so a session recorded with
+ * vislog can be scrubbed afterwards.
+ * Check IsEnabled before working out anything to draw, it's a constant false in shipping so the checks compile out.
+ *
+ */
+
+#if FUSE_DEBUG_DRAW
+
+class FUSE_API FFuseDebugDraw
+{
+public:
+	static bool IsEnabled();
+
+	// Shapes are drawn in the world of Owner, and logged under Owner in the Visual Logger
+	static void Line(const UObject* Owner, const FVector& Start, const FVector& End, const FColor& Color, float LifeTime, float Thickness = 0.0f);
+	static void Arrow(const UObject* Owner, const FVector& Start, const FVector& End, float ArrowSize, const FColor& Color, float LifeTime, float Thickness = 0.0f);
+	static void Sphere(const UObject* Owner, const FVector& Centre, float Radius, int32 Segments, const FColor& Color, float LifeTime);
+	static void Capsule(const UObject* Owner, const FVector& Centre, float HalfHeight, float Radius, const FQuat& Rotation, const FColor& Color, float LifeTime, float Thickness = 0.0f);
+};
+
+#else
+
+class FFuseDebugDraw
+{
+public:
+	static constexpr bool IsEnabled() { return false; }
+
+	static void Line(const UObject*, const FVector&, const FVector&, const FColor&, float, float = 0.0f) {}
+	static void Arrow(const UObject*, const FVector&, const FVector&, float, const FColor&, float, float = 0.0f) {}
+	static void Sphere(const UObject*, const FVector&, float, int32, const FColor&, float) {}
+	static void Capsule(const UObject*, const FVector&, float, float, const FQuat&, const FColor&, float, float = 0.0f) {}
+};
+
+#endif
@@ -0,0 +1,163 @@
+
+#include "FuseEventJournal.h"
+#include "Containers/CircularQueue.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "Tasks/Task.h"
+
+static TAutoConsoleVariable<bool> CVarFuseJournal(
+	TEXT("f.fusejournal"), false, TEXT("Record fuse events to a CSV journal in Saved/Fuse/"));
+
+static TAutoConsoleVariable<float> CVarFuseJournalFlushInterval(
+	TEXT("f.fusejournal.flushinterval"), 5.0f, TEXT("Seconds between fuse journal writes"));
+
+static FAutoConsoleCommandWithWorld FuseJournalFlushCommand(
+	TEXT("f.fusejournalflush"),
+	TEXT("Write out every fuse event recorded in this world so far"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		FFuseEventJournal::Flush(World);
+		UE_LOG(LogTemp, Display, TEXT("Fuse journal written to %s"), *FFuseEventJournal::GetFilePath(World));
+	}));
+
+namespace FuseEventJournal
+{
+	static constexpr uint32 Capacity = 4096;
+	// The ring is drained early once it's this full, well before anything is dropped
+	static constexpr uint32 FlushThreshold = Capacity / 4;
+
+	struct FWorldJournal
+	{
+		// Produced on the game thread, consumed by one flush task at a time
+		TCircularQueue<FFuseJournalEntry> Entries{Capacity};
+		FString FilePath;
+		// Only touched by the consumer
+		TUniquePtr<IFileHandle> File;
+		UE::Tasks::FTask FlushTask;
+		double LastFlushTime = 0.0;
+		uint32 Dropped = 0;
+	};
+	static TMap<TObjectKey<UWorld>, TUniquePtr<FWorldJournal>> Journals;
+	static FDelegateHandle PostActorTickHandle;
+	static FDelegateHandle WorldCleanupHandle;
+
+	// Drain the ring into the file, runs on the flush task or on the game thread once the task is done
+	static void WriteEntries(FWorldJournal& Journal)
+	{
+		if (!Journal.File)
+		{
+			IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+			PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Journal.FilePath));
+			Journal.File.Reset(PlatformFile.OpenWrite(*Journal.FilePath, false, true));
+			if (!Journal.File) { return; }
+			const FTCHARToUTF8 Header(TEXT("Time,Fuser,Event,PreviousState,State,Duration,Candidates,SourceSocket,TargetSocket,InterpFallback,Snapped\n"));
+			Journal.File->Write(reinterpret_cast<const uint8*>(Header.Get()), Header.Length());
+		}
+
+		FString Lines;
+		FFuseJournalEntry Entry;
+		while (Journal.Entries.Dequeue(Entry))
+		{
+			Lines.Appendf(TEXT("%.4f,%u,%s,%u,%u,%.4f,%u,%d,%d,%d,%d\n"),
+			              Entry.Time, Entry.Fuser, FFuseEventJournal::GetEventName(Entry.Event), Entry.PreviousState, Entry.State,
+			              Entry.Duration, Entry.Candidates,
+			              Entry.SourceSocket == MAX_uint16 ? -1 : static_cast<int32>(Entry.SourceSocket),
+			              Entry.TargetSocket == MAX_uint16 ? -1 : static_cast<int32>(Entry.TargetSocket),
+			              (Entry.Flags & FJF_InterpFallback) ? 1 : 0, (Entry.Flags & FJF_Snapped) ? 1 : 0);
+		}
+		if (Lines.IsEmpty()) { return; }
+		const FTCHARToUTF8 Utf8Lines(*Lines);
+		Journal.File->Write(reinterpret_cast<const uint8*>(Utf8Lines.Get()), Utf8Lines.Length());
+		Journal.File->Flush();
+	}
+
+	static void StartFlush(FWorldJournal& Journal)
+	{
+		// One consumer at a time, anything recorded meanwhile goes in the next flush
+		if (!Journal.FlushTask.IsCompleted()) { return; }
+		if (Journal.Dropped > 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Fuse journal dropped %u events, the ring filled up before it could be written"), Journal.Dropped);
+			Journal.Dropped = 0;
+		}
+		Journal.LastFlushTime = FPlatformTime::Seconds();
+		FWorldJournal* JournalPtr = &Journal;
+		Journal.FlushTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [JournalPtr]() { WriteEntries(*JournalPtr); }, LowLevelTasks::ETaskPriority::BackgroundNormal);
+	}
+
+	static void FlushPeriodically(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+	{
+		const TUniquePtr<FWorldJournal>* Journal = Journals.Find(World);
+		if (Journal && (*Journal)->Entries.Count() > 0 &&
+			FPlatformTime::Seconds() - (*Journal)->LastFlushTime > CVarFuseJournalFlushInterval.GetValueOnGameThread())
+		{
+			StartFlush(**Journal);
+		}
+	}
+
+	// Write what's left and close the file when the world goes away
+	static void CloseJournal(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+	{
+		TUniquePtr<FWorldJournal> Journal;
+		if (!Journals.RemoveAndCopyValue(World, Journal)) { return; }
+		Journal->FlushTask.Wait();
+		WriteEntries(*Journal);
+	}
+}
+
+bool FFuseEventJournal::IsEnabled()
+{
+	return CVarFuseJournal.GetValueOnGameThread();
+}
+
+void FFuseEventJournal::Record(const UObject* WorldContextObject, const FFuseJournalEntry& Entry)
+{
+	check(IsInGameThread());
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if (!World) { return; }
+
+	TUniquePtr<FuseEventJournal::FWorldJournal>& Journal = FuseEventJournal::Journals.FindOrAdd(World);
+	if (!Journal)
+	{
+		if (!FuseEventJournal::PostActorTickHandle.IsValid())
+		{
+			FuseEventJournal::PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddStatic(&FuseEventJournal::FlushPeriodically);
+			FuseEventJournal::WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&FuseEventJournal::CloseJournal);
+		}
+		Journal = MakeUnique<FuseEventJournal::FWorldJournal>();
+		Journal->FilePath = FPaths::ProjectSavedDir() / TEXT("Fuse") / FString::Printf(TEXT("Journal_%s_%s.csv"), *World->GetMapName(), *FDateTime::Now().ToString());
+		Journal->LastFlushTime = FPlatformTime::Seconds();
+	}
+
+	if (!Journal->Entries.Enqueue(Entry)) { Journal->Dropped++; }
+	if (Journal->Entries.Count() >= FuseEventJournal::FlushThreshold) { FuseEventJournal::StartFlush(*Journal); }
+}
+
+void FFuseEventJournal::Flush(const UWorld* World)
+{
+	const TUniquePtr<FuseEventJournal::FWorldJournal>* Journal = FuseEventJournal::Journals.Find(World);
+	if (!Journal) { return; }
+	(*Journal)->FlushTask.Wait();
+	FuseEventJournal::WriteEntries(**Journal);
+}
+
+FString FFuseEventJournal::GetFilePath(const UWorld* World)
+{
+	const TUniquePtr<FuseEventJournal::FWorldJournal>* Journal = FuseEventJournal::Journals.Find(World);
+	return Journal ? (*Journal)->FilePath : FString();
+}
+
+const TCHAR* FFuseEventJournal::GetEventName(const EFuseJournalEvent Event)
+{
+	switch (Event)
+	{
+	case EFuseJournalEvent::StateChanged: return TEXT("StateChanged");
+	case EFuseJournalEvent::Grab: return TEXT("Grab");
+	case EFuseJournalEvent::Release: return TEXT("Release");
+	case EFuseJournalEvent::FuseStart: return TEXT("FuseStart");
+	case EFuseJournalEvent::FuseEnd: return TEXT("FuseEnd");
+	case EFuseJournalEvent::Detach: return TEXT("Detach");
+	default: return TEXT("Unknown");
+	}
+}
@@ -0,0 +1,76 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Events recorded by the journal
+enum class EFuseJournalEvent : uint8
+{
+	// Fuser state transition
+	StateChanged,
+	Grab,
+	// Duration is how long the component was held
+	Release,
+	// TryFuseObjects started the fuse interp
+	FuseStart,
+	// Duration is how long the fuse interp ran, flags say whether it fell back
+	FuseEnd,
+	Detach
+};
+
+// Fallbacks taken by a fuse, in FFuseJournalEntry::Flags
+enum EFuseJournalFlags : uint8
+{
+	FJF_None = 0,
+	// Ran past FuseInterpOperationMaxTime and finished without physics
+	FJF_InterpFallback = 1 << 0,
+	// Ran past FuseMaxTimeBeforeSnap and was snapped into place
+	FJF_Snapped = 1 << 1
+};
+
+// One journal record, fixed size so recording never allocates
+struct FFuseJournalEntry
+{
+	// World time of the event
+	double Time = 0.0;
+	float Duration = 0.0f;
+	// Unique id of the fuse component
+	uint32 Fuser = 0;
+	EFuseJournalEvent Event = EFuseJournalEvent::StateChanged;
+	uint8 PreviousState = 0;
+	uint8 State = 0;
+	uint8 Flags = FJF_None;
+	// Ranked fuse candidates at the time of the event
+	uint16 Candidates = 0;
+	// The chosen socket pair, MAX_uint16 when there isn't one
+	uint16 SourceSocket = MAX_uint16;
+	uint16 TargetSocket = MAX_uint16;
+};
+
+/*
+ *
+ * Native journal of fuse events for telemetry, so how long fuses take and how often they fall back can be measured
+ * in production like sessions without going through Blueprint events.
+ * Each world has a fixed size single producer single consumer ring that fuse components record into on the game
+ * thread. A background task drains it into a CSV file in Saved/Fuse/ every f.fusejournal.flushinterval seconds, or
+ * sooner when the ring fills up. Events are dropped rather than blocking when the ring is full.
+ * f.fusejournal 1 to record, f.fusejournalflush to write out everything recorded so far
+ *
+ */
+
+class FUSE_API FFuseEventJournal
+{
+public:
+	static bool IsEnabled();
+
+	// Record an event in the journal of the object's world, game thread only
+	static void Record(const UObject* WorldContextObject, const FFuseJournalEntry& Entry);
+
+	// Write everything recorded in a world so far, waiting until it's written
+	static void Flush(const UWorld* World);
+
+	// File a world's journal is written to, empty if nothing has been recorded in it
+	static FString GetFilePath(const UWorld* World);
+
+	static const TCHAR* GetEventName(EFuseJournalEvent Event);
+};
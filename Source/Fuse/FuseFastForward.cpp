@@ -0,0 +1,286 @@
+
+#include "FuseFastForward.h"
+#include "FuseBenchmark.h"
+#include "FFuseComponent.h"
+#include "FFuseStressWorldGenerator.h"
+#include "FuseSocketTable.h"
+#include "EngineUtils.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/CollisionProfile.h"
+#include "PhysicsEngine/PhysicsConstraintActor.h"
+#include "Misc/App.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+static FAutoConsoleCommandWithWorldAndArgs FuseFastForwardCommand(
+	TEXT("f.fusefastforward"),
+	TEXT("Run scripted fuses at a fixed step as fast as possible. Args: Trials=200 Seed=1 Step=0.0167 Settle=0.5 Sockets=8 Gap=0.75 Rotation=30 ")
+	TEXT("InterpSpeed=<speed> InterpMaxTime=<seconds> SnapTime=<seconds> Mesh=<path> Output=<file>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		FFuseFastForwardSettings Settings;
+		Settings.ParseFromString(FString::Join(Args, TEXT(" ")));
+		FFuseFastForward::Run(World, Settings);
+	}),
+	ECVF_Cheat);
+
+namespace FuseFastForward
+{
+	// Trials run far from anything in the loaded map
+	static const FVector TrialLocation(0.0f, 0.0f, 150000.0f);
+
+	static AStaticMeshActor* SpawnProp(UWorld* World, UStaticMesh* Mesh, const FVector& Location, const FRotator& Rotation)
+	{
+		AStaticMeshActor* Prop = World->SpawnActor<AStaticMeshActor>(Location, Rotation);
+		UStaticMeshComponent* Component = Prop->GetStaticMeshComponent();
+		Component->SetMobility(EComponentMobility::Movable);
+		Component->SetStaticMesh(Mesh);
+		Component->SetCollisionProfileName(UCollisionProfile::PhysicsActor_ProfileName);
+		// No gravity, so a trial measures the fuse rather than the props falling
+		Component->SetEnableGravity(false);
+		Component->SetSimulatePhysics(true);
+		return Prop;
+	}
+
+	static double Percentile(TArray<float>& Values, const double Fraction)
+	{
+		if (Values.Num() == 0) { return 0.0; }
+		Values.Sort();
+		return Values[FMath::Clamp(FMath::CeilToInt(Values.Num() * Fraction) - 1, 0, Values.Num() - 1)];
+	}
+}
+
+void FFuseFastForwardSettings::ParseFromString(const FString& Params)
+{
+	FParse::Value(*Params, TEXT("Trials="), Trials);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Step="), StepTime);
+	FParse::Value(*Params, TEXT("Settle="), SettleTime);
+	FParse::Value(*Params, TEXT("Sockets="), Sockets);
+	FParse::Value(*Params, TEXT("Gap="), MaxGap);
+	FParse::Value(*Params, TEXT("Rotation="), MaxRotation);
+	FParse::Value(*Params, TEXT("InterpSpeed="), InterpSpeed);
+	FParse::Value(*Params, TEXT("InterpMaxTime="), InterpOperationMaxTime);
+	FParse::Value(*Params, TEXT("SnapTime="), MaxTimeBeforeSnap);
+	FParse::Value(*Params, TEXT("Mesh="), MeshPath, false);
+	FParse::Value(*Params, TEXT("Output="), OutputPath, false);
+	Trials = FMath::Max(1, Trials);
+	StepTime = FMath::Clamp(StepTime, 0.001f, 0.1f);
+	SettleTime = FMath::Max(0.0f, SettleTime);
+	Sockets = FMath::Max(1, Sockets);
+	MaxGap = FMath::Max(0.0f, MaxGap);
+}
+
+TSharedRef<FJsonObject> FFuseFastForward::Run(UWorld* World, const FFuseFastForwardSettings& Settings)
+{
+	TSharedRef<FJsonObject> Results = MakeShared<FJsonObject>();
+	if (!World || !World->IsGameWorld())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Fuse fast forward requires a game world"));
+		return Results;
+	}
+	if (World->bInTick)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Fuse fast forward can't step the world from inside its tick, run it from the console or -ExecCmds"));
+		return Results;
+	}
+
+	UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, *Settings.MeshPath);
+	if (!Mesh)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Fuse fast forward failed to load mesh %s"), *Settings.MeshPath);
+		return Results;
+	}
+
+	UFFuseComponent* Fuser = FFuseBenchmark::SpawnBenchmarkFuser(World, FuseFastForward::TrialLocation);
+	if (Settings.InterpSpeed >= 0.0f) { Fuser->FuseInterpSpeed = Settings.InterpSpeed; }
+	if (Settings.InterpOperationMaxTime >= 0.0f) { Fuser->FuseInterpOperationMaxTime = Settings.InterpOperationMaxTime; }
+	if (Settings.MaxTimeBeforeSnap >= 0.0f) { Fuser->FuseMaxTimeBeforeSnap = Settings.MaxTimeBeforeSnap; }
+	AFFuseStressWorldGenerator::AddGeneratedAttachSockets(Mesh, Fuser->FusableSocketSubName, Settings.Sockets);
+
+	const double AppDeltaTime = FApp::GetDeltaTime();
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	FRandomStream Random(Settings.Seed);
+	TArray<FTrialResult> Trials;
+	Trials.Reserve(Settings.Trials);
+	for (int32 Trial = 0; Trial < Settings.Trials; Trial++)
+	{
+		Trials.Add(RunTrial(World, Fuser, Mesh, Random, Settings));
+	}
+	const double WallMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+	FApp::SetDeltaTime(AppDeltaTime);
+
+	Fuser->GetOwner()->Destroy();
+	AFFuseStressWorldGenerator::RemoveGeneratedAttachSockets(Mesh, Fuser->FusableSocketSubName);
+
+	// Summarise the fuses that were found, trials without a fuse are a placement the search didn't accept
+	int32 Found = 0;
+	int32 Completed = 0;
+	int32 InterpFallbacks = 0;
+	int32 Snaps = 0;
+	int32 TotalSteps = 0;
+	TArray<float> ConvergenceTimes;
+	TArray<float> LocationErrors;
+	TArray<float> AngleErrors;
+	TArray<TSharedPtr<FJsonValue>> TrialValues;
+	for (const FTrialResult& Trial : Trials)
+	{
+		TSharedRef<FJsonObject> TrialObject = MakeShared<FJsonObject>();
+		TrialObject->SetBoolField(TEXT("FoundFuse"), Trial.bFoundFuse);
+		TrialValues.Add(MakeShared<FJsonValueObject>(TrialObject));
+		TotalSteps += Trial.Steps;
+		if (!Trial.bFoundFuse) { continue; }
+
+		Found++;
+		InterpFallbacks += Trial.bInterpFallback ? 1 : 0;
+		Snaps += Trial.bSnapped ? 1 : 0;
+		TrialObject->SetBoolField(TEXT("Completed"), Trial.bCompleted);
+		TrialObject->SetNumberField(TEXT("ConvergenceTime"), Trial.ConvergenceTime);
+		TrialObject->SetNumberField(TEXT("OperationTime"), Trial.OperationTime);
+		TrialObject->SetBoolField(TEXT("InterpFallback"), Trial.bInterpFallback);
+		TrialObject->SetBoolField(TEXT("Snapped"), Trial.bSnapped);
+		if (!Trial.bCompleted) { continue; }
+
+		Completed++;
+		TrialObject->SetNumberField(TEXT("LocationError"), Trial.LocationError);
+		TrialObject->SetNumberField(TEXT("AngleError"), Trial.AngleError);
+		ConvergenceTimes.Add(Trial.ConvergenceTime);
+		LocationErrors.Add(Trial.LocationError);
+		AngleErrors.Add(Trial.AngleError);
+	}
+
+	const double SimulatedSeconds = TotalSteps * Settings.StepTime;
+	Results->SetStringField(TEXT("Map"), World->GetMapName());
+	Results->SetStringField(TEXT("Mesh"), Settings.MeshPath);
+	Results->SetStringField(TEXT("Timestamp"), FDateTime::UtcNow().ToIso8601());
+	Results->SetNumberField(TEXT("Seed"), Settings.Seed);
+	Results->SetNumberField(TEXT("StepTime"), Settings.StepTime);
+	Results->SetNumberField(TEXT("Sockets"), Settings.Sockets);
+	Results->SetNumberField(TEXT("FuseInterpSpeed"), Fuser->FuseInterpSpeed);
+	Results->SetNumberField(TEXT("FuseInterpOperationMaxTime"), Fuser->FuseInterpOperationMaxTime);
+	Results->SetNumberField(TEXT("FuseMaxTimeBeforeSnap"), Fuser->FuseMaxTimeBeforeSnap);
+	Results->SetNumberField(TEXT("Trials"), Trials.Num());
+	Results->SetNumberField(TEXT("FoundFuse"), Found);
+	Results->SetNumberField(TEXT("Completed"), Completed);
+	Results->SetNumberField(TEXT("InterpFallbackRate"), Found > 0 ? static_cast<double>(InterpFallbacks) / Found : 0.0);
+	Results->SetNumberField(TEXT("SnapRate"), Found > 0 ? static_cast<double>(Snaps) / Found : 0.0);
+	Results->SetNumberField(TEXT("ConvergenceTimeP50"), FuseFastForward::Percentile(ConvergenceTimes, 0.5));
+	Results->SetNumberField(TEXT("ConvergenceTimeP95"), FuseFastForward::Percentile(ConvergenceTimes, 0.95));
+	Results->SetNumberField(TEXT("ConvergenceTimeMax"), FuseFastForward::Percentile(ConvergenceTimes, 1.0));
+	Results->SetNumberField(TEXT("LocationErrorP95"), FuseFastForward::Percentile(LocationErrors, 0.95));
+	Results->SetNumberField(TEXT("LocationErrorMax"), FuseFastForward::Percentile(LocationErrors, 1.0));
+	Results->SetNumberField(TEXT("AngleErrorP95"), FuseFastForward::Percentile(AngleErrors, 0.95));
+	Results->SetNumberField(TEXT("AngleErrorMax"), FuseFastForward::Percentile(AngleErrors, 1.0));
+	Results->SetNumberField(TEXT("SimulatedSeconds"), SimulatedSeconds);
+	Results->SetNumberField(TEXT("WallMs"), WallMs);
+	Results->SetNumberField(TEXT("TrialsPerMinute"), WallMs > 0.0 ? Trials.Num() * 60000.0 / WallMs : 0.0);
+	Results->SetArrayField(TEXT("Results"), TrialValues);
+
+	UE_LOG(LogTemp, Display, TEXT("Fuse fast forward: %d trials, %d fused, %d completed in %.1fs (%.0fx real time), convergence p50 %.2fs p95 %.2fs, interp fallback %.1f%%, snap %.1f%%, socket error p95 %.2f"),
+	       Trials.Num(), Found, Completed, WallMs / 1000.0, WallMs > 0.0 ? SimulatedSeconds * 1000.0 / WallMs : 0.0,
+	       Results->GetNumberField(TEXT("ConvergenceTimeP50")), Results->GetNumberField(TEXT("ConvergenceTimeP95")),
+	       Results->GetNumberField(TEXT("InterpFallbackRate")) * 100.0, Results->GetNumberField(TEXT("SnapRate")) * 100.0,
+	       Results->GetNumberField(TEXT("LocationErrorP95")));
+
+	const FString OutputPath = Settings.OutputPath.IsEmpty()
+		? FPaths::ProjectSavedDir() / TEXT("Fuse") / FString::Printf(TEXT("FastForward_%s.json"), *FDateTime::Now().ToString())
+		: Settings.OutputPath;
+	FFuseBenchmark::WriteResults(Results, OutputPath);
+	return Results;
+}
+
+FFuseFastForward::FTrialResult FFuseFastForward::RunTrial(UWorld* World, UFFuseComponent* Fuser, UStaticMesh* Mesh,
+	FRandomStream& Random, const FFuseFastForwardSettings& Settings)
+{
+	FTrialResult Result;
+
+	// Keep track of constraints that existed before the trial, so only the ones spawned by the fuse are cleaned up
+	TSet<AActor*> ExistingConstraintActors;
+	for (TActorIterator<APhysicsConstraintActor> It(World); It; ++It) { ExistingConstraintActors.Add(*It); }
+
+	// Hold the source off a random face of the target, with a random gap, slide along the face and rotation
+	const FVector PropExtent = Mesh->GetBoundingBox().GetExtent();
+	FVector FaceAxis = FVector::ZeroVector;
+	const int32 Face = Random.RandRange(0, 5);
+	FaceAxis[Face / 2] = Face % 2 == 0 ? 1.0f : -1.0f;
+	const FVector Slide = (FVector(Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f)) * PropExtent * 0.5f)
+		* (FVector::OneVector - FaceAxis.GetAbs());
+	const float Gap = Random.FRandRange(0.0f, Settings.MaxGap) * Fuser->MaxFuseDistance;
+	const FVector SourceLocation = FuseFastForward::TrialLocation + FaceAxis * (PropExtent * 2.0f + FVector(Gap)) + Slide;
+	const FRotator SourceRotation(Random.FRandRange(-Settings.MaxRotation, Settings.MaxRotation),
+	                              Random.FRandRange(-Settings.MaxRotation, Settings.MaxRotation),
+	                              Random.FRandRange(-Settings.MaxRotation, Settings.MaxRotation));
+
+	AStaticMeshActor* TargetProp = FuseFastForward::SpawnProp(World, Mesh, FuseFastForward::TrialLocation, FRotator::ZeroRotator);
+	AStaticMeshActor* SourceProp = FuseFastForward::SpawnProp(World, Mesh, SourceLocation, SourceRotation);
+	UPrimitiveComponent* TargetComponent = TargetProp->GetStaticMeshComponent();
+	UPrimitiveComponent* SourceComponent = SourceProp->GetStaticMeshComponent();
+
+	// Grab and search the same way the fuse tick would, then fuse
+	Fuser->GrabComponentAtLocationWithRotation(SourceComponent, NAME_None, SourceLocation, SourceRotation);
+	Fuser->UpdateFuserState(FSTATE_FUSING);
+	Fuser->ClearFuseOperationData();
+	Result.bFoundFuse = Fuser->TryFindIdealFuseSockets(Fuser->LastFuseOperation, true)
+		&& Fuser->LastFuseOperation.TargetComponent.Get() == TargetComponent;
+	const FFuseSocketPair Sockets = Fuser->LastFuseOperation.IdealSockets;
+	Fuser->FuseOperationTime = 0.0f;
+
+	if (Result.bFoundFuse && Fuser->TryFuseObjects())
+	{
+		// Past the snap failsafe the fuse should always end, the extra second catches one that never converges
+		const int32 MaxSteps = FMath::CeilToInt((Fuser->FuseMaxTimeBeforeSnap + 1.0f) / Settings.StepTime);
+		while (Fuser->GetCurrentFuseState() == FSTATE_ACTIVEFUSING && Result.Steps < MaxSteps)
+		{
+			Result.OperationTime = FMath::Max(Result.OperationTime, Fuser->FuseOperationTime);
+			StepWorld(World, Settings.StepTime);
+			Result.Steps++;
+		}
+		Result.ConvergenceTime = Result.Steps * Settings.StepTime;
+		Result.bCompleted = Fuser->GetCurrentFuseState() != FSTATE_ACTIVEFUSING;
+		Result.bInterpFallback = Result.OperationTime > Fuser->FuseInterpOperationMaxTime;
+		Result.bSnapped = Result.OperationTime > Fuser->FuseMaxTimeBeforeSnap;
+		if (!Result.bCompleted)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Fuse fast forward trial didn't converge after %.1fs"), Result.ConvergenceTime);
+			Fuser->ClearFuseOperationData();
+			Fuser->UpdateFuserState(FSTATE_NONE);
+		}
+	}
+	else
+	{
+		if (Fuser->GetGrabbedComponent()) { Fuser->ReleaseComponent(); }
+		Fuser->UpdateFuserState(FSTATE_NONE);
+	}
+	Fuser->FuseOperationTime = 0.0f;
+
+	// Let the constraints hold the props for a while, then measure how far apart the fused sockets are
+	if (Result.bCompleted)
+	{
+		const int32 SettleSteps = FMath::CeilToInt(Settings.SettleTime / Settings.StepTime);
+		for (int32 Step = 0; Step < SettleSteps; Step++) { StepWorld(World, Settings.StepTime); }
+		Result.Steps += SettleSteps;
+
+		const FFuseSocketTable& SourceSockets = FFuseSocketTable::Get(SourceComponent, Fuser->FusableSocketSubName);
+		const FFuseSocketTable& TargetSockets = FFuseSocketTable::Get(TargetComponent, Fuser->FusableSocketSubName);
+		Result.LocationError = FVector::Distance(SourceSockets.GetSocketLocation(Sockets.SourceSocket, SourceComponent->GetComponentTransform()),
+		                                         TargetSockets.GetSocketLocation(Sockets.TargetSocket, TargetComponent->GetComponentTransform()));
+		const FTransform Ideal = Fuser->FindSourceFusableTargetTransform(SourceComponent, Sockets.SourceSocket, TargetComponent, Sockets.TargetSocket);
+		Result.AngleError = FMath::RadiansToDegrees(Ideal.GetRotation().AngularDistance(SourceComponent->GetComponentQuat()));
+	}
+
+	for (TActorIterator<APhysicsConstraintActor> It(World); It; ++It)
+	{
+		if (!ExistingConstraintActors.Contains(*It)) { It->Destroy(); }
+	}
+	SourceProp->Destroy();
+	TargetProp->Destroy();
+	return Result;
+}
+
+void FFuseFastForward::StepWorld(UWorld* World, const float StepTime)
+{
+	// Ticking the world directly steps timers, components and physics at the fixed step, without rendering a frame
+	FApp::SetDeltaTime(StepTime);
+	World->Tick(LEVELTICK_All, StepTime);
+}
@@ -0,0 +1,85 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+
+class UFFuseComponent;
+class UStaticMesh;
+
+// Settings for a fast forward fuse run, parsed from the f.fusefastforward console command
+struct FFuseFastForwardSettings
+{
+	// Number of scripted fuses to run
+	int32 Trials = 200;
+
+	// Seed for the placement of the held prop in each trial, the same seed runs the same trials
+	int32 Seed = 1;
+
+	// Fixed time step the fuse state machine and physics are advanced by
+	float StepTime = 1.0f / 60.0f;
+
+	// Time the fused props are simulated for after the fuse ends, before the socket error is measured
+	float SettleTime = 0.5f;
+
+	// Number of generated attach sockets on both props
+	int32 Sockets = 8;
+
+	// Largest gap between the held prop and the target, relative to the fuser's MaxFuseDistance
+	float MaxGap = 0.75f;
+
+	// Largest rotation of the held prop away from the target's in each axis, in degrees
+	float MaxRotation = 30.0f;
+
+	// Overrides for the fuse component's interp tuning, negative keeps the component default
+	float InterpSpeed = -1.0f;
+	float InterpOperationMaxTime = -1.0f;
+	float MaxTimeBeforeSnap = -1.0f;
+
+	// Mesh used for both props
+	FString MeshPath = TEXT("/Game/LevelPrototyping/Meshes/SM_Cube.SM_Cube");
+
+	// Where the JSON results are written, defaults to Saved/Fuse/
+	FString OutputPath;
+
+	void ParseFromString(const FString& Params);
+};
+
+/*
+ *
+ * Headless fixed step fuse simulation, for validating fuses and tuning the fuse interp without playing in real time.
+ * Each trial places a held prop near a target at a seeded offset and rotation, searches for its sockets and fuses it,
+ * then ticks the world at a fixed step as fast as it will go until the fuse ends. The fuse state machine, the FuseObjects
+ * interp and physics all advance with the world tick, nothing is drawn.
+ * Reports the convergence time of each fuse, how often it fell back to the non-physics interp or the snap, and the
+ * socket error once the fused props have settled, as JSON.
+ * Run with -nullrhi, eg. -ExecCmds="f.fusefastforward Trials=5000 InterpSpeed=15, quit"
+ *
+ */
+
+class FUSE_API FFuseFastForward
+{
+public:
+	// Run every trial in the given world and write the results to disk
+	static TSharedRef<FJsonObject> Run(UWorld* World, const FFuseFastForwardSettings& Settings);
+
+private:
+	struct FTrialResult
+	{
+		bool bFoundFuse = false;
+		bool bCompleted = false;
+		// Longest the fuse interp ran for, past FuseInterpOperationMaxTime it stops using physics
+		float OperationTime = 0.0f;
+		float ConvergenceTime = 0.0f;
+		int32 Steps = 0;
+		bool bInterpFallback = false;
+		bool bSnapped = false;
+		float LocationError = 0.0f;
+		float AngleError = 0.0f;
+	};
+
+	static FTrialResult RunTrial(UWorld* World, UFFuseComponent* Fuser, UStaticMesh* Mesh, FRandomStream& Random, const FFuseFastForwardSettings& Settings);
+
+	// Advance the world by one fixed step without rendering
+	static void StepWorld(UWorld* World, float StepTime);
+};
@@ -0,0 +1,108 @@
+
+#include "FuseInstancedFusables.h"
+#include "FuseActorPool.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/StaticMeshActor.h"
+
+namespace FuseInstancedFusables
+{
+	// The instanced component each promoted component came from
+	static TMap<TObjectKey<UPrimitiveComponent>, TWeakObjectPtr<UInstancedStaticMeshComponent>> PromotedFrom;
+	static FDelegateHandle WorldCleanupHandle;
+	// Instance transforms go through a matrix, so they don't come back exactly as they were added
+	static constexpr float InstanceTransformTolerance = 0.01f;
+
+	static void PurgeStalePromotions(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+	{
+		for (auto It = PromotedFrom.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().ResolveObjectPtr() || !It.Value().IsValid()) { It.RemoveCurrent(); }
+		}
+	}
+}
+
+bool FFuseInstancedFusables::IsInstanced(const UPrimitiveComponent* Component)
+{
+	return Cast<UInstancedStaticMeshComponent>(Component) != nullptr;
+}
+
+bool FFuseInstancedFusables::GetFusableTransform(const UPrimitiveComponent* Component, const int32 Instance, FTransform& OutTransform)
+{
+	if (!Component) { return false; }
+	if (const UInstancedStaticMeshComponent* Instances = Cast<UInstancedStaticMeshComponent>(Component))
+	{
+		return Instances->IsValidInstance(Instance) && Instances->GetInstanceTransform(Instance, OutTransform, true);
+	}
+	OutTransform = Component->GetComponentTransform();
+	return true;
+}
+
+int32 FFuseInstancedFusables::ResolveInstance(const UInstancedStaticMeshComponent* Instances, const int32 Instance, const FTransform& InstanceTransform)
+{
+	if (!Instances || !Instances->GetStaticMesh()) { return INDEX_NONE; }
+	FTransform Transform;
+	if (GetFusableTransform(Instances, Instance, Transform) && Transform.Equals(InstanceTransform, FuseInstancedFusables::InstanceTransformTolerance))
+	{
+		return Instance;
+	}
+
+	// Only instances whose bounds touch where the instance's bounds were can be the same instance
+	const FVector BoundsCentre = InstanceTransform.TransformPosition(Instances->GetStaticMesh()->GetBounds().Origin);
+	for (const int32 Overlapping : Instances->GetInstancesOverlappingSphere(BoundsCentre, FuseInstancedFusables::InstanceTransformTolerance, true))
+	{
+		if (GetFusableTransform(Instances, Overlapping, Transform) && Transform.Equals(InstanceTransform, FuseInstancedFusables::InstanceTransformTolerance))
+		{
+			return Overlapping;
+		}
+	}
+	return INDEX_NONE;
+}
+
+UPrimitiveComponent* FFuseInstancedFusables::Promote(UInstancedStaticMeshComponent* Instances, int32 Instance, const FTransform& InstanceTransform)
+{
+	Instance = ResolveInstance(Instances, Instance, InstanceTransform);
+	FTransform Transform;
+	if (!GetFusableTransform(Instances, Instance, Transform)) { return nullptr; }
+
+	AStaticMeshActor* Actor = Cast<AStaticMeshActor>(FFuseActorPool::Acquire(Instances->GetWorld(), AStaticMeshActor::StaticClass(), Transform));
+	if (!Actor) { return nullptr; }
+
+	UStaticMeshComponent* Component = Actor->GetStaticMeshComponent();
+	Component->SetMobility(EComponentMobility::Movable);
+	Component->SetStaticMesh(Instances->GetStaticMesh());
+	for (int32 MaterialIndex = 0; MaterialIndex < Instances->GetNumMaterials(); MaterialIndex++)
+	{
+		Component->SetMaterial(MaterialIndex, Instances->GetMaterial(MaterialIndex));
+	}
+	Component->SetCollisionProfileName(UCollisionProfile::PhysicsActor_ProfileName);
+	Instances->RemoveInstance(Instance);
+	Component->SetSimulatePhysics(true);
+
+	if (!FuseInstancedFusables::WorldCleanupHandle.IsValid())
+	{
+		FuseInstancedFusables::WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&FuseInstancedFusables::PurgeStalePromotions);
+	}
+	FuseInstancedFusables::PromotedFrom.Add(Component, Instances);
+	return Component;
+}
+
+bool FFuseInstancedFusables::Demote(UPrimitiveComponent* Component)
+{
+	TWeakObjectPtr<UInstancedStaticMeshComponent> Instances;
+	if (!FuseInstancedFusables::PromotedFrom.RemoveAndCopyValue(Component, Instances) || !Instances.IsValid()) { return false; }
+
+	Instances->AddInstance(Component->GetComponentTransform(), true);
+	FFuseActorPool::Release(Component->GetOwner());
+	return true;
+}
+
+void FFuseInstancedFusables::GetPromoted(const UWorld* World, TArray<UPrimitiveComponent*>& OutComponents)
+{
+	OutComponents.Reset();
+	for (const TPair<TObjectKey<UPrimitiveComponent>, TWeakObjectPtr<UInstancedStaticMeshComponent>>& Promoted : FuseInstancedFusables::PromotedFrom)
+	{
+		UPrimitiveComponent* Component = Promoted.Key.ResolveObjectPtr();
+		if (Component && Component->GetWorld() == World && Promoted.Value.IsValid()) { OutComponents.Add(Component); }
+	}
+}
@@ -0,0 +1,43 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UInstancedStaticMeshComponent;
+class UPrimitiveComponent;
+
+/*
+ *
+ * Fusable props stored as instances of an instanced or hierarchical instanced static mesh component.
+ * Instances are searched and fused to through the mesh socket table and the instance transform, without a component
+ * of their own. An instance is promoted to a simulated actor (from FFuseActorPool) when it's grabbed or fused to,
+ * and demoted back to an instance of the same component once it rests unfused, see UFFuseAssemblyLODSubsystem.
+ * Instanced components need a collision profile with the PhysicsBody object type to be found by fuse searches.
+ * Instances aren't replicated, so promotion is only seen by the server and standalone games.
+ *
+ */
+
+class FUSE_API FFuseInstancedFusables
+{
+public:
+	// Are a component's fusables instances rather than the component itself
+	static bool IsInstanced(const UPrimitiveComponent* Component);
+
+	// World transform of a fusable, the instance transform for instanced components
+	// Returns false for instanced components without a valid instance
+	static bool GetFusableTransform(const UPrimitiveComponent* Component, int32 Instance, FTransform& OutTransform);
+
+	// Current index of an instance found earlier at InstanceTransform, INDEX_NONE if it's gone
+	// Removing an instance renumbers the others, so an index kept past another promotion can be a different instance
+	static int32 ResolveInstance(const UInstancedStaticMeshComponent* Instances, int32 Instance, const FTransform& InstanceTransform);
+
+	// Replace an instance with a simulated actor, returns the actor's component or null if the instance isn't valid
+	// InstanceTransform is where the instance was when it was found, the instance is resolved again from it first
+	static UPrimitiveComponent* Promote(UInstancedStaticMeshComponent* Instances, int32 Instance, const FTransform& InstanceTransform);
+
+	// Turn a promoted component back into an instance of the component it came from, false if it wasn't promoted
+	static bool Demote(UPrimitiveComponent* Component);
+
+	// Promoted components in a world that could be demoted
+	static void GetPromoted(const UWorld* World, TArray<UPrimitiveComponent*>& OutComponents);
+};
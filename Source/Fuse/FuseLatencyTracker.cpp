@@ -0,0 +1,168 @@
+
+#include "FuseLatencyTracker.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<bool> CVarFuseLatencyTracking(
+	TEXT("f.fuselatencytracking"), true, TEXT("Record input to placement latency of fuse components"));
+
+static FAutoConsoleCommand FuseLatencyCommand(
+	TEXT("f.fuselatency"),
+	TEXT("Fuse latency histograms. Args: dump (default), reset, csv [file]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		FFuseLatencyTracker& Tracker = FFuseLatencyTracker::Get();
+		if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			Tracker.Reset();
+		}
+		else if (Args.Num() > 0 && Args[0] == TEXT("csv"))
+		{
+			Tracker.ExportCsv(Args.Num() > 1 ? Args[1] : FPaths::ProjectSavedDir() / TEXT("Fuse") / FString::Printf(TEXT("Latency_%s.csv"), *FDateTime::Now().ToString()));
+		}
+		else
+		{
+			Tracker.Dump();
+		}
+	}));
+
+void FFuseLatencyHistogram::Add(const double LatencyMs)
+{
+	const int32 Bucket = LatencyMs <= FirstBucketMs
+		? 0
+		: FMath::Min(NumBuckets - 1, FMath::CeilToInt32(FMath::Loge(LatencyMs / FirstBucketMs) / FMath::Loge(BucketGrowth)));
+	Buckets[Bucket]++;
+
+	MinMs = Count == 0 ? LatencyMs : FMath::Min(MinMs, LatencyMs);
+	MaxMs = Count == 0 ? LatencyMs : FMath::Max(MaxMs, LatencyMs);
+	TotalMs += LatencyMs;
+	Count++;
+}
+
+double FFuseLatencyHistogram::GetPercentileMs(const double Percentile) const
+{
+	if (Count == 0) { return 0.0; }
+
+	const uint32 TargetCount = static_cast<uint32>(FMath::Max(1, FMath::CeilToInt32(Percentile * Count)));
+	uint32 CumulativeCount = 0;
+	for (int32 Bucket = 0; Bucket < NumBuckets; Bucket++)
+	{
+		CumulativeCount += Buckets[Bucket];
+		if (CumulativeCount >= TargetCount)
+		{
+			return FMath::Clamp(GetBucketUpperBoundMs(Bucket), MinMs, MaxMs);
+		}
+	}
+	return MaxMs;
+}
+
+double FFuseLatencyHistogram::GetBucketUpperBoundMs(const int32 Bucket)
+{
+	return FirstBucketMs * FMath::Pow(BucketGrowth, static_cast<double>(Bucket));
+}
+
+FFuseLatencyTracker& FFuseLatencyTracker::Get()
+{
+	static FFuseLatencyTracker Tracker;
+	return Tracker;
+}
+
+bool FFuseLatencyTracker::IsEnabled()
+{
+	return CVarFuseLatencyTracking.GetValueOnGameThread();
+}
+
+void FFuseLatencyTracker::Record(const EFuseLatencyEvent Event, const double LatencyMs)
+{
+	Histograms[static_cast<int32>(Event)].Add(LatencyMs);
+}
+
+void FFuseLatencyTracker::Reset()
+{
+	for (FFuseLatencyHistogram& Histogram : Histograms) { Histogram.Reset(); }
+	SessionStartTime = FPlatformTime::Seconds();
+}
+
+void FFuseLatencyTracker::Dump() const
+{
+	UE_LOG(LogTemp, Display, TEXT("Fuse latency over %.1fs session:"), FPlatformTime::Seconds() - SessionStartTime);
+	for (int32 EventIndex = 0; EventIndex < static_cast<int32>(EFuseLatencyEvent::Num); EventIndex++)
+	{
+		const FFuseLatencyHistogram& Histogram = Histograms[EventIndex];
+		UE_LOG(LogTemp, Display, TEXT("  %-8s count %6u  mean %8.2fms  p50 %8.2fms  p95 %8.2fms  p99 %8.2fms  max %8.2fms"),
+		       GetEventName(static_cast<EFuseLatencyEvent>(EventIndex)), Histogram.Count, Histogram.GetMeanMs(),
+		       Histogram.GetPercentileMs(0.5), Histogram.GetPercentileMs(0.95), Histogram.GetPercentileMs(0.99), Histogram.MaxMs);
+	}
+}
+
+bool FFuseLatencyTracker::ExportCsv(const FString& FilePath) const
+{
+	constexpr int32 NumEvents = static_cast<int32>(EFuseLatencyEvent::Num);
+
+	FString Csv = TEXT("Event,Count,MeanMs,MinMs,MaxMs,P50Ms,P95Ms,P99Ms\n");
+	for (int32 EventIndex = 0; EventIndex < NumEvents; EventIndex++)
+	{
+		const FFuseLatencyHistogram& Histogram = Histograms[EventIndex];
+		Csv += FString::Printf(TEXT("%s,%u,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n"),
+		                       GetEventName(static_cast<EFuseLatencyEvent>(EventIndex)), Histogram.Count,
+		                       Histogram.GetMeanMs(), Histogram.MinMs, Histogram.MaxMs, Histogram.GetPercentileMs(0.5),
+		                       Histogram.GetPercentileMs(0.95), Histogram.GetPercentileMs(0.99));
+	}
+
+	// Full histograms, one row per bucket
+	Csv += TEXT("\nBucketUpperMs");
+	for (int32 EventIndex = 0; EventIndex < NumEvents; EventIndex++)
+	{
+		Csv += FString::Printf(TEXT(",%s"), GetEventName(static_cast<EFuseLatencyEvent>(EventIndex)));
+	}
+	Csv += TEXT("\n");
+	for (int32 Bucket = 0; Bucket < FFuseLatencyHistogram::NumBuckets; Bucket++)
+	{
+		Csv += FString::Printf(TEXT("%.3f"), FFuseLatencyHistogram::GetBucketUpperBoundMs(Bucket));
+		for (int32 EventIndex = 0; EventIndex < NumEvents; EventIndex++)
+		{
+			Csv += FString::Printf(TEXT(",%u"), Histograms[EventIndex].Buckets[Bucket]);
+		}
+		Csv += TEXT("\n");
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *FilePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to write fuse latency CSV to %s"), *FilePath);
+		return false;
+	}
+	UE_LOG(LogTemp, Display, TEXT("Fuse latency CSV written to %s"), *FilePath);
+	return true;
+}
+
+const TCHAR* FFuseLatencyTracker::GetEventName(const EFuseLatencyEvent Event)
+{
+	switch (Event)
+	{
+	case EFuseLatencyEvent::Rotate: return TEXT("Rotate");
+	case EFuseLatencyEvent::Distance: return TEXT("Distance");
+	case EFuseLatencyEvent::Height: return TEXT("Height");
+	case EFuseLatencyEvent::Fuse: return TEXT("Fuse");
+	default: return TEXT("Unknown");
+	}
+}
+
+void FFuseLatencyMarks::Mark(const EFuseLatencyEvent Event)
+{
+	double& Timestamp = Pending[static_cast<int32>(Event)];
+	if (Timestamp == 0.0 && FFuseLatencyTracker::IsEnabled())
+	{
+		Timestamp = FPlatformTime::Seconds();
+	}
+}
+
+void FFuseLatencyMarks::Resolve(const EFuseLatencyEvent Event)
+{
+	double& Timestamp = Pending[static_cast<int32>(Event)];
+	if (Timestamp > 0.0)
+	{
+		FFuseLatencyTracker::Get().Record(Event, (FPlatformTime::Seconds() - Timestamp) * 1000.0);
+		Timestamp = 0.0;
+	}
+}
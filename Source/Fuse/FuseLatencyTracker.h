@@ -0,0 +1,83 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Latencies measured by the tracker, from an input or request to the moment it takes effect
+enum class EFuseLatencyEvent : uint8
+{
+	// Adjust input to the physics handle target reflecting it
+	Rotate,
+	Distance,
+	Height,
+	// TryFuseObjects to EndFuseObjects
+	Fuse,
+	Num
+};
+
+// Log bucketed histogram of latency samples, constant memory regardless of sample count
+struct FFuseLatencyHistogram
+{
+	static constexpr int32 NumBuckets = 128;
+	// Upper bound of bucket 0 in ms, each bucket is BucketGrowth times wider than the last (~18s at the top)
+	static constexpr double FirstBucketMs = 0.1;
+	static constexpr double BucketGrowth = 1.1;
+
+	uint32 Buckets[NumBuckets] = {};
+	uint32 Count = 0;
+	double TotalMs = 0.0;
+	double MinMs = 0.0;
+	double MaxMs = 0.0;
+
+	void Add(double LatencyMs);
+	void Reset() { *this = FFuseLatencyHistogram(); }
+
+	// Percentile in 0-1, accurate to the bucket width
+	double GetPercentileMs(double Percentile) const;
+	double GetMeanMs() const { return Count > 0 ? TotalMs / Count : 0.0; }
+	static double GetBucketUpperBoundMs(int32 Bucket);
+};
+
+/*
+ *
+ * Tracks end to end latency of fuse inputs and operations, per session (since start or the last reset).
+ * Inputs are timestamped when they arrive and resolved when they take effect, the results are kept in histograms
+ * for every fuser combined. f.fuselatency [dump|reset|csv <file>]
+ *
+ */
+
+class FUSE_API FFuseLatencyTracker
+{
+public:
+	static FFuseLatencyTracker& Get();
+
+	static bool IsEnabled();
+
+	void Record(EFuseLatencyEvent Event, double LatencyMs);
+	void Reset();
+
+	const FFuseLatencyHistogram& GetHistogram(EFuseLatencyEvent Event) const { return Histograms[static_cast<int32>(Event)]; }
+
+	// Log p50/p95/p99 of every event
+	void Dump() const;
+
+	// Write a summary and the bucket counts of every event to a CSV file
+	bool ExportCsv(const FString& FilePath) const;
+
+	static const TCHAR* GetEventName(EFuseLatencyEvent Event);
+
+private:
+	FFuseLatencyHistogram Histograms[static_cast<int32>(EFuseLatencyEvent::Num)];
+	double SessionStartTime = FPlatformTime::Seconds();
+};
+
+// Pending timestamps for a single fuser, only the first input of each kind is timed until it is resolved
+struct FFuseLatencyMarks
+{
+	double Pending[static_cast<int32>(EFuseLatencyEvent::Num)] = {};
+
+	void Mark(EFuseLatencyEvent Event);
+	void Resolve(EFuseLatencyEvent Event);
+	void Clear(EFuseLatencyEvent Event) { Pending[static_cast<int32>(Event)] = 0.0; }
+	void ClearAll() { *this = FFuseLatencyMarks(); }
+};
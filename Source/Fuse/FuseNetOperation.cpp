@@ -0,0 +1,190 @@
+
+#include "FuseNetOperation.h"
+#include "FuseSocketTable.h"
+#include "Engine/NetDriver.h"
+#include "Engine/PackageMapClient.h"
+#include "Serialization/BitWriter.h"
+
+static FAutoConsoleCommand FuseNetStatsCommand(
+	TEXT("f.fusenetstats"),
+	TEXT("Log the replicated size of fuses and fuse intents on this server. Args: reset"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			FFuseNetStats::Reset();
+		}
+		else
+		{
+			FFuseNetStats::Dump();
+		}
+	}));
+
+namespace FuseNetStats
+{
+	static uint32 Fuses = 0;
+	static uint64 NetBits = 0;
+	static int32 MaxNetBits = 0;
+	static uint64 UnquantizedBits = 0;
+	static uint32 Intents = 0;
+	static uint64 IntentBits = 0;
+}
+
+namespace FuseNetOperation
+{
+	static void SerializeSocketPair(FArchive& Ar, FFuseSocketPair& Pair)
+	{
+		// Most meshes have a handful of sockets, so the packed indices are usually a byte each
+		uint32 SourceSocket = Pair.SourceSocket;
+		uint32 TargetSocket = Pair.TargetSocket;
+		Ar.SerializeIntPacked(SourceSocket);
+		Ar.SerializeIntPacked(TargetSocket);
+		Pair.SourceSocket = static_cast<uint16>(SourceSocket);
+		Pair.TargetSocket = static_cast<uint16>(TargetSocket);
+	}
+}
+
+FFuseNetOperation::FFuseNetOperation(const FFuseOperation& Operation, const uint8 InFuseId)
+	: SourceComponent(Operation.SourceComponent.Get())
+	, TargetComponent(Operation.TargetComponent.Get())
+	, FuseId(InFuseId)
+	, IdealSockets(Operation.IdealSockets)
+	, Orientation(Operation.Orientation)
+	, SupplementalPairs(Operation.SupplementalPairs)
+{
+}
+
+void FFuseNetOperation::ToOperation(FFuseOperation& OutOperation) const
+{
+	OutOperation.Reset();
+	OutOperation.SourceComponent = SourceComponent;
+	OutOperation.TargetComponent = TargetComponent;
+	OutOperation.IdealSockets = IdealSockets;
+	OutOperation.Orientation = Orientation;
+	OutOperation.SupplementalPairs = SupplementalPairs;
+}
+
+bool FFuseNetOperation::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	UObject* Source = SourceComponent;
+	UObject* Target = TargetComponent;
+	bOutSuccess = Map->SerializeObject(Ar, UPrimitiveComponent::StaticClass(), Source);
+	bOutSuccess &= Map->SerializeObject(Ar, UPrimitiveComponent::StaticClass(), Target);
+	if (Ar.IsLoading())
+	{
+		SourceComponent = Cast<UPrimitiveComponent>(Source);
+		TargetComponent = Cast<UPrimitiveComponent>(Target);
+	}
+
+	SerializePayload(Ar);
+	bOutSuccess &= !Ar.IsError();
+	return true;
+}
+
+void FFuseNetOperation::SerializePayload(FArchive& Ar)
+{
+	Ar << FuseId;
+	FuseNetOperation::SerializeSocketPair(Ar, IdealSockets);
+
+	uint32 PackedOrientation = Orientation;
+	Ar.SerializeIntPacked(PackedOrientation);
+	Orientation = static_cast<uint16>(PackedOrientation);
+
+	uint32 NumSupplementalPairs = SupplementalPairs.Num();
+	Ar.SerializeInt(NumSupplementalPairs, FFuseOperation::MaxSupplementalPairs + 1);
+	if (Ar.IsLoading())
+	{
+		SupplementalPairs.SetNum(FMath::Min<int32>(NumSupplementalPairs, FFuseOperation::MaxSupplementalPairs));
+	}
+	for (FFuseSocketPair& Pair : SupplementalPairs)
+	{
+		FuseNetOperation::SerializeSocketPair(Ar, Pair);
+	}
+}
+
+bool FFuseNetOperation::operator==(const FFuseNetOperation& Other) const
+{
+	return SourceComponent == Other.SourceComponent && TargetComponent == Other.TargetComponent && FuseId == Other.FuseId &&
+	       IdealSockets == Other.IdealSockets && Orientation == Other.Orientation && SupplementalPairs == Other.SupplementalPairs;
+}
+
+int32 FFuseNetOperation::CalcNetBits(const UNetDriver* NetDriver) const
+{
+	FBitWriter Writer(0, true);
+	FFuseNetOperation Payload = *this;
+	Payload.SerializePayload(Writer);
+	return Writer.GetNumBits() + CalcObjectBits(NetDriver, SourceComponent) + CalcObjectBits(NetDriver, TargetComponent);
+}
+
+int32 FFuseNetOperation::CalcUnquantizedBits(const UNetDriver* NetDriver, const FFuseSocketTable& SourceSockets,
+	const FFuseSocketTable& TargetSockets) const
+{
+	FBitWriter Writer(0, true);
+	auto WriteSocketName = [&Writer](const FFuseSocketTable& Sockets, const uint16 SocketIndex)
+	{
+		FString SocketName = Sockets.GetSockets().IsValidIndex(SocketIndex) ? Sockets[SocketIndex].Name.ToString() : FString();
+		Writer << SocketName;
+	};
+	WriteSocketName(SourceSockets, IdealSockets.SourceSocket);
+	WriteSocketName(TargetSockets, IdealSockets.TargetSocket);
+	for (const FFuseSocketPair& Pair : SupplementalPairs)
+	{
+		WriteSocketName(SourceSockets, Pair.SourceSocket);
+		WriteSocketName(TargetSockets, Pair.TargetSocket);
+	}
+	FTransform SourceTransform = SourceComponent ? SourceComponent->GetComponentTransform() : FTransform::Identity;
+	Writer << SourceTransform;
+	return Writer.GetNumBits() + CalcObjectBits(NetDriver, SourceComponent) + CalcObjectBits(NetDriver, TargetComponent);
+}
+
+int32 FFuseNetOperation::CalcObjectBits(const UNetDriver* NetDriver, const UObject* Object)
+{
+	// Once a client knows an object, references to it only send the GUID
+	FNetworkGUID NetGUID;
+	if (NetDriver && NetDriver->GuidCache.IsValid() && Object) { NetGUID = NetDriver->GuidCache->GetNetGUID(Object); }
+	FBitWriter Writer(0, true);
+	Writer << NetGUID;
+	return Writer.GetNumBits();
+}
+
+void FFuseNetStats::RecordFuse(const int32 NetBits, const int32 UnquantizedBits)
+{
+	FuseNetStats::Fuses++;
+	FuseNetStats::NetBits += NetBits;
+	FuseNetStats::MaxNetBits = FMath::Max(FuseNetStats::MaxNetBits, NetBits);
+	FuseNetStats::UnquantizedBits += UnquantizedBits;
+}
+
+void FFuseNetStats::RecordIntent(const int32 ParameterBits)
+{
+	FuseNetStats::Intents++;
+	FuseNetStats::IntentBits += ParameterBits;
+}
+
+void FFuseNetStats::Reset()
+{
+	FuseNetStats::Fuses = 0;
+	FuseNetStats::NetBits = 0;
+	FuseNetStats::MaxNetBits = 0;
+	FuseNetStats::UnquantizedBits = 0;
+	FuseNetStats::Intents = 0;
+	FuseNetStats::IntentBits = 0;
+}
+
+void FFuseNetStats::Dump()
+{
+	const uint32 Fuses = FuseNetStats::Fuses;
+	if (Fuses == 0)
+	{
+		UE_LOG(LogTemp, Display, TEXT("No fuses have been replicated from this server"));
+		return;
+	}
+
+	// Payload sizes only, the property and RPC headers around them are the same whatever the payload
+	UE_LOG(LogTemp, Display, TEXT("Replicated fuses: %u, %.1f bits per fuse (max %d), %.1f bits as socket names and transforms"),
+	       Fuses, static_cast<double>(FuseNetStats::NetBits) / Fuses, FuseNetStats::MaxNetBits,
+	       static_cast<double>(FuseNetStats::UnquantizedBits) / Fuses);
+	UE_LOG(LogTemp, Display, TEXT("Fuse intents: %u, %.1f per fuse, %.1f parameter bits per fuse"),
+	       FuseNetStats::Intents, static_cast<double>(FuseNetStats::Intents) / Fuses,
+	       static_cast<double>(FuseNetStats::IntentBits) / Fuses);
+}
@@ -0,0 +1,87 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FuseOperation.h"
+#include "FuseNetOperation.generated.h"
+
+class FFuseSocketTable;
+class UNetDriver;
+
+/*
+ *
+ * A completed fuse as it's replicated from the server: component references go out as net GUIDs and sockets as
+ * indices into the components' socket tables, with the snapped orientation as an index into the fuser's
+ * FFuseOrientationTable. Clients rebuild the fuse from these, rather than receiving socket names and transforms.
+ *
+ */
+
+USTRUCT()
+struct FUSE_API FFuseNetOperation
+{
+	GENERATED_BODY()
+
+	FFuseNetOperation() = default;
+	FFuseNetOperation(const FFuseOperation& Operation, uint8 InFuseId);
+
+	UPROPERTY()
+	UPrimitiveComponent* SourceComponent = nullptr;
+
+	UPROPERTY()
+	UPrimitiveComponent* TargetComponent = nullptr;
+
+	// Incremented for every fuse, so fusing the same pair of sockets again still replicates
+	uint8 FuseId = 0;
+
+	FFuseSocketPair IdealSockets;
+	uint16 Orientation = MAX_uint16;
+	TArray<FFuseSocketPair, TFixedAllocator<FFuseOperation::MaxSupplementalPairs>> SupplementalPairs;
+
+	bool IsValid() const { return SourceComponent && TargetComponent && IdealSockets.IsValid(); }
+
+	// Copy into a native operation, the distance between the sockets isn't replicated
+	void ToOperation(FFuseOperation& OutOperation) const;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FFuseNetOperation& Other) const;
+
+	// Replicated size of the fuse, with the component references as their packed net GUIDs
+	int32 CalcNetBits(const UNetDriver* NetDriver) const;
+
+	// Size of the same fuse sent as socket names and the source transform, for comparison
+	int32 CalcUnquantizedBits(const UNetDriver* NetDriver, const FFuseSocketTable& SourceSockets,
+	                          const FFuseSocketTable& TargetSockets) const;
+
+	// Size of an object reference sent as its packed net GUID
+	static int32 CalcObjectBits(const UNetDriver* NetDriver, const UObject* Object);
+
+private:
+	// Everything except the component references
+	void SerializePayload(FArchive& Ar);
+};
+
+template<>
+struct TStructOpsTypeTraits<FFuseNetOperation> : public TStructOpsTypeTraitsBase2<FFuseNetOperation>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
+
+/*
+ *
+ * Replicated size of the fuses and fuse intents received by this server. f.fusenetstats [reset]
+ *
+ */
+
+class FUSE_API FFuseNetStats
+{
+public:
+	static void RecordFuse(int32 NetBits, int32 UnquantizedBits);
+	static void RecordIntent(int32 ParameterBits);
+	static void Reset();
+	static void Dump();
+};
@@ -0,0 +1,205 @@
+
+#include "FuseNetPrediction.h"
+#include "FFuseBotComponent.h"
+#include "FFuseComponent.h"
+#include "FuseStats.h"
+#include "Engine/Engine.h"
+#include "GameFramework/PlayerController.h"
+#include "TimerManager.h"
+
+static FAutoConsoleCommand FusePredictionStatsCommand(
+	TEXT("f.fusepredictionstats"),
+	TEXT("Log the held object prediction corrections made on this client. Args: reset"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			FFusePredictionStats::Reset();
+		}
+		else
+		{
+			FFusePredictionStats::Dump();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs FuseNetTestCommand(
+	TEXT("f.fusenettest"),
+	TEXT("Drive the local player with a fuse bot under emulated lag and loss, then log prediction corrections. Args: [Seconds] [LagMs] [LossPercent]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const float Seconds = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 60.0f;
+		const int32 LagMs = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 150;
+		const int32 LossPercent = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 5;
+		FFuseNetTest::Start(World, Seconds, LagMs, LossPercent);
+	}));
+
+bool FFuseHeldInput::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint8 TypeBits = static_cast<uint8>(Type);
+	Ar.SerializeBits(&TypeBits, 2);
+	Type = static_cast<EFuseHeldInputType>(FMath::Min<uint8>(TypeBits, static_cast<uint8>(EFuseHeldInputType::Height)));
+	Ar << Sequence;
+	Ar << X;
+	if (Type == EFuseHeldInputType::Rotation) { Ar << Y; }
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+namespace FusePredictionStats
+{
+	// Only touched on the game thread
+	static double StartTime = 0.0;
+	static uint32 ServerUpdates = 0;
+	static uint32 InputCorrections = 0;
+	static uint32 OrientationCorrections = 0;
+	static double InputCorrectionTotal = 0.0;
+	static float InputCorrectionMax = 0.0f;
+	static uint32 PositionCorrections = 0;
+	static double PositionCorrectionTotal = 0.0;
+	static float PositionCorrectionMax = 0.0f;
+	static uint32 PreviewCorrections = 0;
+	static uint32 DroppedInputs = 0;
+
+	static void StartIfNeeded()
+	{
+		if (StartTime == 0.0) { StartTime = FPlatformTime::Seconds(); }
+	}
+}
+
+void FFusePredictionStats::RecordServerUpdate()
+{
+	FusePredictionStats::StartIfNeeded();
+	FusePredictionStats::ServerUpdates++;
+}
+
+void FFusePredictionStats::RecordInputCorrection(const float Magnitude, const bool bOrientationCorrected)
+{
+	FusePredictionStats::InputCorrections++;
+	if (bOrientationCorrected) { FusePredictionStats::OrientationCorrections++; }
+	FusePredictionStats::InputCorrectionTotal += Magnitude;
+	FusePredictionStats::InputCorrectionMax = FMath::Max(FusePredictionStats::InputCorrectionMax, Magnitude);
+}
+
+void FFusePredictionStats::RecordPositionCorrection(const float Magnitude)
+{
+	FusePredictionStats::PositionCorrections++;
+	FusePredictionStats::PositionCorrectionTotal += Magnitude;
+	FusePredictionStats::PositionCorrectionMax = FMath::Max(FusePredictionStats::PositionCorrectionMax, Magnitude);
+}
+
+void FFusePredictionStats::RecordPreviewCorrection()
+{
+	FusePredictionStats::PreviewCorrections++;
+}
+
+void FFusePredictionStats::RecordDroppedInput()
+{
+	FusePredictionStats::DroppedInputs++;
+	FUSE_INC_COUNTER(HeldInputsDropped, 1);
+}
+
+FFusePredictionStats::FTotals FFusePredictionStats::GetTotals()
+{
+	FTotals Totals;
+	Totals.ServerUpdates = FusePredictionStats::ServerUpdates;
+	Totals.InputCorrections = FusePredictionStats::InputCorrections;
+	Totals.PositionCorrections = FusePredictionStats::PositionCorrections;
+	Totals.PositionCorrectionMax = FusePredictionStats::PositionCorrectionMax;
+	Totals.PreviewCorrections = FusePredictionStats::PreviewCorrections;
+	Totals.DroppedInputs = FusePredictionStats::DroppedInputs;
+	return Totals;
+}
+
+void FFusePredictionStats::Reset()
+{
+	FusePredictionStats::StartTime = 0.0;
+	FusePredictionStats::ServerUpdates = 0;
+	FusePredictionStats::InputCorrections = 0;
+	FusePredictionStats::OrientationCorrections = 0;
+	FusePredictionStats::InputCorrectionTotal = 0.0;
+	FusePredictionStats::InputCorrectionMax = 0.0f;
+	FusePredictionStats::PositionCorrections = 0;
+	FusePredictionStats::PositionCorrectionTotal = 0.0;
+	FusePredictionStats::PositionCorrectionMax = 0.0f;
+	FusePredictionStats::PreviewCorrections = 0;
+	FusePredictionStats::DroppedInputs = 0;
+}
+
+void FFusePredictionStats::Dump()
+{
+	const uint32 Updates = FusePredictionStats::ServerUpdates;
+	if (Updates == 0)
+	{
+		UE_LOG(LogTemp, Display, TEXT("No held object updates have been received from the server"));
+		return;
+	}
+
+	const double Seconds = FMath::Max(FPlatformTime::Seconds() - FusePredictionStats::StartTime, UE_SMALL_NUMBER);
+	auto Mean = [](const double Total, const uint32 Count) { return Count > 0 ? Total / Count : 0.0; };
+	UE_LOG(LogTemp, Display, TEXT("Held object server updates: %u over %.1fs"), Updates, Seconds);
+	UE_LOG(LogTemp, Display, TEXT("Input corrections: %u (%.2f/s, %.1f%% of updates), mean %.1f max %.1f units, %u orientation"),
+	       FusePredictionStats::InputCorrections, FusePredictionStats::InputCorrections / Seconds,
+	       100.0 * FusePredictionStats::InputCorrections / Updates,
+	       Mean(FusePredictionStats::InputCorrectionTotal, FusePredictionStats::InputCorrections),
+	       FusePredictionStats::InputCorrectionMax, FusePredictionStats::OrientationCorrections);
+	UE_LOG(LogTemp, Display, TEXT("Position corrections: %u (%.2f/s, %.1f%% of updates), mean %.1f max %.1f units"),
+	       FusePredictionStats::PositionCorrections, FusePredictionStats::PositionCorrections / Seconds,
+	       100.0 * FusePredictionStats::PositionCorrections / Updates,
+	       Mean(FusePredictionStats::PositionCorrectionTotal, FusePredictionStats::PositionCorrections),
+	       FusePredictionStats::PositionCorrectionMax);
+	UE_LOG(LogTemp, Display, TEXT("Fuse preview corrections: %u (%.2f/s)"),
+	       FusePredictionStats::PreviewCorrections, FusePredictionStats::PreviewCorrections / Seconds);
+	if (FusePredictionStats::DroppedInputs > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Held inputs dropped past the pending limit: %u"), FusePredictionStats::DroppedInputs);
+	}
+}
+
+namespace FuseNetTest
+{
+	static TWeakObjectPtr<UFFuseBotComponent> RunningBot;
+}
+
+bool FFuseNetTest::Start(UWorld* World, const float Seconds, const int32 LagMs, const int32 LossPercent)
+{
+	APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+	if (!World || World->GetNetMode() != NM_Client || !Pawn || !Pawn->FindComponentByClass<UFFuseComponent>())
+	{
+		UE_LOG(LogTemp, Error, TEXT("The fuse net test runs on a connected client, with a local pawn that has a fuse component"));
+		return false;
+	}
+	if (IsRunning())
+	{
+		UE_LOG(LogTemp, Error, TEXT("The fuse net test is already running"));
+		return false;
+	}
+
+	// Packet simulation only exists in builds with net test enabled, so go through the commands rather than the settings
+	GEngine->Exec(World, *FString::Printf(TEXT("NetEmulation.PktLag %d"), LagMs));
+	GEngine->Exec(World, *FString::Printf(TEXT("NetEmulation.PktLoss %d"), LossPercent));
+	FFusePredictionStats::Reset();
+
+	UFFuseBotComponent* Bot = NewObject<UFFuseBotComponent>(Pawn);
+	Bot->bDriveControlRotation = true;
+	Bot->RegisterComponent();
+	FuseNetTest::RunningBot = Bot;
+	UE_LOG(LogTemp, Display, TEXT("Running the fuse net test for %.0fs with %dms lag and %d%% loss"), Seconds, LagMs, LossPercent);
+
+	FTimerHandle TimerHandle;
+	World->GetTimerManager().SetTimer(TimerHandle, FTimerDelegate::CreateWeakLambda(World, [World, LagMs, LossPercent]()
+	{
+		if (FuseNetTest::RunningBot.IsValid()) { FuseNetTest::RunningBot->DestroyComponent(); }
+		FuseNetTest::RunningBot.Reset();
+		GEngine->Exec(World, TEXT("NetEmulation.PktLag 0"));
+		GEngine->Exec(World, TEXT("NetEmulation.PktLoss 0"));
+		UE_LOG(LogTemp, Display, TEXT("Fuse net test finished with %dms lag and %d%% loss"), LagMs, LossPercent);
+		FFusePredictionStats::Dump();
+	}), Seconds, false);
+	return true;
+}
+
+bool FFuseNetTest::IsRunning()
+{
+	return FuseNetTest::RunningBot.IsValid();
+}
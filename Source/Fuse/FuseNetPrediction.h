@@ -0,0 +1,139 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FuseNetOperation.h"
+#include "FuseNetPrediction.generated.h"
+
+// Held object adjustments that a client predicts, in the order the server applies them
+enum class EFuseHeldInputType : uint8
+{
+	Distance,
+	Rotation,
+	Height
+};
+
+// A held object adjustment, kept by the client and sent with every batch until the server has applied it
+USTRUCT()
+struct FUSE_API FFuseHeldInput
+{
+	GENERATED_BODY()
+
+	FFuseHeldInput() = default;
+	FFuseHeldInput(const EFuseHeldInputType InType, const float InX, const float InY = 0.0f) : Type(InType), X(InX), Y(InY) {}
+
+	EFuseHeldInputType Type = EFuseHeldInputType::Distance;
+	// Delta for distance and height, yaw steps for rotation, which can be fractions of a step
+	float X = 0.0f;
+	// Pitch steps for rotation
+	float Y = 0.0f;
+	// Count of inputs sent before and including this one
+	uint16 Sequence = 0;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+	int32 GetNetBits() const { return 2 + 16 + (Type == EFuseHeldInputType::Rotation ? 64 : 32); }
+};
+
+template<>
+struct TStructOpsTypeTraits<FFuseHeldInput> : public TStructOpsTypeTraitsBase2<FFuseHeldInput>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/*
+ *
+ * The server's side of a held object, replicated to the client holding it so its prediction can be reconciled.
+ * The targets are the server's after every input up to InputSequence, the location is where the server has the
+ * held component, and the preview is the server's socket search result.
+ *
+ */
+
+USTRUCT()
+struct FUSE_API FFuseHeldState
+{
+	GENERATED_BODY()
+
+	// Incremented for every grab, so the first state of a new grab isn't reconciled against the last one
+	UPROPERTY()
+	uint8 GrabId = 0;
+
+	// Count of held inputs the server has applied since the grab
+	UPROPERTY()
+	uint16 InputSequence = 0;
+
+	UPROPERTY()
+	float TargetDistance = 0.0f;
+
+	UPROPERTY()
+	float TargetHeight = 0.0f;
+
+	UPROPERTY()
+	uint16 LocalOrientation = 0;
+
+	// Unsnapped rotation the orientation was snapped from, which the client's inputs are replayed on
+	UPROPERTY()
+	FQuat LocalRotation = FQuat::Identity;
+
+	UPROPERTY()
+	FVector_NetQuantize10 Location;
+
+	UPROPERTY()
+	FFuseNetOperation Preview;
+
+	// Parts of the held assembly with the grabbed part first, empty unless a whole assembly is held
+	// Only set on the grab, so the client searches from the same free sockets as the server
+	UPROPERTY()
+	TArray<UPrimitiveComponent*> AssemblyParts;
+};
+
+/*
+ *
+ * Prediction corrections made by clients on this machine. f.fusepredictionstats [reset]
+ *
+ */
+
+class FUSE_API FFusePredictionStats
+{
+public:
+	// Counts since the last reset
+	struct FTotals
+	{
+		uint32 ServerUpdates = 0;
+		uint32 InputCorrections = 0;
+		uint32 PositionCorrections = 0;
+		float PositionCorrectionMax = 0.0f;
+		uint32 PreviewCorrections = 0;
+		// Inputs sent past the pending limit, their replays are lost until the server catches up
+		uint32 DroppedInputs = 0;
+	};
+
+	static void RecordServerUpdate();
+	// Distance and height the predicted targets were off by, and whether the orientation was
+	static void RecordInputCorrection(float Magnitude, bool bOrientationCorrected);
+	static void RecordPositionCorrection(float Magnitude);
+	static void RecordPreviewCorrection();
+	static void RecordDroppedInput();
+	static FTotals GetTotals();
+	static void Reset();
+	static void Dump();
+};
+
+/*
+ *
+ * Drives the local player of a connected client with a fuse bot under emulated lag and packet loss, to measure the
+ * prediction corrections it needs. The prediction stats are reset when it starts and logged when it finishes.
+ * f.fusenettest [Seconds] [LagMs] [LossPercent] from a client connected to a local listen or dedicated server, and the
+ * Fuse.Net.Prediction automation test runs it in a listen server PIE session and checks the corrections.
+ *
+ */
+
+class FUSE_API FFuseNetTest
+{
+public:
+	// Returns false if the world isn't a client with a local pawn that has a fuse component
+	static bool Start(UWorld* World, float Seconds, int32 LagMs, int32 LossPercent);
+	static bool IsRunning();
+};
@@ -0,0 +1,185 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+
+class UPrimitiveComponent;
+
+// A pair of sockets, as indices into the socket tables of the source and target components
+struct FFuseSocketPair
+{
+	static constexpr uint16 InvalidSocket = MAX_uint16;
+
+	uint16 SourceSocket = InvalidSocket;
+	uint16 TargetSocket = InvalidSocket;
+
+	bool IsValid() const { return SourceSocket != InvalidSocket && TargetSocket != InvalidSocket; }
+
+	bool operator==(const FFuseSocketPair& Other) const { return SourceSocket == Other.SourceSocket && TargetSocket == Other.TargetSocket; }
+};
+
+/*
+ *
+ * Native fuse operation, re-evaluated every held update so it's kept small and cheap to reset.
+ * Sockets are indices into FFuseSocketTable, components are weak references and the supplemental pairs live inline.
+ * Blueprints get an FFuseOperationData view of it on demand, see UFFuseComponent::GetFuseOperationData.
+ *
+ */
+
+struct FFuseOperation
+{
+	// Only the nearest this many supplemental pairs are kept, a fuse with more touching sockets is already rigid
+	// The rest are counted in Supplemental Pairs Dropped in stat fuse
+	static constexpr int32 MaxSupplementalPairs = 16;
+
+	TWeakObjectPtr<UPrimitiveComponent> SourceComponent;
+	TWeakObjectPtr<UPrimitiveComponent> TargetComponent;
+	// Instance of the target when it's an instanced fusable, see FFuseInstancedFusables
+	// The index is resolved again from the instance's transform before it's used, other promotions renumber instances
+	int32 TargetInstance = INDEX_NONE;
+	FTransform TargetInstanceTransform;
+
+	// Distance between the ideal sockets when the operation was found
+	float DistanceBetweenSockets = 0.0f;
+
+	FFuseSocketPair IdealSockets;
+
+	// Orientation of the source socket relative to the target component, in the fuser's FFuseOrientationTable
+	uint16 Orientation = MAX_uint16;
+
+	TArray<FFuseSocketPair, TFixedAllocator<MaxSupplementalPairs>> SupplementalPairs;
+
+	bool IsValid() const { return IdealSockets.IsValid(); }
+
+	void Reset()
+	{
+		SourceComponent.Reset();
+		TargetComponent.Reset();
+		TargetInstance = INDEX_NONE;
+		TargetInstanceTransform = FTransform::Identity;
+		DistanceBetweenSockets = 0.0f;
+		IdealSockets = FFuseSocketPair();
+		Orientation = MAX_uint16;
+		SupplementalPairs.Reset();
+	}
+
+	// Returns false if the pair didn't fit
+	bool AddSupplementalPair(const FFuseSocketPair Pair)
+	{
+		if (SupplementalPairs.Num() >= MaxSupplementalPairs) { return false; }
+		SupplementalPairs.Add(Pair);
+		return true;
+	}
+};
+
+// A socket pair on a target that passed the overlap check, as a candidate for the fuse operation
+struct FFuseCandidate
+{
+	// The held part the source socket is on, the held component itself unless a whole assembly is held
+	TWeakObjectPtr<UPrimitiveComponent> SourceComponent;
+	TWeakObjectPtr<UPrimitiveComponent> TargetComponent;
+	int32 TargetInstance = INDEX_NONE;
+	// Instances don't move, so the transform found with the instance identifies it after other instances are removed
+	FTransform TargetInstanceTransform;
+	FFuseSocketPair Sockets;
+	uint16 Orientation = MAX_uint16;
+	float Distance = 0.0f;
+
+	bool IsValid() const { return Sockets.IsValid(); }
+
+	// Same source, target and sockets, the distance and orientation are re-scored
+	bool IsSameAs(const FFuseCandidate& Other) const
+	{
+		return Sockets == Other.Sockets && TargetInstance == Other.TargetInstance && TargetComponent == Other.TargetComponent
+		       && SourceComponent == Other.SourceComponent;
+	}
+};
+
+/*
+ *
+ * The nearest fuse candidates of a search, kept between searches while the same component is held.
+ * Candidates are re-scored while the held component stays close to where they were discovered, and the active
+ * candidate only changes when another is nearer by more than the hysteresis margin, so near equal candidates don't flip.
+ * A candidate picked by the player is pinned, and stays active whenever it's in the set. It's only unpinned when a new
+ * search doesn't find it, so a pick the server's older set hasn't found yet survives until the server searches again.
+ *
+ */
+
+struct FFuseCandidateSet
+{
+	static constexpr int32 MaxCandidates = 8;
+
+	// Nearest first
+	TArray<FFuseCandidate, TFixedAllocator<MaxCandidates>> Candidates;
+	int32 ActiveIndex = INDEX_NONE;
+	FFuseCandidate PinnedCandidate;
+
+	// The held component and where it was when the candidates were discovered
+	TWeakObjectPtr<UPrimitiveComponent> SourceComponent;
+	FTransform DiscoveredSourceTransform;
+
+	// Supplemental pairs of the active candidate, reused while it and its target don't change
+	FFuseCandidate SupplementalCandidate;
+	FTransform SupplementalTargetTransform;
+	TArray<FFuseSocketPair, TFixedAllocator<FFuseOperation::MaxSupplementalPairs>> SupplementalPairs;
+
+	int32 Num() const { return Candidates.Num(); }
+	const FFuseCandidate* GetActive() const { return Candidates.IsValidIndex(ActiveIndex) ? &Candidates[ActiveIndex] : nullptr; }
+
+	// Candidates further than this can't make it into the set
+	float GetThreshold(const float MaxDistance) const
+	{
+		return Candidates.Num() < MaxCandidates ? MaxDistance : Candidates.Last().Distance;
+	}
+
+	int32 Find(const FFuseCandidate& Candidate) const
+	{
+		return Candidates.IndexOfByPredicate([&Candidate](const FFuseCandidate& Other) { return Other.IsSameAs(Candidate); });
+	}
+
+	// Add in distance order, dropping the furthest if the set is full, returns false if it was too far to add
+	bool Insert(const FFuseCandidate& Candidate)
+	{
+		const int32 Index = Algo::UpperBoundBy(Candidates, Candidate.Distance, &FFuseCandidate::Distance);
+		if (Index >= MaxCandidates) { return false; }
+		if (Candidates.Num() == MaxCandidates) { Candidates.Pop(false); }
+		Candidates.Insert(Candidate, Index);
+		return true;
+	}
+
+	void Sort() { Algo::SortBy(Candidates, &FFuseCandidate::Distance); }
+
+	// Pick the active candidate after the set changed, given the one that was active before
+	// bDiscovered is set when the candidates are from a new search rather than re-scored
+	void UpdateActive(const FFuseCandidate& PreviousActive, const float HysteresisMargin, const bool bDiscovered)
+	{
+		ActiveIndex = Candidates.Num() > 0 ? 0 : INDEX_NONE;
+		if (PinnedCandidate.IsValid())
+		{
+			const int32 PinnedIndex = Find(PinnedCandidate);
+			if (PinnedIndex != INDEX_NONE)
+			{
+				ActiveIndex = PinnedIndex;
+				return;
+			}
+			if (bDiscovered) { PinnedCandidate = FFuseCandidate(); }
+		}
+		const int32 PreviousIndex = PreviousActive.IsValid() ? Find(PreviousActive) : INDEX_NONE;
+		if (PreviousIndex > 0 && Candidates[0].Distance > Candidates[PreviousIndex].Distance - HysteresisMargin)
+		{
+			ActiveIndex = PreviousIndex;
+		}
+	}
+
+	void Reset()
+	{
+		Candidates.Reset();
+		ActiveIndex = INDEX_NONE;
+		PinnedCandidate = FFuseCandidate();
+		SourceComponent.Reset();
+		SupplementalCandidate = FFuseCandidate();
+		SupplementalPairs.Reset();
+	}
+};
@@ -0,0 +1,125 @@
+
+#include "FuseOrientationTable.h"
+
+namespace FuseOrientationTable
+{
+	// Tables by multiple in thousandths of a degree, only touched on the game thread
+	static TMap<int32, TUniquePtr<FFuseOrientationTable>> Tables;
+}
+
+const FFuseOrientationTable& FFuseOrientationTable::Get(const float MultipleDegrees)
+{
+	const float ClampedMultiple = FMath::Clamp(MultipleDegrees, MinMultipleDegrees, 180.0f);
+	TUniquePtr<FFuseOrientationTable>& Table = FuseOrientationTable::Tables.FindOrAdd(FMath::RoundToInt32(ClampedMultiple * 1000.0f));
+	if (!Table.IsValid())
+	{
+		Table = TUniquePtr<FFuseOrientationTable>(new FFuseOrientationTable(ClampedMultiple));
+	}
+	return *Table;
+}
+
+FFuseOrientationTable::FFuseOrientationTable(const float MultipleDegrees)
+{
+	// Walk the Euler grid, many grid points are the same orientation (gimbal lock at +-90 pitch, 180 wraps) so only
+	// keep the ones that aren't already in the table
+	const int32 PitchSteps = FMath::FloorToInt32(90.0f / MultipleDegrees);
+	const int32 TurnSteps = FMath::FloorToInt32(180.0f / MultipleDegrees);
+	for (int32 Pitch = -PitchSteps; Pitch <= PitchSteps; Pitch++)
+	{
+		for (int32 Yaw = -TurnSteps; Yaw <= TurnSteps; Yaw++)
+		{
+			for (int32 Roll = -TurnSteps; Roll <= TurnSteps; Roll++)
+			{
+				const FQuat Orientation(FRotator(Pitch * MultipleDegrees, Yaw * MultipleDegrees, Roll * MultipleDegrees));
+				float AbsDot;
+				if (FindNearest(Orientation, AbsDot) == INDEX_NONE || AbsDot < 1.0f - KINDA_SMALL_NUMBER)
+				{
+					AddOrientation(Orientation);
+				}
+			}
+		}
+	}
+	check(Orientations.Num() < MAX_uint16);
+
+	IdentityOrientation = Snap(FQuat::Identity);
+	InverseOrientations.SetNumUninitialized(Orientations.Num());
+	for (int32 Orientation = 0; Orientation < Orientations.Num(); Orientation++)
+	{
+		InverseOrientations[Orientation] = Snap(Orientations[Orientation].Inverse());
+	}
+
+	if (Orientations.Num() <= MaxCompositionTableOrientations)
+	{
+		CompositionTable.SetNumUninitialized(Orientations.Num() * Orientations.Num());
+		for (int32 A = 0; A < Orientations.Num(); A++)
+		{
+			for (int32 B = 0; B < Orientations.Num(); B++)
+			{
+				CompositionTable[A * Orientations.Num() + B] = Snap(Orientations[A] * Orientations[B]);
+			}
+		}
+	}
+	UE_LOG(LogTemp, Verbose, TEXT("Built fuse orientation table for %.1f degrees, %d orientations"), MultipleDegrees, Orientations.Num());
+}
+
+uint16 FFuseOrientationTable::Snap(const FQuat& Rotation) const
+{
+	// A NaN rotation is nearest to nothing, its index would read past the table
+	float AbsDot;
+	const int32 Nearest = FindNearest(Rotation, AbsDot);
+	return Nearest != INDEX_NONE ? static_cast<uint16>(Nearest) : IdentityOrientation;
+}
+
+uint16 FFuseOrientationTable::Compose(const uint16 A, const uint16 B) const
+{
+	if (CompositionTable.Num() > 0) { return CompositionTable[A * Orientations.Num() + B]; }
+	return Snap(Orientations[A] * Orientations[B]);
+}
+
+int32 FFuseOrientationTable::FindNearest(const FQuat& Rotation, float& OutAbsDot) const
+{
+	// q and -q are the same orientation, so compare absolute dot products
+	const VectorRegister4Float RotationX = VectorSetFloat1(static_cast<float>(Rotation.X));
+	const VectorRegister4Float RotationY = VectorSetFloat1(static_cast<float>(Rotation.Y));
+	const VectorRegister4Float RotationZ = VectorSetFloat1(static_cast<float>(Rotation.Z));
+	const VectorRegister4Float RotationW = VectorSetFloat1(static_cast<float>(Rotation.W));
+
+	int32 NearestIndex = INDEX_NONE;
+	OutAbsDot = -1.0f;
+	alignas(16) float AbsDots[4];
+	for (int32 BaseIndex = 0; BaseIndex < X.Num(); BaseIndex += 4)
+	{
+		VectorRegister4Float Dot = VectorMultiply(VectorLoad(X.GetData() + BaseIndex), RotationX);
+		Dot = VectorMultiplyAdd(VectorLoad(Y.GetData() + BaseIndex), RotationY, Dot);
+		Dot = VectorMultiplyAdd(VectorLoad(Z.GetData() + BaseIndex), RotationZ, Dot);
+		Dot = VectorMultiplyAdd(VectorLoad(W.GetData() + BaseIndex), RotationW, Dot);
+		VectorStoreAligned(VectorAbs(Dot), AbsDots);
+
+		// Padding lanes are zero quats, so they can never beat a real orientation
+		for (int32 Lane = 0; Lane < 4; Lane++)
+		{
+			if (AbsDots[Lane] > OutAbsDot)
+			{
+				OutAbsDot = AbsDots[Lane];
+				NearestIndex = BaseIndex + Lane;
+			}
+		}
+	}
+	return NearestIndex;
+}
+
+void FFuseOrientationTable::AddOrientation(const FQuat& Orientation)
+{
+	const int32 Index = Orientations.Add(Orientation);
+	if (Index % 4 == 0)
+	{
+		X.AddZeroed(4);
+		Y.AddZeroed(4);
+		Z.AddZeroed(4);
+		W.AddZeroed(4);
+	}
+	X[Index] = static_cast<float>(Orientation.X);
+	Y[Index] = static_cast<float>(Orientation.Y);
+	Z[Index] = static_cast<float>(Orientation.Z);
+	W[Index] = static_cast<float>(Orientation.W);
+}
@@ -0,0 +1,57 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+ *
+ * Every orientation reachable by rotating in steps of a rotation multiple (24 for 90 degrees), built once per multiple.
+ * Rotations are snapped to the nearest orientation by quaternion dot product, rather than rounding each Euler angle,
+ * and orientations are referred to by uint16 index so composing two of them can be looked up.
+ *
+ */
+
+class FUSE_API FFuseOrientationTable
+{
+public:
+	// Multiples below this have too many orientations to tabulate
+	static constexpr float MinMultipleDegrees = 15.0f;
+
+	// Get the table for a rotation multiple, built on first use
+	static const FFuseOrientationTable& Get(float MultipleDegrees);
+
+	int32 Num() const { return Orientations.Num(); }
+	const FQuat& GetQuat(const uint16 Orientation) const { return Orientations[Orientation]; }
+	uint16 GetIdentity() const { return IdentityOrientation; }
+
+	// Nearest orientation to a rotation, the identity for a rotation that isn't near any, eg. NaN
+	uint16 Snap(const FQuat& Rotation) const;
+
+	// Orientation of A * B, ie. B followed by A
+	uint16 Compose(uint16 A, uint16 B) const;
+
+	uint16 Inverse(const uint16 Orientation) const { return InverseOrientations[Orientation]; }
+
+private:
+	explicit FFuseOrientationTable(float MultipleDegrees);
+
+	// Index of the orientation with the largest absolute dot product with a rotation, or INDEX_NONE if empty
+	int32 FindNearest(const FQuat& Rotation, float& OutAbsDot) const;
+
+	void AddOrientation(const FQuat& Orientation);
+
+	TArray<FQuat> Orientations;
+
+	// Orientation components for the vectorised search, padded to a multiple of 4 with zero quats
+	TArray<float> X;
+	TArray<float> Y;
+	TArray<float> Z;
+	TArray<float> W;
+
+	// Num x Num lookup of Compose, only built when it's small enough
+	static constexpr int32 MaxCompositionTableOrientations = 1024;
+	TArray<uint16> CompositionTable;
+
+	TArray<uint16> InverseOrientations;
+	uint16 IdentityOrientation = 0;
+};
@@ -0,0 +1,207 @@
+
+#include "FuseSocketTable.h"
+#include "FFusableSocketTableUserData.h"
+#include "Algo/NoneOf.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshSocket.h"
+
+namespace FuseSocketTable
+{
+	// Tables are heap allocated so references stay valid while the map grows
+	// A source has a table for each subname it's been asked for, almost always just the one
+	static TMap<TObjectKey<UObject>, TArray<TUniquePtr<FFuseSocketTable>, TInlineAllocator<1>>> Tables;
+	static FDelegateHandle WorldCleanupHandle;
+
+	// Drop tables of meshes and components that no longer exist, so the cache doesn't grow forever
+	static void PurgeStaleTables(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+	{
+		for (auto It = Tables.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().ResolveObjectPtr()) { It.RemoveCurrent(); }
+		}
+	}
+}
+
+const FFuseSocketTable& FFuseSocketTable::Get(const UPrimitiveComponent* Component, const FString& SocketSubName)
+{
+	static const FFuseSocketTable EmptyTable;
+	const UObject* SocketSource = GetSocketSource(Component);
+	if (!SocketSource) { return EmptyTable; }
+
+	if (!FuseSocketTable::WorldCleanupHandle.IsValid())
+	{
+		FuseSocketTable::WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&FuseSocketTable::PurgeStaleTables);
+	}
+
+	// Tables for other subnames are left alone, fusers using them may still hold references
+	TArray<TUniquePtr<FFuseSocketTable>, TInlineAllocator<1>>& SourceTables = FuseSocketTable::Tables.FindOrAdd(SocketSource);
+	for (const TUniquePtr<FFuseSocketTable>& Table : SourceTables)
+	{
+		if (Table->SocketSubName == SocketSubName) { return *Table; }
+	}
+	TUniquePtr<FFuseSocketTable>& Table = SourceTables.Add_GetRef(MakeUnique<FFuseSocketTable>());
+	Table->Build(Component, SocketSubName);
+	return *Table;
+}
+
+void FFuseSocketTable::Invalidate(const UObject* SocketSource)
+{
+	FuseSocketTable::Tables.Remove(SocketSource);
+}
+
+void FFuseSocketTable::BuildSockets(const UStaticMesh* StaticMesh, const FString& SocketSubName, TArray<FFuseSocket>& OutSockets)
+{
+	OutSockets.Reset();
+	const FBox LocalBounds = StaticMesh->GetBoundingBox();
+	for (const UStaticMeshSocket* Socket : StaticMesh->Sockets)
+	{
+		if (Socket && Socket->SocketName.ToString().Contains(SocketSubName))
+		{
+			FFuseSocket& FuseSocket = OutSockets.AddDefaulted_GetRef();
+			FuseSocket.Name = Socket->SocketName;
+			FuseSocket.LocalTransform = FTransform(Socket->RelativeRotation, Socket->RelativeLocation, Socket->RelativeScale);
+			FuseSocket.Normal = CalcSocketNormal(FuseSocket.LocalTransform, LocalBounds);
+			ParseSocketType(Socket->SocketName.ToString(), Socket->Tag, SocketSubName, FuseSocket);
+		}
+	}
+	TrimSockets(StaticMesh, OutSockets);
+}
+
+FSphere FFuseSocketTable::CalcSocketBounds(const TConstArrayView<FFuseSocket> Sockets)
+{
+	if (Sockets.Num() == 0) { return FSphere(ForceInit); }
+
+	FBox SocketBox(ForceInit);
+	for (const FFuseSocket& Socket : Sockets) { SocketBox += Socket.LocalTransform.GetLocation(); }
+	const FVector Centre = SocketBox.GetCenter();
+	double RadiusSquared = 0.0;
+	for (const FFuseSocket& Socket : Sockets)
+	{
+		RadiusSquared = FMath::Max(RadiusSquared, FVector::DistSquared(Centre, Socket.LocalTransform.GetLocation()));
+	}
+	return FSphere(Centre, FMath::Sqrt(RadiusSquared));
+}
+
+void FFuseSocketTable::ParseSocketType(const FString& SocketName, const FString& Tag, const FString& SocketSubName, FFuseSocket& OutSocket)
+{
+	OutSocket.TypeBits = 0;
+	OutSocket.Polarity = 0;
+
+	auto ParseWord = [&OutSocket](FString Word)
+	{
+		// A numeric suffix is just there to make socket names unique, eg. Beam-02 is a - Beam socket
+		int32 SuffixStart = Word.Len();
+		while (SuffixStart > 0 && FChar::IsDigit(Word[SuffixStart - 1])) { SuffixStart--; }
+		Word.LeftInline(SuffixStart, false);
+		if (Word.EndsWith(TEXT("+"))) { OutSocket.Polarity = 1; }
+		else if (Word.EndsWith(TEXT("-"))) { OutSocket.Polarity = -1; }
+		Word.RemoveFromEnd(TEXT("+"));
+		Word.RemoveFromEnd(TEXT("-"));
+		// Words still with digits in them aren't types either
+		if (!Word.IsEmpty() && Algo::NoneOf(Word, [](const TCHAR Character) { return FChar::IsDigit(Character); }))
+		{
+			OutSocket.TypeBits |= GetTypeBit(Word);
+		}
+	};
+
+	const int32 SubNameIndex = SocketName.Find(SocketSubName);
+	TArray<FString> Words;
+	SocketName.Mid(SubNameIndex == INDEX_NONE ? 0 : SubNameIndex + SocketSubName.Len()).ParseIntoArray(Words, TEXT("_"));
+	for (const FString& Word : Words) { ParseWord(Word); }
+	Tag.ParseIntoArrayWS(Words, TEXT(","));
+	for (const FString& Word : Words) { ParseWord(Word); }
+
+	if (OutSocket.TypeBits == 0) { OutSocket.TypeBits = MAX_uint32; }
+}
+
+uint32 FFuseSocketTable::GetTypeBit(const FString& TypeName)
+{
+	return 1u << (FCrc::StrCrc32(*TypeName.ToLower()) % 32);
+}
+
+int32 FFuseSocketTable::FindSocketIndex(const FName SocketName) const
+{
+	for (int32 Index = 0; Index < Sockets.Num(); Index++)
+	{
+		if (Sockets[Index].Name == SocketName) { return Index; }
+	}
+	return INDEX_NONE;
+}
+
+const UObject* FFuseSocketTable::GetSocketSource(const UPrimitiveComponent* Component)
+{
+	if (const UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(Component))
+	{
+		if (StaticMeshComponent->GetStaticMesh()) { return StaticMeshComponent->GetStaticMesh(); }
+	}
+	return Component;
+}
+
+FVector FFuseSocketTable::CalcSocketNormal(const FTransform& LocalTransform, const FBox& LocalBounds)
+{
+	// A rotated socket points the way it was authored, only unrotated ones have their direction guessed from the bounds
+	const FQuat Rotation = LocalTransform.GetRotation();
+	if (!Rotation.Equals(FQuat::Identity)) { return Rotation.GetForwardVector(); }
+
+	// Normalise the offset by the extent, so sockets on the face of a long thin mesh still pick that face
+	const FVector Offset = (LocalTransform.GetLocation() - LocalBounds.GetCenter()) / LocalBounds.GetExtent().ComponentMax(FVector(KINDA_SMALL_NUMBER));
+	const FVector AbsOffset = Offset.GetAbs();
+	// A socket in the middle has no nearest face, a zero normal would pass every facing check
+	if (AbsOffset.IsNearlyZero()) { return FVector::ForwardVector; }
+
+	const int32 Axis = AbsOffset.X >= AbsOffset.Y && AbsOffset.X >= AbsOffset.Z ? 0 : (AbsOffset.Y >= AbsOffset.Z ? 1 : 2);
+	FVector Normal = FVector::ZeroVector;
+	Normal[Axis] = FMath::Sign(Offset[Axis]);
+	return Normal;
+}
+
+void FFuseSocketTable::TrimSockets(const UObject* SocketSource, TArray<FFuseSocket>& InOutSockets)
+{
+	if (InOutSockets.Num() > MaxSockets)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s has %d fusable sockets, only the first %d will be used"), *SocketSource->GetName(), InOutSockets.Num(), MaxSockets);
+		InOutSockets.SetNum(MaxSockets);
+	}
+}
+
+void FFuseSocketTable::Build(const UPrimitiveComponent* Component, const FString& InSocketSubName)
+{
+	SocketSubName = InSocketSubName;
+	Sockets.Reset();
+	bBaked = false;
+
+	const UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(Component);
+	UStaticMesh* StaticMesh = StaticMeshComponent ? StaticMeshComponent->GetStaticMesh() : nullptr;
+	if (StaticMesh)
+	{
+		// Use the baked table as is when it was baked with the same subname, without reading the mesh sockets
+		const UFFusableSocketTableUserData* BakedTable = StaticMesh->GetAssetUserData<UFFusableSocketTableUserData>();
+		if (BakedTable && BakedTable->SocketSubName == SocketSubName)
+		{
+			Sockets = BakedTable->Sockets;
+			SocketBounds = FSphere(BakedTable->SocketBoundsCentre, BakedTable->SocketBoundsRadius);
+			bBaked = true;
+			return;
+		}
+		BuildSockets(StaticMesh, SocketSubName, Sockets);
+	}
+	else if (Component)
+	{
+		const FBox LocalBounds = Component->CalcBounds(FTransform::Identity).GetBox();
+		for (const FName SocketName : Component->GetAllSocketNames())
+		{
+			if (SocketName.ToString().Contains(SocketSubName))
+			{
+				FFuseSocket& FuseSocket = Sockets.AddDefaulted_GetRef();
+				FuseSocket.Name = SocketName;
+				FuseSocket.LocalTransform = Component->GetSocketTransform(SocketName, RTS_Component);
+				FuseSocket.Normal = CalcSocketNormal(FuseSocket.LocalTransform, LocalBounds);
+				ParseSocketType(SocketName.ToString(), FString(), SocketSubName, FuseSocket);
+			}
+		}
+		TrimSockets(Component, Sockets);
+	}
+
+	SocketBounds = CalcSocketBounds(Sockets);
+}
@@ -0,0 +1,113 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FuseSocketTable.generated.h"
+
+class UPrimitiveComponent;
+class UStaticMesh;
+
+// A fusable socket, relative to the component it belongs to
+USTRUCT()
+struct FFuseSocket
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "Fuse")
+	FName Name;
+
+	UPROPERTY(VisibleAnywhere, Category = "Fuse")
+	FTransform LocalTransform;
+
+	// Outward direction of the socket, its X axis, or for unrotated sockets the axis of the bounds face it's nearest to
+	UPROPERTY(VisibleAnywhere, Category = "Fuse")
+	FVector Normal = FVector::ForwardVector;
+
+	// Sockets can only fuse with sockets sharing at least one type bit, untyped sockets have every bit
+	UPROPERTY(VisibleAnywhere, Category = "Fuse")
+	uint32 TypeBits = MAX_uint32;
+
+	// Sockets with the same polarity can't fuse, a + socket fuses with - and neutral (0) sockets
+	UPROPERTY(VisibleAnywhere, Category = "Fuse")
+	int8 Polarity = 0;
+
+	// Do the types and polarities of two sockets let them fuse
+	bool IsCompatibleWith(const FFuseSocket& Other) const
+	{
+		return (TypeBits & Other.TypeBits) != 0 && Polarity * Other.Polarity <= 0;
+	}
+};
+
+/*
+ *
+ * The fusable sockets of a mesh, filtered by socket subname once and cached for each subname.
+ * Tables are shared by every component using the same static mesh (other primitives get their own), so the fuse hot
+ * path can walk sockets by index without building socket name arrays or strings.
+ * Meshes with a baked UFFusableSocketTableUserData are used directly, without reading their sockets at all.
+ * Anything that changes mesh sockets at runtime must call Invalidate.
+ * Socket types come from the words after the subname, eg. Attach_Beam_Pipe+ or Attach_Beam-02, and from the socket
+ * tag of static mesh sockets. A numeric suffix is dropped first, then a trailing + or - sets the polarity, and words
+ * that still have digits in them are ignored. Attach_Beam-02 is a Beam socket with - polarity.
+ *
+ */
+
+class FUSE_API FFuseSocketTable
+{
+public:
+	// Sockets are referenced by uint16 index, the top value is reserved as invalid
+	static constexpr int32 MaxSockets = MAX_uint16;
+
+	// Get the fusable sockets of a component with a subname, built on first use
+	// The returned table stays valid until it is invalidated, whatever other subnames are asked for
+	static const FFuseSocketTable& Get(const UPrimitiveComponent* Component, const FString& SocketSubName);
+
+	// Drop the cached tables for a mesh or component, so they're rebuilt on next use
+	static void Invalidate(const UObject* SocketSource);
+
+	// Read the fusable sockets of a mesh, used by the bake and for meshes that haven't been baked
+	static void BuildSockets(const UStaticMesh* StaticMesh, const FString& SocketSubName, TArray<FFuseSocket>& OutSockets);
+
+	// Sphere around every socket location, relative to the component
+	static FSphere CalcSocketBounds(TConstArrayView<FFuseSocket> Sockets);
+
+	// Set the type bits and polarity of a socket from its name and tag
+	static void ParseSocketType(const FString& SocketName, const FString& Tag, const FString& SocketSubName, FFuseSocket& OutSocket);
+
+	// Type bit of a socket type name, the same in every build so baked tables stay valid
+	// Types can share a bit, which only makes them compatible when they wouldn't otherwise be
+	static uint32 GetTypeBit(const FString& TypeName);
+
+	int32 Num() const { return Sockets.Num(); }
+	bool IsEmpty() const { return Sockets.Num() == 0; }
+	const FFuseSocket& operator[](const int32 Index) const { return Sockets[Index]; }
+	TConstArrayView<FFuseSocket> GetSockets() const { return Sockets; }
+	const FSphere& GetSocketBounds() const { return SocketBounds; }
+	bool IsBaked() const { return bBaked; }
+
+	// Index of a socket by name, or INDEX_NONE
+	int32 FindSocketIndex(FName SocketName) const;
+
+	// World location of a socket on a component using this table
+	FVector GetSocketLocation(const int32 Index, const FTransform& ComponentTransform) const
+	{
+		return ComponentTransform.TransformPosition(Sockets[Index].LocalTransform.GetLocation());
+	}
+
+private:
+	// The object that owns the sockets of a component, the static mesh for static mesh components
+	static const UObject* GetSocketSource(const UPrimitiveComponent* Component);
+
+	// X axis of a rotated socket, or the outward axis of the nearest bounds face to an unrotated one
+	static FVector CalcSocketNormal(const FTransform& LocalTransform, const FBox& LocalBounds);
+
+	// Fuse operations store sockets as 16 bit indices, so drop any past MaxSockets
+	static void TrimSockets(const UObject* SocketSource, TArray<FFuseSocket>& InOutSockets);
+
+	void Build(const UPrimitiveComponent* Component, const FString& InSocketSubName);
+
+	// Copied from the baked user data when there is one, so the table doesn't depend on the user data outliving it
+	TArray<FFuseSocket> Sockets;
+	FSphere SocketBounds = FSphere(ForceInit);
+	FString SocketSubName;
+	bool bBaked = false;
+};
@@ -0,0 +1,36 @@
+
+#include "FuseStats.h"
+
+DEFINE_STAT(STAT_Fuse_FuseTick);
+DEFINE_STAT(STAT_Fuse_SearchForFusable);
+DEFINE_STAT(STAT_Fuse_UpdateHeldFusable);
+DEFINE_STAT(STAT_Fuse_TryFindIdealFuseSockets);
+DEFINE_STAT(STAT_Fuse_FindSupplementalSockets);
+DEFINE_STAT(STAT_Fuse_FuseObjects);
+DEFINE_STAT(STAT_Fuse_OrthoCapture);
+DEFINE_STAT(STAT_Fuse_PrefetchTargetedFusable);
+DEFINE_STAT(STAT_Fuse_StreamAssemblies);
+
+DEFINE_STAT(STAT_Fuse_NeighboursFound);
+DEFINE_STAT(STAT_Fuse_SocketPairsScored);
+DEFINE_STAT(STAT_Fuse_SocketPairsPruned);
+DEFINE_STAT(STAT_Fuse_OverlapQueries);
+DEFINE_STAT(STAT_Fuse_ConstraintsSpawned);
+DEFINE_STAT(STAT_Fuse_CapturesRendered);
+DEFINE_STAT(STAT_Fuse_PrefetchHits);
+DEFINE_STAT(STAT_Fuse_CandidateSwitches);
+DEFINE_STAT(STAT_Fuse_HeldInputsDropped);
+DEFINE_STAT(STAT_Fuse_SupplementalPairsDropped);
+
+DEFINE_STAT(STAT_Fuse_FrozenBodiesRemoved);
+DEFINE_STAT(STAT_Fuse_FrozenJointsRemoved);
+DEFINE_STAT(STAT_Fuse_StreamedOutParts);
+DEFINE_STAT(STAT_Fuse_StreamedOutBytes);
+
+CSV_DEFINE_CATEGORY_MODULE(FUSE_API, Fuse, true);
+
+#if FUSE_WORK_COUNTER
+uint64 FFuseWorkCounters::Counts[static_cast<int32>(EFuseCounter::Num)] = {};
+#endif
+
+UE_TRACE_CHANNEL_DEFINE(FuseChannel);
@@ -0,0 +1,114 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+/*
+ * Profiling hooks for the fuse pipeline
+ * Each stage is exposed to "stat fuse", the CSV profiler (category "Fuse") and Unreal Insights (channel "Fuse").
+ * Use FUSE_SCOPE_CYCLE_COUNTER / FUSE_INC_COUNTER instead of the individual macros so all three stay in sync
+ */
+
+DECLARE_STATS_GROUP(TEXT("Fuse"), STATGROUP_Fuse, STATCAT_Advanced);
+
+// Stage timings
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Fuse Tick"), STAT_Fuse_FuseTick, STATGROUP_Fuse, FUSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Search For Fusable"), STAT_Fuse_SearchForFusable, STATGROUP_Fuse, FUSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Held Fusable"), STAT_Fuse_UpdateHeldFusable, STATGROUP_Fuse, FUSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Try Find Ideal Fuse Sockets"), STAT_Fuse_TryFindIdealFuseSockets, STATGROUP_Fuse, FUSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Find Supplemental Sockets"), STAT_Fuse_FindSupplementalSockets, STATGROUP_Fuse, FUSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Fuse Objects"), STAT_Fuse_FuseObjects, STATGROUP_Fuse, FUSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ortho Capture"), STAT_Fuse_OrthoCapture, STATGROUP_Fuse, FUSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Prefetch Targeted Fusable"), STAT_Fuse_PrefetchTargetedFusable, STATGROUP_Fuse, FUSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Stream Assemblies"), STAT_Fuse_StreamAssemblies, STATGROUP_Fuse, FUSE_API);
+
+// Per frame counters
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Neighbours Found"), STAT_Fuse_NeighboursFound, STATGROUP_Fuse, FUSE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Socket Pairs Scored"), STAT_Fuse_SocketPairsScored, STATGROUP_Fuse, FUSE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Socket Pairs Pruned"), STAT_Fuse_SocketPairsPruned, STATGROUP_Fuse, FUSE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Overlap Queries"), STAT_Fuse_OverlapQueries, STATGROUP_Fuse, FUSE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Constraints Spawned"), STAT_Fuse_ConstraintsSpawned, STATGROUP_Fuse, FUSE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Captures Rendered"), STAT_Fuse_CapturesRendered, STATGROUP_Fuse, FUSE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Prefetch Hits"), STAT_Fuse_PrefetchHits, STATGROUP_Fuse, FUSE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Candidate Switches"), STAT_Fuse_CandidateSwitches, STATGROUP_Fuse, FUSE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Held Inputs Dropped"), STAT_Fuse_HeldInputsDropped, STATGROUP_Fuse, FUSE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Supplemental Pairs Dropped"), STAT_Fuse_SupplementalPairsDropped, STATGROUP_Fuse, FUSE_API);
+
+// Current totals
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Frozen Bodies Removed"), STAT_Fuse_FrozenBodiesRemoved, STATGROUP_Fuse, FUSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Frozen Joints Removed"), STAT_Fuse_FrozenJointsRemoved, STATGROUP_Fuse, FUSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Streamed Out Parts"), STAT_Fuse_StreamedOutParts, STATGROUP_Fuse, FUSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Streamed Out Bytes"), STAT_Fuse_StreamedOutBytes, STATGROUP_Fuse, FUSE_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(FUSE_API, Fuse);
+
+// Work counting is a development tool, it's compiled out of shipping builds
+#define FUSE_WORK_COUNTER !UE_BUILD_SHIPPING
+
+// The per frame counters, FUSE_INC_COUNTER needs an entry here for each one
+enum class EFuseCounter : uint8
+{
+	NeighboursFound,
+	SocketPairsScored,
+	SocketPairsPruned,
+	OverlapQueries,
+	ConstraintsSpawned,
+	CapturesRendered,
+	PrefetchHits,
+	CandidateSwitches,
+	HeldInputsDropped,
+	SupplementalPairsDropped,
+	Num
+};
+
+#if FUSE_WORK_COUNTER
+
+// Running totals of the per frame counters, whatever the stats system is doing. Unlike timings they're the same on
+// any machine for the same scene, so the benchmark gate can baseline them. Only counted on the game thread
+class FUSE_API FFuseWorkCounters
+{
+public:
+	static void Add(const EFuseCounter Counter, const uint64 Amount) { Counts[static_cast<int32>(Counter)] += Amount; }
+	static uint64 Get(const EFuseCounter Counter) { return Counts[static_cast<int32>(Counter)]; }
+
+private:
+	static uint64 Counts[static_cast<int32>(EFuseCounter::Num)];
+};
+
+#define FUSE_COUNT_WORK(Counter, Amount) FFuseWorkCounters::Add(EFuseCounter::Counter, Amount)
+
+#else
+
+#define FUSE_COUNT_WORK(Counter, Amount)
+
+#endif
+
+UE_TRACE_CHANNEL_EXTERN(FuseChannel, FUSE_API);
+
+// Time a fuse stage, eg. FUSE_SCOPE_CYCLE_COUNTER(SearchForFusable) for STAT_Fuse_SearchForFusable
+// It declares the scoped timers, so it can't be one statement, put it at the top of a braced scope
+#define FUSE_SCOPE_CYCLE_COUNTER(Stage) \
+	SCOPE_CYCLE_COUNTER(STAT_Fuse_##Stage); \
+	CSV_SCOPED_TIMING_STAT(Fuse, Stage); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Fuse_##Stage, FuseChannel)
+
+// Add to a fuse counter, eg. FUSE_INC_COUNTER(OverlapQueries, 1) for STAT_Fuse_OverlapQueries
+#define FUSE_INC_COUNTER(Counter, Amount) \
+	do \
+	{ \
+		INC_DWORD_STAT_BY(STAT_Fuse_##Counter, Amount); \
+		CSV_CUSTOM_STAT(Fuse, Counter, static_cast<int32>(Amount), ECsvCustomStatOp::Accumulate); \
+		FUSE_COUNT_WORK(Counter, Amount); \
+	} while (0)
+
+// Set a fuse total, eg. FUSE_SET_COUNTER(FrozenBodiesRemoved, Bodies) for STAT_Fuse_FrozenBodiesRemoved
+#define FUSE_SET_COUNTER(Counter, Value) \
+	do \
+	{ \
+		SET_DWORD_STAT(STAT_Fuse_##Counter, Value); \
+		CSV_CUSTOM_STAT(Fuse, Counter, static_cast<int32>(Value), ECsvCustomStatOp::Set); \
+	} while (0)
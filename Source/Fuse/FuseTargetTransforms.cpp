@@ -0,0 +1,56 @@
+
+#include "FuseTargetTransforms.h"
+#include "FuseOrientationTable.h"
+
+void FFuseTargetTransforms::Compute(const FTransform& SourceTransform, const TConstArrayView<FFuseSocket> SourceSockets,
+	const FTransform& TargetTransform, const TConstArrayView<FFuseSocket> TargetSockets,
+	const TConstArrayView<FFuseSocketPair> Pairs, const FFuseOrientationTable& Orientations,
+	TArrayView<FTransform> OutTransforms, TArrayView<uint16> OutOrientations)
+{
+	check(OutTransforms.Num() >= Pairs.Num());
+	check(OutOrientations.Num() == 0 || OutOrientations.Num() >= Pairs.Num());
+
+	// Everything that only depends on the components is taken out of the loop
+	const FQuat SourceRotation = SourceTransform.GetRotation();
+	const FVector SourceScale = SourceTransform.GetScale3D();
+	const FQuat TargetRotation = TargetTransform.GetRotation();
+	const FQuat InverseTargetRotation = TargetRotation.Inverse();
+	const bool bWriteOrientations = OutOrientations.Num() > 0;
+
+	for (int32 PairIndex = 0; PairIndex < Pairs.Num(); PairIndex++)
+	{
+		const FTransform& SourceSocketTransform = SourceSockets[Pairs[PairIndex].SourceSocket].LocalTransform;
+		const FVector& TargetSocketLocation = TargetSockets[Pairs[PairIndex].TargetSocket].LocalTransform.GetLocation();
+
+		// Snap the world socket rotation relative to the target
+		const uint16 Orientation = Orientations.Snap(InverseTargetRotation * (SourceRotation * SourceSocketTransform.GetRotation()));
+		const FQuat SnappedRotation = TargetRotation * Orientations.GetQuat(Orientation);
+
+		// Offset from the target socket back to where the source component origin would be, at the snapped rotation
+		const FVector SourceOffset = SnappedRotation.RotateVector(SourceScale * SourceSocketTransform.GetLocation());
+		OutTransforms[PairIndex] = FTransform(SnappedRotation, TargetTransform.TransformPosition(TargetSocketLocation) - SourceOffset);
+		if (bWriteOrientations) { OutOrientations[PairIndex] = Orientation; }
+	}
+}
+
+FTransform FFuseTargetTransforms::Compute(const FTransform& SourceTransform, const FFuseSocket& SourceSocket,
+	const FTransform& TargetTransform, const FFuseSocket& TargetSocket, const FFuseOrientationTable& Orientations,
+	uint16* OutOrientation)
+{
+	const FFuseSocketPair Pair = {0, 0};
+	FTransform Transform;
+	uint16 Orientation;
+	Compute(SourceTransform, MakeArrayView(&SourceSocket, 1), TargetTransform, MakeArrayView(&TargetSocket, 1),
+	        MakeArrayView(&Pair, 1), Orientations, MakeArrayView(&Transform, 1), MakeArrayView(&Orientation, 1));
+	if (OutOrientation) { *OutOrientation = Orientation; }
+	return Transform;
+}
+
+FTransform FFuseTargetTransforms::ComputeForOrientation(const FVector& SourceScale, const FFuseSocket& SourceSocket,
+	const FTransform& TargetTransform, const FFuseSocket& TargetSocket, const FFuseOrientationTable& Orientations,
+	const uint16 Orientation)
+{
+	const FQuat SnappedRotation = TargetTransform.GetRotation() * Orientations.GetQuat(Orientation);
+	const FVector SourceOffset = SnappedRotation.RotateVector(SourceScale * SourceSocket.LocalTransform.GetLocation());
+	return FTransform(SnappedRotation, TargetTransform.TransformPosition(TargetSocket.LocalTransform.GetLocation()) - SourceOffset);
+}
@@ -0,0 +1,38 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FuseOperation.h"
+#include "FuseSocketTable.h"
+
+class FFuseOrientationTable;
+
+/*
+ *
+ * Finds where a source component would need to be for a pair of its sockets to be joined to a target's, with the
+ * source socket rotation snapped to the nearest reachable orientation relative to the target.
+ * Pure math over component transforms and local socket transforms, so a whole batch of candidate pairs is solved
+ * in one loop without going through the scene component transform getters.
+ *
+ */
+
+class FUSE_API FFuseTargetTransforms
+{
+public:
+	// Solve every pair, the output views must be at least as long as Pairs
+	// OutOrientations gets the snapped orientation of the source socket relative to the target, and can be empty
+	static void Compute(const FTransform& SourceTransform, TConstArrayView<FFuseSocket> SourceSockets,
+	                    const FTransform& TargetTransform, TConstArrayView<FFuseSocket> TargetSockets,
+	                    TConstArrayView<FFuseSocketPair> Pairs, const FFuseOrientationTable& Orientations,
+	                    TArrayView<FTransform> OutTransforms, TArrayView<uint16> OutOrientations = TArrayView<uint16>());
+
+	// Solve a single pair
+	static FTransform Compute(const FTransform& SourceTransform, const FFuseSocket& SourceSocket,
+	                          const FTransform& TargetTransform, const FFuseSocket& TargetSocket,
+	                          const FFuseOrientationTable& Orientations, uint16* OutOrientation = nullptr);
+
+	// Where the source goes for an orientation that has already been snapped, eg. one replicated from the server
+	static FTransform ComputeForOrientation(const FVector& SourceScale, const FFuseSocket& SourceSocket,
+	                                        const FTransform& TargetTransform, const FFuseSocket& TargetSocket,
+	                                        const FFuseOrientationTable& Orientations, uint16 Orientation);
+};
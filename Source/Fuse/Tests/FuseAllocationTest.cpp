@@ -0,0 +1,32 @@
+
+#include "FuseAllocationCounter.h"
+#include "FuseBenchmark.h"
+#include "FuseTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && FUSE_ALLOCATION_COUNTER
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFuseSearchAllocationTest, "Fuse.Performance.SearchAllocations",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFuseSearchAllocationTest::RunTest(const FString& Parameters)
+{
+	// One benchmark case is a held prop over a grid of fusables, searched again and again without moving
+	const FFuseTestWorld TestWorld;
+	FFuseBenchmarkSettings Settings;
+	Settings.GridSizes = {4};
+	Settings.SocketCounts = {16};
+	Settings.Iterations = 20;
+	Settings.OutputPath = FPaths::AutomationDir() / TEXT("FuseSearchAllocations.json");
+	const TSharedRef<FJsonObject> Results = FFuseBenchmark::Run(TestWorld.Get(), Settings);
+
+	const TArray<TSharedPtr<FJsonValue>>* Cases = nullptr;
+	if (!TestTrue(TEXT("Benchmark ran a case"), Results->TryGetArrayField(TEXT("Cases"), Cases) && Cases->Num() == 1)) { return false; }
+	const TSharedPtr<FJsonObject> Case = (*Cases)[0]->AsObject();
+	TestTrue(TEXT("Search found a fuse"), Case->GetBoolField(TEXT("FoundFuse")));
+	TestEqual(TEXT("Allocations made by searches after the first"), static_cast<int64>(Case->GetNumberField(TEXT("SearchAllocations"))), 0ll);
+	return true;
+}
+
+#endif
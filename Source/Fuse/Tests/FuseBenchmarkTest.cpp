@@ -0,0 +1,52 @@
+
+#include "FuseBenchmark.h"
+#include "FuseTestWorld.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FFuseBenchmarkTest, "Fuse.Performance.Benchmark",
+                                  EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+void FFuseBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	// Each scale is its own test, so a regression shows which grid size and socket count it started at
+	for (const int32 GridSize : {2, 4, 8})
+	{
+		for (const int32 SocketCount : {4, 16})
+		{
+			OutBeautifiedNames.Add(FString::Printf(TEXT("Grid%d Sockets%d"), GridSize, SocketCount));
+			OutTestCommands.Add(FString::Printf(TEXT("Grid=%d Sockets=%d"), GridSize, SocketCount));
+		}
+	}
+}
+
+bool FFuseBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const FFuseTestWorld TestWorld;
+	FFuseBenchmarkSettings Settings;
+	Settings.ParseFromString(Parameters);
+	Settings.Iterations = 10;
+	Settings.OutputPath = FPaths::AutomationDir() / FString::Printf(TEXT("FuseBenchmark_%s.json"), *Parameters.Replace(TEXT(" "), TEXT("_")).Replace(TEXT("="), TEXT("")));
+	const TSharedRef<FJsonObject> Results = FFuseBenchmark::Run(TestWorld.Get(), Settings);
+	TestTrue(TEXT("Results were written"), IFileManager::Get().FileExists(*Settings.OutputPath));
+
+	const TArray<TSharedPtr<FJsonValue>>* Cases = nullptr;
+	if (!TestTrue(TEXT("Benchmark ran a case"), Results->TryGetArrayField(TEXT("Cases"), Cases) && Cases->Num() == 1)) { return false; }
+	const TSharedPtr<FJsonObject> Case = (*Cases)[0]->AsObject();
+	TestTrue(TEXT("Search found a fuse"), Case->GetBoolField(TEXT("FoundFuse")));
+	TestTrue(TEXT("Fuse completed before the snap failsafe"), Case->GetBoolField(TEXT("FuseCompleted")));
+	// Same limits as the warning in FFuseBenchmark::RunCase
+	TestTrue(TEXT("Batched target transforms match in location"), Case->GetNumberField(TEXT("TargetTransformMaxLocationError")) <= 0.01);
+	TestTrue(TEXT("Batched target transforms match in rotation"), Case->GetNumberField(TEXT("TargetTransformMaxAngleError")) <= 0.001);
+
+	// Timings depend on the machine, they're reported for the automation results rather than gated
+	AddInfo(FString::Printf(TEXT("Search %.4fms avg, %.4fms max, fuse %.4fms over %d steps"),
+	                        Case->GetNumberField(TEXT("SearchAvgMs")), Case->GetNumberField(TEXT("SearchMaxMs")),
+	                        Case->GetNumberField(TEXT("FuseTotalMs")), static_cast<int32>(Case->GetNumberField(TEXT("FuseSteps")))));
+	return true;
+}
+
+#endif
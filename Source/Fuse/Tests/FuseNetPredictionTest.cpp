@@ -0,0 +1,99 @@
+
+#include "FuseNetPrediction.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Editor.h"
+#include "FFuseComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Settings/LevelEditorPlaySettings.h"
+#include "Tests/AutomationCommon.h"
+
+namespace FuseNetPredictionTest
+{
+	static const TCHAR* MapName = TEXT("/Game/Fuse/L_Fuse_TestMap");
+	static constexpr float TestSeconds = 30.0f;
+	static constexpr int32 LagMs = 150;
+	static constexpr int32 LossPercent = 5;
+	// Longest to wait for the session to start, and past the end of the net test for it to finish
+	static constexpr double Timeout = 30.0;
+
+	// The test fails past these, the rates are per held update received from the server
+	static constexpr uint32 MinServerUpdates = 100;
+	static constexpr double MaxInputCorrectionRate = 0.05;
+	static constexpr double MaxPositionCorrectionRate = 0.25;
+	static constexpr double MaxPreviewCorrectionsPerSecond = 0.5;
+
+	// The PIE client's world, once its local pawn with a fuse component has arrived
+	static UWorld* FindReadyClientWorld()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* World = Context.World();
+			if (Context.WorldType != EWorldType::PIE || !World || World->GetNetMode() != NM_Client) { continue; }
+			const APlayerController* PlayerController = World->GetFirstPlayerController();
+			const APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+			return Pawn && Pawn->FindComponentByClass<UFFuseComponent>() ? World : nullptr;
+		}
+		return nullptr;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFuseNetPredictionTest, "Fuse.Net.Prediction",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FFuseNetPredictionTest::RunTest(const FString& Parameters)
+{
+	using namespace FuseNetPredictionTest;
+	if (!TestTrue(TEXT("Opened the fuse test map"), AutomationOpenMap(MapName))) { return false; }
+
+	// A listen server and one client in this process, the client is the one that predicts
+	ULevelEditorPlaySettings* PlaySettings = NewObject<ULevelEditorPlaySettings>();
+	PlaySettings->SetPlayNetMode(PIE_ListenServer);
+	PlaySettings->SetPlayNumberOfClients(2);
+	PlaySettings->SetRunUnderOneProcess(true);
+	FRequestPlaySessionParams Params;
+	Params.WorldType = EPlaySessionWorldType::PlayInEditor;
+	Params.EditorPlaySettings = PlaySettings;
+	GEditor->RequestPlaySession(Params);
+
+	TSharedRef<double> StageStartTime = MakeShared<double>(FPlatformTime::Seconds());
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, StageStartTime]()
+	{
+		if (UWorld* ClientWorld = FindReadyClientWorld())
+		{
+			TestTrue(TEXT("Started the net test"), FFuseNetTest::Start(ClientWorld, TestSeconds, LagMs, LossPercent));
+			*StageStartTime = FPlatformTime::Seconds();
+			return true;
+		}
+		if (FPlatformTime::Seconds() - *StageStartTime < Timeout) { return false; }
+		AddError(TEXT("The PIE client never had a local pawn with a fuse component"));
+		return true;
+	}));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, StageStartTime]()
+	{
+		if (FFuseNetTest::IsRunning() && FPlatformTime::Seconds() - *StageStartTime < TestSeconds + Timeout) { return false; }
+		TestFalse(TEXT("Net test finished in time"), FFuseNetTest::IsRunning());
+
+		const FFusePredictionStats::FTotals Totals = FFusePredictionStats::GetTotals();
+		const double Updates = FMath::Max<uint32>(Totals.ServerUpdates, 1);
+		TestTrue(FString::Printf(TEXT("Held updates received (%u, need %u)"), Totals.ServerUpdates, MinServerUpdates),
+		         Totals.ServerUpdates >= MinServerUpdates);
+		TestTrue(FString::Printf(TEXT("Input correction rate (%.3f, max %.3f)"), Totals.InputCorrections / Updates, MaxInputCorrectionRate),
+		         Totals.InputCorrections / Updates <= MaxInputCorrectionRate);
+		TestTrue(FString::Printf(TEXT("Position correction rate (%.3f, max %.3f)"), Totals.PositionCorrections / Updates, MaxPositionCorrectionRate),
+		         Totals.PositionCorrections / Updates <= MaxPositionCorrectionRate);
+		TestTrue(FString::Printf(TEXT("Preview corrections (%u, max %.0f)"), Totals.PreviewCorrections, MaxPreviewCorrectionsPerSecond * TestSeconds),
+		         Totals.PreviewCorrections <= MaxPreviewCorrectionsPerSecond * TestSeconds);
+		TestEqual(TEXT("Held inputs dropped"), Totals.DroppedInputs, 0u);
+		GEditor->RequestEndPlayMap();
+		return true;
+	}));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([]() { return GEditor->PlayWorld == nullptr; }));
+	return true;
+}
+
+#endif
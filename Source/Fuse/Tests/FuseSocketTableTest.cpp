@@ -0,0 +1,47 @@
+
+#include "FuseSocketTable.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshSocket.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFuseSocketTypeTest, "Fuse.Sockets.Types",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFuseSocketTypeTest::RunTest(const FString& Parameters)
+{
+	// The names documented in FuseSocketTable.h
+	FFuseSocket Socket;
+	FFuseSocketTable::ParseSocketType(TEXT("Attach_Beam-02"), FString(), TEXT("Attach"), Socket);
+	TestEqual(TEXT("Attach_Beam-02 is a Beam socket"), Socket.TypeBits, FFuseSocketTable::GetTypeBit(TEXT("Beam")));
+	TestEqual(TEXT("Attach_Beam-02 has - polarity"), static_cast<int32>(Socket.Polarity), -1);
+
+	FFuseSocketTable::ParseSocketType(TEXT("Attach_Beam_Pipe+"), FString(), TEXT("Attach"), Socket);
+	TestEqual(TEXT("Attach_Beam_Pipe+ is a Beam and Pipe socket"), Socket.TypeBits,
+	          FFuseSocketTable::GetTypeBit(TEXT("Beam")) | FFuseSocketTable::GetTypeBit(TEXT("Pipe")));
+	TestEqual(TEXT("Attach_Beam_Pipe+ has + polarity"), static_cast<int32>(Socket.Polarity), 1);
+
+	FFuseSocketTable::ParseSocketType(TEXT("Attach_02"), FString(), TEXT("Attach"), Socket);
+	TestEqual(TEXT("A numbered socket is untyped"), Socket.TypeBits, MAX_uint32);
+	TestEqual(TEXT("A numbered socket is neutral"), static_cast<int32>(Socket.Polarity), 0);
+
+	// A rotated socket faces along its X axis, and a socket with no nearest face still gets a direction
+	UStaticMesh* Mesh = NewObject<UStaticMesh>(GetTransientPackage());
+	UStaticMeshSocket* RotatedSocket = NewObject<UStaticMeshSocket>(Mesh);
+	RotatedSocket->SocketName = TEXT("Attach_Rotated");
+	RotatedSocket->RelativeRotation = FRotator(0.0f, 90.0f, 0.0f);
+	Mesh->Sockets.Add(RotatedSocket);
+	UStaticMeshSocket* CentreSocket = NewObject<UStaticMeshSocket>(Mesh);
+	CentreSocket->SocketName = TEXT("Attach_Centre");
+	Mesh->Sockets.Add(CentreSocket);
+
+	TArray<FFuseSocket> Sockets;
+	FFuseSocketTable::BuildSockets(Mesh, TEXT("Attach"), Sockets);
+	if (!TestEqual(TEXT("Both sockets are fusable"), Sockets.Num(), 2)) { return false; }
+	TestTrue(TEXT("A rotated socket faces along its X axis"), Sockets[0].Normal.Equals(FVector::RightVector, KINDA_SMALL_NUMBER));
+	TestTrue(TEXT("A socket in the middle has a normal"), Sockets[1].Normal.IsNormalized());
+	return true;
+}
+
+#endif
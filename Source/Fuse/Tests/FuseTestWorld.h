@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+/*
+ *
+ * Game world for fuse automation tests, created and begun play with the scope and destroyed after it.
+ * Nothing ticks it unless the test does, the fuse benchmarks drive their fusers directly.
+ *
+ */
+
+class FFuseTestWorld
+{
+public:
+	FFuseTestWorld()
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("FuseTestWorld"));
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+	}
+
+	~FFuseTestWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	UWorld* Get() const { return World; }
+
+private:
+	UWorld* World = nullptr;
+};
+
+#endif